@@ -0,0 +1,133 @@
+#include "Animation.h"
+
+// 插值进度使用16位小数定点数 (0..65536)
+#define ANIM_ONE 65536u
+
+AnimationPlayer::AnimationPlayer() {
+    _clip = nullptr;
+    _startMs = 0;
+}
+
+void AnimationPlayer::play(const AnimationClip* clip, uint32_t nowMs) {
+    _clip = (clip != nullptr && clip->count > 0) ? clip : nullptr;
+    _startMs = nowMs;
+}
+
+void AnimationPlayer::stop() {
+    _clip = nullptr;
+}
+
+bool AnimationPlayer::isFinished(uint32_t nowMs) const {
+    return _clip != nullptr && _clip->loop == ANIM_ONCE &&
+           nowMs - _startMs >= _clip->durationMs;
+}
+
+// 把经过的时间折算到片段内的时间
+uint32_t AnimationPlayer::clipTime(uint32_t nowMs) const {
+    uint32_t elapsed = nowMs - _startMs;
+    uint32_t duration = _clip->durationMs;
+    if (duration == 0) return 0;
+
+    switch (_clip->loop) {
+        case ANIM_LOOP:
+            return elapsed % duration;
+        case ANIM_PING_PONG: {
+            uint32_t phase = elapsed % (2 * duration);
+            return phase < duration ? phase : 2 * duration - phase;
+        }
+        case ANIM_ONCE:
+        default:
+            return elapsed < duration ? elapsed : duration;
+    }
+}
+
+// t所在的关键帧段 (返回段起点的关键帧)
+size_t AnimationPlayer::segmentAt(uint32_t t) const {
+    size_t i = 0;
+    while (i + 1 < _clip->count && _clip->keys[i + 1].timeMs <= t) {
+        i++;
+    }
+    return i;
+}
+
+uint32_t AnimationPlayer::ease(AnimEasing easing, uint32_t u) {
+    uint64_t v = u;
+    switch (easing) {
+        case EASE_STEP:
+            return 0;
+        case EASE_IN:
+            return (uint32_t)((v * v) >> 16);
+        case EASE_OUT: {
+            uint64_t r = ANIM_ONE - v;
+            return ANIM_ONE - (uint32_t)((r * r) >> 16);
+        }
+        case EASE_IN_OUT:
+            // smoothstep: u^2 * (3 - 2u)
+            return (uint32_t)((((v * v) >> 16) * (3 * ANIM_ONE - 2 * v)) >> 16);
+        case EASE_LINEAR:
+        default:
+            return u;
+    }
+}
+
+// 逐通道线性插值
+uint32_t AnimationPlayer::lerpColor(uint32_t from, uint32_t to, uint32_t u) {
+    uint32_t result = 0;
+    for (int shift = 0; shift < 24; shift += 8) {
+        int32_t a = (from >> shift) & 0xFF;
+        int32_t b = (to >> shift) & 0xFF;
+        int32_t c = a + (int32_t)(((int64_t)(b - a) * u) >> 16);
+        result |= (uint32_t)c << shift;
+    }
+    return result;
+}
+
+bool AnimationPlayer::sample(uint32_t nowMs, AnimationSample* out) const {
+    if (_clip == nullptr) return false;
+
+    uint32_t t = clipTime(nowMs);
+    size_t i = segmentAt(t);
+    const Keyframe& from = _clip->keys[i];
+
+    // 最后一个关键帧之后保持不变
+    if (i + 1 >= _clip->count || t <= from.timeMs) {
+        out->color = from.color;
+        out->xQ8 = from.x * 256;
+        out->yQ8 = from.y * 256;
+        return true;
+    }
+
+    const Keyframe& to = _clip->keys[i + 1];
+    uint32_t span = to.timeMs - from.timeMs;
+    uint32_t u = ease(from.easing, (uint32_t)(((uint64_t)(t - from.timeMs) << 16) / span));
+
+    out->color = lerpColor(from.color, to.color, u);
+    out->xQ8 = from.x * 256 + (int16_t)(((int32_t)(to.x - from.x) * (int32_t)u) >> 8);
+    out->yQ8 = from.y * 256 + (int16_t)(((int32_t)(to.y - from.y) * (int32_t)u) >> 8);
+    return true;
+}
+
+uint32_t AnimationPlayer::nextChangeMs(uint32_t nowMs) const {
+    if (_clip == nullptr || isFinished(nowMs)) return UINT32_MAX;
+
+    uint32_t t = clipTime(nowMs);
+    size_t i = segmentAt(t);
+    const Keyframe& from = _clip->keys[i];
+
+    // 最后一个关键帧之后保持不变，循环播放时到周期结束回到起点
+    if (i + 1 >= _clip->count) {
+        if (_clip->loop == ANIM_LOOP) {
+            return _clip->durationMs > t ? _clip->durationMs - t : 0;
+        }
+        return _clip->loop == ANIM_ONCE ? UINT32_MAX : ANIM_FRAME_MS;
+    }
+
+    // 插值段需要持续刷新；往返播放时阶跃段的方向不固定，也按帧刷新
+    if (from.easing != EASE_STEP || _clip->loop == ANIM_PING_PONG) {
+        return ANIM_FRAME_MS;
+    }
+
+    // 阶跃段: 到下一关键帧之前画面不变
+    uint32_t next = _clip->keys[i + 1].timeMs;
+    return next > t ? next - t : 0;
+}
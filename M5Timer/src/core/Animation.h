@@ -0,0 +1,77 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 动画帧间隔 (插值动画的刷新周期)
+#define ANIM_FRAME_MS 20
+
+// 关键帧之间的缓动曲线
+enum AnimEasing : uint8_t {
+    EASE_STEP,        // 保持当前关键帧，到下一关键帧时跳变
+    EASE_LINEAR,      // 线性
+    EASE_IN,          // 先慢后快
+    EASE_OUT,         // 先快后慢
+    EASE_IN_OUT       // 两端慢中间快
+};
+
+// 播放方式
+enum AnimLoop : uint8_t {
+    ANIM_ONCE,        // 播放一次后停在最后一帧
+    ANIM_LOOP,        // 循环
+    ANIM_PING_PONG    // 往返
+};
+
+// 关键帧 - easing为从本帧到下一帧使用的曲线
+struct Keyframe {
+    uint16_t timeMs;      // 相对动画开始的时间
+    uint32_t color;       // 0xRRGGBB
+    int8_t x;             // 位置 (像素)
+    int8_t y;
+    AnimEasing easing;
+};
+
+// 动画片段 - 关键帧按时间升序，整张表可以是constexpr，存放在Flash中
+struct AnimationClip {
+    const Keyframe* keys;
+    uint8_t count;
+    uint16_t durationMs;  // 一个周期的长度
+    AnimLoop loop;
+};
+
+// 某一时刻的采样结果
+struct AnimationSample {
+    uint32_t color;
+    int16_t xQ8;          // 位置，8位小数定点数
+    int16_t yQ8;
+};
+
+// 动画播放器
+// 按经过的时间而不是调用次数求值，刷新频率变化不影响动画速度；不分配堆内存。
+class AnimationPlayer {
+public:
+    AnimationPlayer();
+
+    void play(const AnimationClip* clip, uint32_t nowMs);
+    void stop();
+    bool isPlaying() const { return _clip != nullptr; }
+
+    // 计算nowMs时刻的状态，没有播放时返回false；单次动画结束后停在最后一帧
+    bool sample(uint32_t nowMs, AnimationSample* out) const;
+
+    // 单次动画是否已播放完毕
+    bool isFinished(uint32_t nowMs) const;
+
+    // 距离画面下一次可能变化的时间 (毫秒)
+    // 阶跃段返回到下一关键帧的时间，插值段返回ANIM_FRAME_MS
+    uint32_t nextChangeMs(uint32_t nowMs) const;
+
+private:
+    uint32_t clipTime(uint32_t nowMs) const;
+    size_t segmentAt(uint32_t t) const;
+    static uint32_t ease(AnimEasing easing, uint32_t u);
+    static uint32_t lerpColor(uint32_t from, uint32_t to, uint32_t u);
+
+    const AnimationClip* _clip;
+    uint32_t _startMs;
+};
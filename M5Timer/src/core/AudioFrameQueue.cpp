@@ -0,0 +1,47 @@
+#include "AudioFrameQueue.h"
+
+AudioFrameQueue::AudioFrameQueue() {
+    _head = 0;
+    _tail = 0;
+    _dropped = 0;
+}
+
+int16_t* AudioFrameQueue::beginWrite() {
+    size_t head = _head;
+    size_t tail = __atomic_load_n(&_tail, __ATOMIC_ACQUIRE);
+    if (head - tail >= AUDIO_QUEUE_FRAMES) {
+        __atomic_store_n(&_dropped, _dropped + 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+    return _frames[head & (AUDIO_QUEUE_FRAMES - 1)];
+}
+
+void AudioFrameQueue::commitWrite() {
+    // 帧数据写完后再发布新的写入位置
+    __atomic_store_n(&_head, _head + 1, __ATOMIC_RELEASE);
+}
+
+void AudioFrameQueue::abortWrite() {
+    // 写入位置不变，下次beginWrite()重新使用这一帧
+    __atomic_store_n(&_dropped, _dropped + 1, __ATOMIC_RELAXED);
+}
+
+const int16_t* AudioFrameQueue::peek() const {
+    size_t tail = _tail;
+    size_t head = __atomic_load_n(&_head, __ATOMIC_ACQUIRE);
+    if (head == tail) return NULL;
+    return _frames[tail & (AUDIO_QUEUE_FRAMES - 1)];
+}
+
+void AudioFrameQueue::pop() {
+    // 帧处理完后再释放空间
+    __atomic_store_n(&_tail, _tail + 1, __ATOMIC_RELEASE);
+}
+
+size_t AudioFrameQueue::available() const {
+    return __atomic_load_n(&_head, __ATOMIC_ACQUIRE) - __atomic_load_n(&_tail, __ATOMIC_ACQUIRE);
+}
+
+void AudioFrameQueue::clear() {
+    __atomic_store_n(&_tail, __atomic_load_n(&_head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+}
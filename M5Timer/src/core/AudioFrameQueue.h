@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// 每帧采样数与队列容量 (帧数，必须是2的幂)
+#define AUDIO_FRAME_SAMPLES   256
+#define AUDIO_FRAME_BYTES     (AUDIO_FRAME_SAMPLES * sizeof(int16_t))
+#define AUDIO_QUEUE_FRAMES    16
+
+// 单生产者单消费者音频帧队列
+// 生产者 (采集任务) 直接把I2S数据读进空闲帧再提交，消费者 (模式任务) 原地处理后释放，
+// 全程不拷贝采样、不加锁、不分配堆内存。队列满或帧没有读满时生产者丢弃该帧并计数。
+class AudioFrameQueue {
+public:
+    AudioFrameQueue();
+
+    // 生产者: 取得下一个可写入的帧，队列满时返回NULL并计入丢弃
+    int16_t* beginWrite();
+
+    // 生产者: 提交beginWrite()取得的帧
+    void commitWrite();
+
+    // 生产者: 放弃beginWrite()取得的帧 (没有读满一帧)，计入丢弃
+    void abortWrite();
+
+    // 消费者: 取得最早的未处理帧，队列空时返回NULL
+    const int16_t* peek() const;
+
+    // 消费者: 释放peek()取得的帧
+    void pop();
+
+    // 未处理的帧数
+    size_t available() const;
+
+    // 累计丢弃的帧数 (队列满或放弃写入，只增不减，按会话统计时取差值)
+    uint32_t dropped() const { return __atomic_load_n(&_dropped, __ATOMIC_RELAXED); }
+
+    // 消费者: 丢弃所有未处理的帧
+    void clear();
+
+private:
+    int16_t _frames[AUDIO_QUEUE_FRAMES][AUDIO_FRAME_SAMPLES];
+    size_t _head;       // 下一个写入的帧 (只由生产者修改)
+    size_t _tail;       // 下一个读取的帧 (只由消费者修改)
+    uint32_t _dropped;
+};
@@ -0,0 +1,211 @@
+#include "BeatDetector.h"
+#include <string.h>
+
+// 自适应阈值 = 近期谱通量均值 + 4倍平均绝对偏差 + 下限 (Q8，1个log2单位)
+#define BEAT_THRESHOLD_DEV    4
+#define BEAT_FLUX_FLOOR_Q8    256
+
+// 两次起音的最小间隔 (毫秒)
+#define BEAT_MIN_ONSET_MS     100
+
+// 周期直方图: 每次起音先衰减到7/8，再按起音间隔投票 (越早的起音权重越低)
+#define BEAT_VOTE_WEIGHT      256
+#define BEAT_DECAY_NUM        7
+#define BEAT_DECAY_DEN        8
+
+// 确定速度需要的起音数与直方图峰值 (平滑后，相当于两次一致的间隔)，
+// 以及连续多少个周期没有与节拍相符的起音后认为速度丢失
+#define BEAT_MIN_ONSETS       4
+#define BEAT_MIN_SCORE        (4 * BEAT_VOTE_WEIGHT)
+#define BEAT_LOST_PERIODS     4
+
+// 起音距离预测节拍在周期的1/8以内时校正相位，每次只校正一半的偏差 (单个噪声起音不会把节拍拉偏太多)
+#define BEAT_PHASE_WINDOW_DIV 8
+#define BEAT_PHASE_GAIN_SHIFT 1
+
+// 起音强度: 谱通量不低于近期起音平均值一半的起音才参与速度统计与相位校正 (背景噪声的起音较弱)。
+// 平均值按较强的起音每次更新1/4，每个较弱的起音衰减1/16，音乐变轻后能重新跟上
+#define BEAT_STRONG_DIV       2
+#define BEAT_FLUX_AVG_SHIFT   2
+#define BEAT_FLUX_DECAY_SHIFT 4
+
+BeatDetector::BeatDetector(uint32_t sampleRate, uint32_t frameSamples) {
+    _framesPerMinute = sampleRate * 60 / frameSamples;
+    _minPeriod = (int)(_framesPerMinute / BEAT_MAX_BPM);
+    _maxPeriod = (int)(_framesPerMinute / BEAT_MIN_BPM);
+    if (_minPeriod < 2) _minPeriod = 2;
+    if (_maxPeriod > BEAT_MAX_PERIOD - 1) _maxPeriod = BEAT_MAX_PERIOD - 1;
+    reset();
+}
+
+void BeatDetector::reset() {
+    memset(_previous, 0, sizeof(_previous));
+    _hasPrevious = false;
+    memset(_history, 0, sizeof(_history));
+    _historySum = 0;
+    _historyIndex = 0;
+    _lastFlux = 0;
+    _lastThreshold = 0;
+
+    _frame = 0;
+    memset(_onsets, 0, sizeof(_onsets));
+    _onsetCount = 0;
+    _lastOnset = 0;
+    _lastAlignedOnset = 0;
+    _lastStrongOnset = 0;
+    _lastOnsetStrong = false;
+    _onsetFlux = 0;
+
+    memset(_histogram, 0, sizeof(_histogram));
+    _periodQ8 = 0;
+    _tempoValid = false;
+
+    _nextBeatQ8 = 0;
+    _lastBeatQ8 = 0;
+}
+
+uint16_t BeatDetector::bpm() const {
+    if (!_tempoValid || _periodQ8 == 0) return 0;
+    return (uint16_t)(((uint64_t)_framesPerMinute * 256 + _periodQ8 / 2) / _periodQ8);
+}
+
+uint8_t BeatDetector::process(const int32_t* bandQ8, int bandCount) {
+    if (bandCount > BEAT_MAX_BANDS) bandCount = BEAT_MAX_BANDS;
+    uint32_t frame = _frame++;
+    uint8_t flags = 0;
+
+    // 谱通量: 只累计能量上升的频段
+    int32_t flux = 0;
+    if (_hasPrevious) {
+        for (int b = 0; b < bandCount; b++) {
+            int32_t rise = bandQ8[b] - _previous[b];
+            if (rise > 0) flux += rise;
+        }
+    }
+    memcpy(_previous, bandQ8, bandCount * sizeof(int32_t));
+    _hasPrevious = true;
+
+    // 阈值只使用之前的历史，当前帧随后才加入
+    int32_t mean = _historySum / BEAT_HISTORY_FRAMES;
+    int32_t deviation = 0;
+    for (int i = 0; i < BEAT_HISTORY_FRAMES; i++) {
+        int32_t d = _history[i] - mean;
+        deviation += d < 0 ? -d : d;
+    }
+    deviation /= BEAT_HISTORY_FRAMES;
+    int32_t threshold = mean + BEAT_THRESHOLD_DEV * deviation + BEAT_FLUX_FLOOR_Q8;
+    _historySum += flux - _history[_historyIndex];
+    _history[_historyIndex] = flux;
+    _historyIndex = (_historyIndex + 1) % BEAT_HISTORY_FRAMES;
+    _lastFlux = flux;
+    _lastThreshold = threshold;
+
+    // 起音
+    uint32_t minGap = _framesPerMinute * BEAT_MIN_ONSET_MS / 60000;
+    bool warmedUp = frame >= BEAT_HISTORY_FRAMES;
+    bool strong = _onsetFlux == 0 || flux * BEAT_STRONG_DIV >= _onsetFlux;
+    bool gapElapsed = _lastOnset == 0 || frame - _lastOnset >= minGap;
+    // 敲击声跨两帧时前一帧可能只是较弱的起音，紧跟的较强起音不受最小间隔限制
+    bool onset = warmedUp && flux > threshold && (gapElapsed || (strong && !_lastOnsetStrong));
+    if (onset) {
+        flags |= BEAT_FLAG_ONSET;
+        _lastOnset = frame;
+        _lastOnsetStrong = strong;
+        if (strong) {
+            _onsetFlux = _onsetFlux == 0 ? flux : _onsetFlux + ((flux - _onsetFlux) >> BEAT_FLUX_AVG_SHIFT);
+            updateTempo(frame);
+        } else {
+            _onsetFlux -= _onsetFlux >> BEAT_FLUX_DECAY_SHIFT;
+        }
+    }
+    if (!_tempoValid) return flags;
+
+    int64_t nowQ8 = (int64_t)frame << 8;
+    int64_t window = _periodQ8 / BEAT_PHASE_WINDOW_DIV;
+    int64_t keepQ8 = 0;     // 立即输出节拍时，下一拍保留的未校正偏差
+    if (onset && strong) {
+        int64_t sinceLast = nowQ8 - _lastBeatQ8;
+        int64_t untilNext = _nextBeatQ8 - nowQ8;
+        int64_t interval = ((int64_t)(frame - _lastStrongOnset) << 8) - _periodQ8;
+        if (sinceLast >= 0 && sinceLast <= window) {
+            // 起音稍晚于刚输出的节拍: 只校正相位
+            _nextBeatQ8 = _lastBeatQ8 + _periodQ8 + (sinceLast >> BEAT_PHASE_GAIN_SHIFT);
+            _lastAlignedOnset = frame;
+        } else if (untilNext <= window) {
+            // 起音稍早于预测 (或速度刚确定): 立即输出节拍
+            _nextBeatQ8 = nowQ8;
+            keepQ8 = untilNext - (untilNext >> BEAT_PHASE_GAIN_SHIFT);
+            _lastAlignedOnset = frame;
+        } else if (((int64_t)(frame - _lastAlignedOnset) << 8) > _periodQ8 &&
+                   interval >= -window && interval <= window) {
+            // 一个周期内没有相符的起音，而最近两次较强的起音正好相隔一个周期: 相位锁错了，按起音重新对齐
+            _nextBeatQ8 = nowQ8;
+            _lastAlignedOnset = frame;
+        }
+        _lastStrongOnset = frame;
+    }
+
+    // 长时间没有与节拍相符的起音 (只剩噪声或速度已变)，停止输出节拍
+    if (frame - _lastAlignedOnset > (BEAT_LOST_PERIODS * _periodQ8 >> 8)) {
+        _tempoValid = false;
+        return flags;
+    }
+
+    if (nowQ8 >= _nextBeatQ8) {
+        flags |= BEAT_FLAG_BEAT;
+        _lastBeatQ8 = nowQ8;
+        _nextBeatQ8 += _periodQ8 + keepQ8;
+        if (_nextBeatQ8 <= nowQ8) {
+            _nextBeatQ8 = nowQ8 + _periodQ8;
+        }
+    }
+    return flags;
+}
+
+// 起音间隔投票并找出直方图峰值
+void BeatDetector::updateTempo(uint32_t frame) {
+    for (int i = _minPeriod - 1; i <= _maxPeriod + 1; i++) {
+        _histogram[i] = (uint16_t)(_histogram[i] * BEAT_DECAY_NUM / BEAT_DECAY_DEN);
+    }
+
+    // 与最近几次起音的间隔，第n近的起音权重为1/n
+    int known = _onsetCount < BEAT_ONSET_RING ? _onsetCount : BEAT_ONSET_RING;
+    for (int n = 1; n <= known; n++) {
+        uint32_t previous = _onsets[(_onsetCount - n) % BEAT_ONSET_RING];
+        uint32_t interval = frame - previous;
+        if (interval < (uint32_t)_minPeriod || interval > (uint32_t)_maxPeriod) continue;
+        uint32_t vote = _histogram[interval] + BEAT_VOTE_WEIGHT / n;
+        _histogram[interval] = (uint16_t)(vote > 0xFFFF ? 0xFFFF : vote);
+    }
+    _onsets[_onsetCount % BEAT_ONSET_RING] = frame;
+    _onsetCount++;
+
+    if (_onsetCount < BEAT_MIN_ONSETS) return;
+
+    // 相邻三个周期平滑后的峰值
+    int best = 0;
+    uint32_t bestScore = 0;
+    for (int i = _minPeriod; i <= _maxPeriod; i++) {
+        uint32_t score = _histogram[i - 1] + 2 * _histogram[i] + _histogram[i + 1];
+        if (score > bestScore) {
+            bestScore = score;
+            best = i;
+        }
+    }
+    if (bestScore < BEAT_MIN_SCORE) return;
+
+    // 峰值附近的加权平均给出小数周期
+    uint32_t weight = _histogram[best - 1] + _histogram[best] + _histogram[best + 1];
+    uint64_t moment = (uint64_t)(best - 1) * _histogram[best - 1] + (uint64_t)best * _histogram[best] +
+                      (uint64_t)(best + 1) * _histogram[best + 1];
+    uint32_t periodQ8 = (uint32_t)(moment * 256 / weight);
+
+    if (!_tempoValid) {
+        // 速度刚确定: 当前起音就是一拍
+        _tempoValid = true;
+        _lastBeatQ8 = -((int64_t)periodQ8);
+        _nextBeatQ8 = (int64_t)frame << 8;
+        _lastAlignedOnset = frame;
+    }
+    _periodQ8 = periodQ8;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stdint.h>
+
+// 节拍检测的频段数上限
+#define BEAT_MAX_BANDS        8
+
+// 自适应阈值使用的谱通量历史长度 (帧)
+#define BEAT_HISTORY_FRAMES   64
+
+// 可识别的速度范围
+#define BEAT_MIN_BPM          60
+#define BEAT_MAX_BPM          180
+
+// 速度统计使用的起音环形缓冲区长度与周期直方图长度 (帧)
+#define BEAT_ONSET_RING       4
+#define BEAT_MAX_PERIOD       256
+
+// process()的返回标志
+#define BEAT_FLAG_ONSET       0x01  // 本帧检测到起音
+#define BEAT_FLAG_BEAT        0x02  // 本帧是一拍
+
+// 起音与节拍检测
+// 每个分析帧输入各频段的对数能量 (log2, Q8):
+// - 谱通量 = 各频段能量上升量之和，超过近期均值的自适应阈值即为起音；
+// - 明显弱于近期起音的起音 (如背景噪声) 只输出标志，不参与速度统计与相位校正；
+// - 起音间隔按帧数累计到衰减的周期直方图，峰值给出速度；
+// - 按速度预测下一拍，起音落在预测附近时校正相位，没有起音时按预测继续输出节拍；
+//   起音持续偏离预测但彼此相隔一个周期时重新对齐相位，长时间没有相符的起音则停止输出。
+// 全部使用整数运算和固定大小的数组，时间以帧为单位，不依赖Arduino，便于在主机上测试。
+class BeatDetector {
+public:
+    // sampleRate / frameSamples: 每秒分析的帧数
+    BeatDetector(uint32_t sampleRate, uint32_t frameSamples);
+
+    void reset();
+
+    // 处理一帧，返回BEAT_FLAG_*标志
+    uint8_t process(const int32_t* bandQ8, int bandCount);
+
+    // 当前速度 (每分钟拍数)，速度未确定时返回0
+    uint16_t bpm() const;
+
+    // 节拍周期 (帧, Q8)，速度未确定时返回0
+    uint32_t periodQ8() const { return _tempoValid ? _periodQ8 : 0; }
+
+    // 最近一帧的谱通量与阈值 (Q8)
+    int32_t flux() const { return _lastFlux; }
+    int32_t threshold() const { return _lastThreshold; }
+
+private:
+    void updateTempo(uint32_t frame);
+
+    uint32_t _framesPerMinute;
+    int _minPeriod;
+    int _maxPeriod;
+
+    // 谱通量
+    int32_t _previous[BEAT_MAX_BANDS];
+    bool _hasPrevious;
+    int32_t _history[BEAT_HISTORY_FRAMES];
+    int32_t _historySum;
+    int _historyIndex;
+    int32_t _lastFlux;
+    int32_t _lastThreshold;
+
+    // 起音
+    uint32_t _frame;
+    uint32_t _onsets[BEAT_ONSET_RING];
+    int _onsetCount;
+    uint32_t _lastOnset;
+    uint32_t _lastAlignedOnset;     // 最近一次与节拍相符 (或用于重新对齐相位) 的起音
+    uint32_t _lastStrongOnset;      // 最近一次较强的起音
+    bool _lastOnsetStrong;          // 最近一次起音是否较强
+    int32_t _onsetFlux;             // 较强起音的平均谱通量 (Q8)，0表示还没有起音
+
+    // 速度
+    uint16_t _histogram[BEAT_MAX_PERIOD + 1];
+    uint32_t _periodQ8;
+    bool _tempoValid;
+
+    // 节拍相位
+    int64_t _nextBeatQ8;
+    int64_t _lastBeatQ8;
+};
@@ -0,0 +1,96 @@
+#include "ButtonDebouncer.h"
+
+ButtonDebouncer::ButtonDebouncer(uint32_t lockoutUs, uint32_t longPressUs) {
+    _lockoutUs = lockoutUs;
+    _longPressUs = longPressUs;
+    reset();
+}
+
+void ButtonDebouncer::reset() {
+    _pressed = false;
+    _longFired = false;
+    _locked = false;
+    _lockStartUs = 0;
+    _pressTimeUs = 0;
+    _rawPressed = false;
+    _rawTimeUs = 0;
+    _eventTimeUs = 0;
+}
+
+bool ButtonDebouncer::isLocked(uint32_t nowUs) const {
+    return _locked && (uint32_t)(nowUs - _lockStartUs) < _lockoutUs;
+}
+
+// 输入一个边沿 - 锁定期内只记录电平，锁定期外立即生效
+ButtonAction ButtonDebouncer::onEdge(bool pressed, uint32_t timeUs) {
+    if (pressed != _rawPressed) {
+        _rawPressed = pressed;
+        _rawTimeUs = timeUs;
+    }
+    if (isLocked(timeUs)) return BUTTON_ACTION_NONE;
+
+    _locked = false;
+    return apply(pressed, timeUs);
+}
+
+ButtonAction ButtonDebouncer::poll(uint32_t nowUs, bool rawPressed) {
+    if (rawPressed != _rawPressed) {
+        _rawPressed = rawPressed;
+        _rawTimeUs = nowUs;
+    }
+
+    // 锁定结束: 与实际电平对齐 (锁定期内的最后一个边沿可能被忽略)
+    if (_locked && !isLocked(nowUs)) {
+        _locked = false;
+        if (_rawPressed != _pressed) {
+            return apply(_rawPressed, _rawTimeUs);
+        }
+    }
+
+    // 按住达到阈值立即触发长按，无需等待松开
+    if (_pressed && !_longFired && (uint32_t)(nowUs - _pressTimeUs) >= _longPressUs) {
+        _longFired = true;
+        _eventTimeUs = _pressTimeUs + _longPressUs;
+        return BUTTON_ACTION_LONG;
+    }
+    return BUTTON_ACTION_NONE;
+}
+
+// 改变消抖后的状态并开始锁定
+ButtonAction ButtonDebouncer::apply(bool pressed, uint32_t timeUs) {
+    if (pressed == _pressed) return BUTTON_ACTION_NONE;
+
+    _pressed = pressed;
+    _locked = true;
+    _lockStartUs = timeUs;
+    _eventTimeUs = timeUs;
+
+    if (pressed) {
+        _pressTimeUs = timeUs;
+        _longFired = false;
+        return BUTTON_ACTION_PRESS;
+    }
+
+    if (_longFired) return BUTTON_ACTION_RELEASE;
+
+    // 错过了长按时刻 (例如任务被长时间阻塞)，按住时长仍达到阈值时按长按处理
+    if ((uint32_t)(timeUs - _pressTimeUs) >= _longPressUs) {
+        _longFired = true;
+        return BUTTON_ACTION_LONG;
+    }
+    return BUTTON_ACTION_SHORT;
+}
+
+uint32_t ButtonDebouncer::nextDeadlineUs(uint32_t nowUs) const {
+    uint32_t deadline = BUTTON_NO_DEADLINE;
+    if (_locked) {
+        uint32_t elapsed = nowUs - _lockStartUs;
+        deadline = elapsed >= _lockoutUs ? 0 : _lockoutUs - elapsed;
+    }
+    if (_pressed && !_longFired) {
+        uint32_t elapsed = nowUs - _pressTimeUs;
+        uint32_t untilLong = elapsed >= _longPressUs ? 0 : _longPressUs - elapsed;
+        if (untilLong < deadline) deadline = untilLong;
+    }
+    return deadline;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdint.h>
+
+// 按键消抖参数 (单位: 微秒)
+#define BUTTON_LOCKOUT_US     20000     // 接受一次边沿后忽略后续抖动的时间
+#define BUTTON_LONG_PRESS_US  1000000   // 长按阈值
+
+// 没有待处理的截止时间
+#define BUTTON_NO_DEADLINE    0xFFFFFFFF
+
+// 消抖状态机输出的按键动作
+enum ButtonAction {
+    BUTTON_ACTION_NONE,     // 无动作
+    BUTTON_ACTION_PRESS,    // 按下
+    BUTTON_ACTION_SHORT,    // 短按后松开
+    BUTTON_ACTION_LONG,     // 按住达到长按阈值
+    BUTTON_ACTION_RELEASE   // 长按后松开
+};
+
+// 按键消抖状态机
+// 采用前沿锁定: 第一个边沿立即生效，随后锁定一段时间忽略抖动，
+// 锁定结束时再与实际电平对齐。不依赖任何硬件，时间戳由调用方提供 (允许回绕)。
+class ButtonDebouncer {
+public:
+    ButtonDebouncer(uint32_t lockoutUs = BUTTON_LOCKOUT_US, uint32_t longPressUs = BUTTON_LONG_PRESS_US);
+
+    // 恢复到松开状态
+    void reset();
+
+    // 输入一个边沿 (中断中采样的电平与时间戳)
+    ButtonAction onEdge(bool pressed, uint32_t timeUs);
+
+    // 处理锁定结束与长按，rawPressed为当前实际电平
+    // 每次调用最多返回一个动作，应循环调用直到返回BUTTON_ACTION_NONE
+    ButtonAction poll(uint32_t nowUs, bool rawPressed);
+
+    // 距离下一次需要调用poll的时间，没有时返回BUTTON_NO_DEADLINE
+    uint32_t nextDeadlineUs(uint32_t nowUs) const;
+
+    bool isPressed() const { return _pressed; }
+
+    // 最近一次动作对应的时刻
+    uint32_t eventTimeUs() const { return _eventTimeUs; }
+
+private:
+    ButtonAction apply(bool pressed, uint32_t timeUs);
+    bool isLocked(uint32_t nowUs) const;
+
+    uint32_t _lockoutUs;
+    uint32_t _longPressUs;
+
+    bool _pressed;           // 消抖后的状态
+    bool _longFired;         // 本次按下是否已触发长按
+    bool _locked;            // 是否处于锁定期
+    uint32_t _lockStartUs;   // 锁定开始时刻
+    uint32_t _pressTimeUs;   // 按下时刻
+    bool _rawPressed;        // 最近一次观察到的电平
+    uint32_t _rawTimeUs;     // 最近一次观察到电平变化的时刻
+    uint32_t _eventTimeUs;   // 最近一次动作的时刻
+};
@@ -0,0 +1,46 @@
+#include "ByteRing.h"
+
+ByteRing::ByteRing() {
+    _head = 0;
+    _tail = 0;
+    _dropped = 0;
+}
+
+size_t ByteRing::write(const uint8_t* data, size_t length) {
+    size_t head = _head;
+    size_t tail = __atomic_load_n(&_tail, __ATOMIC_ACQUIRE);
+    size_t space = BYTE_RING_SIZE - (head - tail);
+
+    size_t count = length < space ? length : space;
+    for (size_t i = 0; i < count; i++) {
+        _buffer[(head + i) & (BYTE_RING_SIZE - 1)] = data[i];
+    }
+    _dropped += length - count;
+
+    // 数据写完后再发布新的写入位置
+    __atomic_store_n(&_head, head + count, __ATOMIC_RELEASE);
+    return count;
+}
+
+size_t ByteRing::read(uint8_t* data, size_t maxLength) {
+    size_t tail = _tail;
+    size_t head = __atomic_load_n(&_head, __ATOMIC_ACQUIRE);
+    size_t used = head - tail;
+
+    size_t count = maxLength < used ? maxLength : used;
+    for (size_t i = 0; i < count; i++) {
+        data[i] = _buffer[(tail + i) & (BYTE_RING_SIZE - 1)];
+    }
+
+    // 数据读完后再释放空间
+    __atomic_store_n(&_tail, tail + count, __ATOMIC_RELEASE);
+    return count;
+}
+
+size_t ByteRing::available() const {
+    return __atomic_load_n(&_head, __ATOMIC_ACQUIRE) - __atomic_load_n(&_tail, __ATOMIC_ACQUIRE);
+}
+
+void ByteRing::clear() {
+    __atomic_store_n(&_tail, __atomic_load_n(&_head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+}
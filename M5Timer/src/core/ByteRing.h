@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// 环形缓冲区容量 (必须是2的幂)
+#define BYTE_RING_SIZE 1024
+
+// 单生产者单消费者字节环形缓冲区
+// 生产者 (串口接收回调) 与消费者 (模式任务) 各自只修改自己的索引，无需加锁，不分配堆内存。
+class ByteRing {
+public:
+    ByteRing();
+
+    // 生产者: 写入数据，空间不足时丢弃多余部分，返回实际写入的字节数
+    size_t write(const uint8_t* data, size_t length);
+
+    // 消费者: 读取最多maxLength字节，返回实际读取的字节数
+    size_t read(uint8_t* data, size_t maxLength);
+
+    // 可读取的字节数
+    size_t available() const;
+
+    // 因缓冲区满被丢弃的字节数
+    uint32_t dropped() const { return _dropped; }
+
+    // 消费者: 丢弃所有未读数据
+    void clear();
+
+private:
+    uint8_t _buffer[BYTE_RING_SIZE];
+    size_t _head;       // 下一个写入位置 (只由生产者修改)
+    size_t _tail;       // 下一个读取位置 (只由消费者修改)
+    uint32_t _dropped;
+};
@@ -0,0 +1,21 @@
+#include "ColorLut.h"
+#include <math.h>
+
+ColorLut::ColorLut(float gamma, uint8_t brightness) {
+    for (int i = 0; i < 256; i++) {
+        _gamma[i] = (uint8_t)(powf(i / 255.0f, gamma) * 255.0f + 0.5f);
+    }
+    _active = _tables[1];
+    setBrightness(brightness);
+}
+
+void ColorLut::setBrightness(uint8_t brightness) {
+    // 在当前未使用的表中重建，完成后再切换
+    uint8_t* spare = (_active == _tables[0]) ? _tables[1] : _tables[0];
+    uint16_t scale = brightness + 1;
+    for (int i = 0; i < 256; i++) {
+        spare[i] = (_gamma[i] * scale) >> 8;
+    }
+    _brightness = brightness;
+    _active = spare;
+}
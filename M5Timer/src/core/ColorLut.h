@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+
+// LED伽马值 (与人眼亮度感知匹配)
+#define LED_GAMMA 2.2f
+
+// 伽马 x 亮度查找表
+// 画面始终以原始精度保存，只在编码输出时逐通道查表。
+// 改变亮度时在备用表中重建256项后切换指针，不需要重新缩放任何像素。
+class ColorLut {
+public:
+    ColorLut(float gamma = LED_GAMMA, uint8_t brightness = 255);
+
+    // 设置亮度 (0-255)
+    void setBrightness(uint8_t brightness);
+    uint8_t brightness() const { return _brightness; }
+
+    // 当前查找表 (输入0-255的通道值，输出编码值)
+    const uint8_t* table() const { return _active; }
+
+private:
+    uint8_t _gamma[256];        // 伽马校正表 (只在构造时计算)
+    uint8_t _tables[2][256];    // 伽马 x 亮度表，交替使用
+    const uint8_t* volatile _active;
+    uint8_t _brightness;
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdint.h>
+
+// 定时器到期回调
+typedef void (*CueClockCallback)(void* arg);
+
+// 提示调度器使用的时钟与单次定时器
+// 设备上由EspCueClock (esp_timer) 实现，主机测试中由虚拟时钟实现，
+// 调度逻辑因此不依赖Arduino，可以按虚拟时间推进验证每个提示的触发时刻。
+class CueClock {
+public:
+    virtual ~CueClock() {}
+
+    // 绑定到期回调，只调用一次，失败返回false
+    virtual bool attach(CueClockCallback callback, void* arg) = 0;
+
+    // 当前时刻 (微秒，单调递增)
+    virtual int64_t nowUs() = 0;
+
+    // delayUs后调用一次回调，取代之前布置的唤醒
+    virtual void startOnce(uint64_t delayUs) = 0;
+
+    // 取消已布置的唤醒
+    virtual void stop() = 0;
+
+    // 回调与模式任务并发访问调度状态时使用的临界区
+    virtual void lock() = 0;
+    virtual void unlock() = 0;
+};
@@ -0,0 +1,158 @@
+#include "CueScheduler.h"
+
+CueScheduler::CueScheduler(CueClock& clock) : _clock(clock) {
+    _cues = NULL;
+    _count = 0;
+    _latencyUs = 0;
+    _audioHandler = NULL;
+    _anchorUs = 0;
+    _nextAudio = 0;
+    _nextLed = 0;
+    _armed = false;
+    _pendingAction = CUE_LED_NONE;
+    _pendingDurationMs = 0;
+    _attached = false;
+}
+
+CueScheduler::~CueScheduler() {
+    _clock.stop();
+}
+
+void CueScheduler::setTable(const Cue* cues, size_t count) {
+    disarm();
+    _cues = cues;
+    _count = count < CUE_MAX ? count : CUE_MAX;
+}
+
+void CueScheduler::setAudioLatencyUs(uint32_t latencyUs) {
+    _latencyUs = latencyUs;
+}
+
+void CueScheduler::setAudioHandler(CueAudioHandler handler) {
+    _audioHandler = handler;
+}
+
+int64_t CueScheduler::audioFireTimeUs(size_t index) const {
+    return _anchorUs + (int64_t)_cues[index].offsetMs * 1000 - _latencyUs;
+}
+
+int64_t CueScheduler::ledFireTimeUs(size_t index) const {
+    return _anchorUs + (int64_t)_cues[index].offsetMs * 1000;
+}
+
+// 从头布置提示
+void CueScheduler::arm(int64_t anchorUs) {
+    start(anchorUs, true);
+}
+
+// 暂停后继续 - 暂停期间时间冻结，游标之前的提示都已触发过
+void CueScheduler::resume(int64_t anchorUs) {
+    start(anchorUs, false);
+}
+
+void CueScheduler::start(int64_t anchorUs, bool resetCursors) {
+    // 第一次使用时才绑定回调 (设备上此时esp_timer已初始化)
+    if (!_attached) {
+        _attached = _clock.attach(onTimer, this);
+        if (!_attached) return;
+    }
+
+    _clock.stop();
+
+    _clock.lock();
+    _anchorUs = anchorUs;
+    if (resetCursors) {
+        _nextAudio = 0;
+        _nextLed = 0;
+        _pendingAction = CUE_LED_NONE;
+    }
+    _armed = true;
+    _clock.unlock();
+
+    // 立即处理当前时刻到期的提示并布置下一次唤醒
+    int64_t nowUs = _clock.nowUs();
+    schedule(process(nowUs), nowUs);
+}
+
+// 取消所有未触发的提示
+void CueScheduler::disarm() {
+    _clock.lock();
+    _armed = false;
+    _pendingAction = CUE_LED_NONE;
+    _clock.unlock();
+
+    _clock.stop();
+}
+
+// 取出挂起的LED动作
+bool CueScheduler::takeLedAction(CueLedAction* action, uint16_t* durationMs) {
+    bool taken = false;
+    _clock.lock();
+    if (_pendingAction != CUE_LED_NONE) {
+        *action = _pendingAction;
+        *durationMs = _pendingDurationMs;
+        _pendingAction = CUE_LED_NONE;
+        taken = true;
+    }
+    _clock.unlock();
+    return taken;
+}
+
+// 触发所有到期的提示
+int64_t CueScheduler::process(int64_t nowUs) {
+    uint16_t tracks[CUE_MAX];
+    size_t trackCount = 0;
+    int64_t nextUs = -1;
+
+    _clock.lock();
+    if (_armed) {
+        // 音频: 提前延迟时间发出
+        while (_nextAudio < _count && audioFireTimeUs(_nextAudio) <= nowUs) {
+            if (_cues[_nextAudio].track != 0) {
+                tracks[trackCount++] = _cues[_nextAudio].track;
+            }
+            _nextAudio++;
+        }
+
+        // LED动作: 在目标时刻挂起，后到的动作覆盖先到的
+        while (_nextLed < _count && ledFireTimeUs(_nextLed) <= nowUs) {
+            if (_cues[_nextLed].ledAction != CUE_LED_NONE) {
+                _pendingAction = _cues[_nextLed].ledAction;
+                _pendingDurationMs = _cues[_nextLed].durationMs;
+            }
+            _nextLed++;
+        }
+
+        if (_nextAudio < _count) {
+            nextUs = audioFireTimeUs(_nextAudio);
+        }
+        if (_nextLed < _count && (nextUs < 0 || ledFireTimeUs(_nextLed) < nextUs)) {
+            nextUs = ledFireTimeUs(_nextLed);
+        }
+    }
+    _clock.unlock();
+
+    // 回调可能阻塞或打印日志，在临界区外调用
+    if (_audioHandler != NULL) {
+        for (size_t i = 0; i < trackCount; i++) {
+            _audioHandler(tracks[i]);
+        }
+    }
+    return nextUs;
+}
+
+// 布置下一次定时器唤醒
+void CueScheduler::schedule(int64_t nextUs, int64_t nowUs) {
+    if (nextUs < 0 || !_attached || !_armed) return;
+
+    int64_t delayUs = nextUs - nowUs;
+    if (delayUs < 1) delayUs = 1;
+    _clock.startOnce((uint64_t)delayUs);
+}
+
+// 定时器回调
+void CueScheduler::onTimer(void* arg) {
+    CueScheduler* scheduler = (CueScheduler*)arg;
+    int64_t nowUs = scheduler->_clock.nowUs();
+    scheduler->schedule(scheduler->process(nowUs), nowUs);
+}
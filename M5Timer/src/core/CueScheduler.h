@@ -0,0 +1,88 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "CueClock.h"
+
+// 提示表最大条目数
+#define CUE_MAX 16
+
+// LED亮度动作
+enum CueLedAction {
+    CUE_LED_NONE,      // 不改变亮度
+    CUE_LED_DIM,       // 降低亮度，持续durationMs后恢复
+    CUE_LED_RESTORE    // 恢复原始亮度
+};
+
+// 单个提示: 相对计时开始的时间点 + 音频 + LED动作
+struct Cue {
+    uint32_t offsetMs;        // 相对计时开始的时间 (毫秒)
+    uint16_t track;           // 音频曲目 (0 = 不播放)
+    CueLedAction ledAction;   // LED亮度动作
+    uint16_t durationMs;      // LED动作持续时间 (毫秒)
+};
+
+// 音频提示回调 (在时钟的定时器回调中调用，必须立即返回: 不输出日志、不分配内存、不阻塞)
+typedef void (*CueAudioHandler)(uint16_t track);
+
+// 提示调度器
+// 计时开始时按提示表布置单次定时器，音频提前已知的命令发送延迟发出，
+// 使提示音正好落在目标时刻；LED动作在目标时刻挂起，由模式任务取出执行。
+// 时间与定时器来自CueClock，每次唤醒都按基准重新计算，误差不会累积。
+class CueScheduler {
+public:
+    CueScheduler(CueClock& clock);
+    ~CueScheduler();
+
+    // 设置提示表 (按offsetMs升序)，表需在调度期间保持有效
+    void setTable(const Cue* cues, size_t count);
+
+    // 设置音频命令从发出到开始播放的延迟
+    void setAudioLatencyUs(uint32_t latencyUs);
+
+    // 设置音频提示回调
+    void setAudioHandler(CueAudioHandler handler);
+
+    // 以anchorUs (时钟时间，对应计时开始) 为基准从头布置提示
+    void arm(int64_t anchorUs);
+
+    // 暂停后以新的基准继续，已触发的提示不再重复
+    void resume(int64_t anchorUs);
+
+    // 取消所有未触发的提示
+    void disarm();
+
+    bool isArmed() const { return _armed; }
+
+    // 取出挂起的LED动作，没有时返回false
+    bool takeLedAction(CueLedAction* action, uint16_t* durationMs);
+
+    // 触发所有到期的提示，返回下一次需要唤醒的时刻 (没有则返回-1)
+    int64_t process(int64_t nowUs);
+
+    // 提示的音频发送时刻与LED动作时刻
+    int64_t audioFireTimeUs(size_t index) const;
+    int64_t ledFireTimeUs(size_t index) const;
+
+private:
+    static void onTimer(void* arg);
+    void start(int64_t anchorUs, bool resetCursors);
+    void schedule(int64_t nextUs, int64_t nowUs);
+
+    const Cue* _cues;
+    size_t _count;
+    uint32_t _latencyUs;
+    CueAudioHandler _audioHandler;
+
+    int64_t _anchorUs;
+    size_t _nextAudio;      // 下一个待发送音频的提示
+    size_t _nextLed;        // 下一个待执行LED动作的提示
+    volatile bool _armed;
+
+    // 挂起的LED动作
+    CueLedAction _pendingAction;
+    uint16_t _pendingDurationMs;
+
+    CueClock& _clock;
+    bool _attached;         // 回调是否已绑定到时钟
+};
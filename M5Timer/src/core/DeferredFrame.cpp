@@ -0,0 +1,54 @@
+#include "DeferredFrame.h"
+#include <string.h>
+
+DeferredFrame::DeferredFrame() {
+    memset(_pixels, 0, sizeof(_pixels));
+    reset();
+}
+
+void DeferredFrame::reset() {
+    _hasFrame = false;
+    _sequence = 0;
+    _scheduled = false;
+    _presentAtMs = 0;
+}
+
+void DeferredFrame::store(const uint8_t* pixels, uint8_t sequence) {
+    memcpy(_pixels, pixels, sizeof(_pixels));
+    _hasFrame = true;
+    _sequence = sequence;
+    _scheduled = false;
+}
+
+bool DeferredFrame::onPresent(uint8_t sequence, bool hasTime, uint32_t presentAtMs, uint32_t nowMs) {
+    // 只显示与命令序号一致的缓存帧
+    if (!_hasFrame || sequence != _sequence) return false;
+
+    if (hasTime) {
+        int32_t untilPresent = (int32_t)(presentAtMs - nowMs);
+        if (untilPresent > 0 && untilPresent < DEFERRED_MAX_LEAD_MS) {
+            _scheduled = true;
+            _presentAtMs = presentAtMs;
+            return false;
+        }
+    }
+    _scheduled = false;
+    return true;
+}
+
+bool DeferredFrame::isDue(uint32_t nowMs) const {
+    return _scheduled && (int32_t)(nowMs - _presentAtMs) >= 0;
+}
+
+uint32_t DeferredFrame::deadlineMs(uint32_t nowMs) const {
+    if (!_scheduled) return DEFERRED_NO_DEADLINE;
+    int32_t untilPresent = (int32_t)(_presentAtMs - nowMs);
+    return untilPresent > 0 ? (uint32_t)untilPresent : 0;
+}
+
+const uint8_t* DeferredFrame::take() {
+    _scheduled = false;
+    if (!_hasFrame) return NULL;
+    _hasFrame = false;
+    return _pixels;
+}
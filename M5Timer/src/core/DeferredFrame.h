@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdint.h>
+#include "FrameParser.h"
+
+// 显示时刻与当前时刻的最大间隔，超出时认为时钟未对齐，立即显示 (毫秒)
+#define DEFERRED_MAX_LEAD_MS  1000
+
+// 没有安排显示时刻
+#define DEFERRED_NO_DEADLINE  0xFFFFFFFF
+
+// 延迟显示的帧
+// 缓存带序号的帧，收到序号一致的显示命令后立即显示，或在命令指定的本机时刻显示。
+// 显示时刻由主机按往返时间测得的时钟差换算为本机时钟，本类不读取时钟，由调用方传入当前时刻。
+class DeferredFrame {
+public:
+    DeferredFrame();
+
+    // 丢弃缓存的帧与显示安排
+    void reset();
+
+    // 缓存一帧，取消之前的显示安排
+    void store(const uint8_t* pixels, uint8_t sequence);
+
+    // 处理显示命令，返回true表示应立即显示 (调用take取出)
+    // 带显示时刻且在DEFERRED_MAX_LEAD_MS以内时安排定时显示，返回false
+    bool onPresent(uint8_t sequence, bool hasTime, uint32_t presentAtMs, uint32_t nowMs);
+
+    // 是否已到达安排的显示时刻
+    bool isDue(uint32_t nowMs) const;
+
+    // 距离显示时刻的时间，没有安排时返回DEFERRED_NO_DEADLINE
+    uint32_t deadlineMs(uint32_t nowMs) const;
+
+    // 取出缓存的帧用于显示，没有缓存的帧时返回NULL
+    const uint8_t* take();
+
+    bool hasFrame() const { return _hasFrame; }
+    bool isScheduled() const { return _scheduled; }
+    uint8_t sequence() const { return _sequence; }
+
+private:
+    uint8_t _pixels[FRAME_PIXELS];
+    bool _hasFrame;
+    uint8_t _sequence;
+    bool _scheduled;
+    uint32_t _presentAtMs;
+};
@@ -0,0 +1,53 @@
+#include "EspCueClock.h"
+
+EspCueClock::EspCueClock() {
+    _timer = NULL;
+    portMUX_INITIALIZE(&_lock);
+}
+
+EspCueClock::~EspCueClock() {
+    if (_timer != NULL) {
+        esp_timer_stop(_timer);
+        esp_timer_delete(_timer);
+    }
+}
+
+bool EspCueClock::attach(CueClockCallback callback, void* arg) {
+    if (_timer != NULL) return true;
+
+    esp_timer_create_args_t args = {};
+    args.callback = callback;
+    args.arg = arg;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "cue";
+    if (esp_timer_create(&args, &_timer) != ESP_OK) {
+        Serial.println("CueScheduler: 创建定时器失败");
+        _timer = NULL;
+        return false;
+    }
+    return true;
+}
+
+int64_t EspCueClock::nowUs() {
+    return esp_timer_get_time();
+}
+
+void EspCueClock::startOnce(uint64_t delayUs) {
+    if (_timer == NULL) return;
+    esp_timer_stop(_timer);
+    esp_timer_start_once(_timer, delayUs);
+}
+
+void EspCueClock::stop() {
+    if (_timer != NULL) {
+        esp_timer_stop(_timer);
+    }
+}
+
+void EspCueClock::lock() {
+    portENTER_CRITICAL(&_lock);
+}
+
+void EspCueClock::unlock() {
+    portEXIT_CRITICAL(&_lock);
+}
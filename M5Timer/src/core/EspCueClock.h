@@ -0,0 +1,24 @@
+#pragma once
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "CueClock.h"
+
+// 基于esp_timer的提示时钟
+// 回调在esp_timer任务中执行，临界区使用自旋锁 (双核安全)。
+class EspCueClock : public CueClock {
+public:
+    EspCueClock();
+    ~EspCueClock();
+
+    bool attach(CueClockCallback callback, void* arg) override;
+    int64_t nowUs() override;
+    void startOnce(uint64_t delayUs) override;
+    void stop() override;
+    void lock() override;
+    void unlock() override;
+
+private:
+    esp_timer_handle_t _timer;
+    portMUX_TYPE _lock;
+};
@@ -0,0 +1,246 @@
+#include "FrameParser.h"
+#include <string.h>
+
+// 文本命令前缀
+static const char PREFIX_SCREEN[] = "SCREEN:";
+static const char PREFIX_TEST[] = "TEST";
+
+FrameParser::FrameParser() {
+    memset(_pixels, 0, sizeof(_pixels));
+    _sequenced = false;
+    _sequence = 0;
+    _deferred = false;
+    _presentSequence = 0;
+    _hasPresentTime = false;
+    _presentTimeMs = 0;
+    _syncTimeMs = 0;
+    _frames = 0;
+    _checksumErrors = 0;
+    reset();
+}
+
+void FrameParser::reset() {
+    _state = STATE_LINE_START;
+    _prefixLength = 0;
+    _index = 0;
+    _value = 0;
+    _binaryLength = 0;
+}
+
+// 保存当前数值到下一个像素
+void FrameParser::storeValue() {
+    if (_index < FRAME_PIXELS) {
+        _pixels[_index++] = _value & 0x0F;  // 确保值在0-15范围内
+    }
+    _value = 0;
+}
+
+// 匹配文本命令前缀
+FrameParseResult FrameParser::pushPrefix(uint8_t byte) {
+    _prefix[_prefixLength++] = (char)byte;
+
+    bool screen = _prefixLength <= sizeof(PREFIX_SCREEN) - 1 &&
+                  memcmp(_prefix, PREFIX_SCREEN, _prefixLength) == 0;
+    bool test = _prefixLength <= sizeof(PREFIX_TEST) - 1 &&
+                memcmp(_prefix, PREFIX_TEST, _prefixLength) == 0;
+
+    if (screen && _prefixLength == sizeof(PREFIX_SCREEN) - 1) {
+        _state = STATE_VALUES;
+        _index = 0;
+        _value = 0;
+    } else if (test && _prefixLength == sizeof(PREFIX_TEST) - 1) {
+        _state = STATE_SKIP_LINE;
+        return FRAME_PARSE_TEST;
+    } else if (!screen && !test) {
+        _state = STATE_SKIP_LINE;
+    }
+    return FRAME_PARSE_NONE;
+}
+
+FrameParseResult FrameParser::push(uint8_t byte) {
+    switch (_state) {
+        case STATE_LINE_START:
+            if (byte == FRAME_HEADER) {
+                _state = STATE_BINARY;
+                _binaryLength = 0;
+            } else if (byte == PACKET_HEADER) {
+                _state = STATE_PACKET;
+                _binaryLength = 0;
+            } else if (byte != '\n' && byte != '\r' && byte != ' ' && byte != '\t') {
+                _state = STATE_PREFIX;
+                _prefixLength = 0;
+                return pushPrefix(byte);
+            }
+            break;
+
+        case STATE_PREFIX:
+            if (byte == '\n') {
+                _state = STATE_LINE_START;
+            } else {
+                return pushPrefix(byte);
+            }
+            break;
+
+        case STATE_VALUES:
+            if (byte >= '0' && byte <= '9') {
+                _value = _value * 10 + (byte - '0');
+            } else if (byte == ',') {
+                storeValue();
+            } else if (byte == '\n') {
+                // 最后一个值没有逗号，行尾结束一帧
+                storeValue();
+                _state = STATE_LINE_START;
+                _sequenced = false;
+                _deferred = false;
+                _frames++;
+                return FRAME_PARSE_PIXELS;
+            }
+            // 其他字符 (空白、回车) 忽略
+            break;
+
+        case STATE_SKIP_LINE:
+            if (byte == '\n') {
+                _state = STATE_LINE_START;
+            }
+            break;
+
+        case STATE_BINARY:
+            _binary[_binaryLength++] = byte;
+            if (_binaryLength == FRAME_LENGTH) {
+                _state = STATE_LINE_START;
+
+                // 验证校验和
+                uint8_t checksum = 0;
+                for (int i = 0; i < FRAME_LENGTH - 1; i++) {
+                    checksum ^= _binary[i];  // 使用异或作为简单的校验方式
+                }
+                if (checksum != _binary[FRAME_LENGTH - 1]) {
+                    _checksumErrors++;
+                    break;
+                }
+
+                for (int i = 0; i < FRAME_PIXELS; i++) {
+                    _pixels[i] = _binary[i] & 0x0F;
+                }
+                _sequenced = false;
+                _deferred = false;
+                _frames++;
+                return FRAME_PARSE_PIXELS;
+            }
+            break;
+
+        case STATE_PACKET:
+            _binary[_binaryLength++] = byte;
+            // 负载长度超出上限时直接丢弃，等待关键帧
+            if (_binaryLength == 3 && _binary[2] > PACKET_MAX_PAYLOAD) {
+                _state = STATE_LINE_START;
+                _checksumErrors++;
+                _sequenced = false;
+                return FRAME_PARSE_RESYNC;
+            }
+            if (_binaryLength > 3 && _binaryLength == 3 + _binary[2] + 1) {
+                _state = STATE_LINE_START;
+                return finishPacket();
+            }
+            break;
+    }
+    return FRAME_PARSE_NONE;
+}
+
+// 读取小端32位整数
+static uint32_t readUint32(const uint8_t* data) {
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+// 校验并解码一个完整的压缩帧
+FrameParseResult FrameParser::finishPacket() {
+    uint8_t type = _binary[0] & ~PACKET_DEFERRED;
+    bool deferred = (_binary[0] & PACKET_DEFERRED) != 0;
+    uint8_t sequence = _binary[1];
+    uint8_t length = _binary[2];
+    const uint8_t* payload = _binary + 3;
+
+    uint8_t checksum = 0;
+    for (int i = 0; i < 3 + length; i++) {
+        checksum ^= _binary[i];
+    }
+
+    bool ok = false;
+    if (checksum != payload[length]) {
+        _checksumErrors++;
+    } else if (type == PACKET_PRESENT && (length == 1 || length == 5)) {
+        // 显示与同步命令不改变画面，也不影响差分基准
+        _presentSequence = payload[0];
+        _hasPresentTime = length == 5;
+        _presentTimeMs = _hasPresentTime ? readUint32(payload + 1) : 0;
+        return FRAME_PARSE_PRESENT;
+    } else if (type == PACKET_SYNC && length == 4) {
+        _syncTimeMs = readUint32(payload);
+        return FRAME_PARSE_SYNC;
+    } else if (type == PACKET_PACKED) {
+        ok = decodePacked(payload, length);
+    } else if (type == PACKET_RLE) {
+        ok = decodeRle(payload, length);
+    } else if (type == PACKET_DELTA) {
+        ok = decodeDelta(payload, length);
+    }
+
+    // 丢失或损坏的帧之后不能再应用差分帧，直到收到新的完整帧
+    if (!ok) {
+        _sequenced = false;
+        return FRAME_PARSE_RESYNC;
+    }
+    _sequenced = true;
+    _sequence = sequence;
+    _deferred = deferred;
+    _frames++;
+    return FRAME_PARSE_PIXELS;
+}
+
+// 每字节两个像素，高4位在前
+bool FrameParser::decodePacked(const uint8_t* payload, uint8_t length) {
+    if (length != FRAME_PIXELS / 2) return false;
+
+    for (int i = 0; i < FRAME_PIXELS / 2; i++) {
+        _pixels[i * 2] = payload[i] >> 4;
+        _pixels[i * 2 + 1] = payload[i] & 0x0F;
+    }
+    return true;
+}
+
+// 游程必须正好覆盖全部像素，先解码到临时缓冲，避免损坏的帧覆盖当前画面
+bool FrameParser::decodeRle(const uint8_t* payload, uint8_t length) {
+    uint8_t pixels[FRAME_PIXELS];
+    int index = 0;
+
+    for (int i = 0; i < length; i++) {
+        int run = (payload[i] >> 4) + 1;
+        if (index + run > FRAME_PIXELS) return false;
+        memset(pixels + index, payload[i] & 0x0F, run);
+        index += run;
+    }
+    if (index != FRAME_PIXELS) return false;
+
+    memcpy(_pixels, pixels, sizeof(_pixels));
+    return true;
+}
+
+// 只有基准序号与当前画面一致时才应用
+bool FrameParser::decodeDelta(const uint8_t* payload, uint8_t length) {
+    if (length < 2 || !_sequenced || payload[0] != _sequence) return false;
+
+    uint8_t count = payload[1];
+    if (count > FRAME_PIXELS || length != 2 + count + (count + 1) / 2) return false;
+
+    const uint8_t* indices = payload + 2;
+    const uint8_t* colors = indices + count;
+    for (int i = 0; i < count; i++) {
+        if (indices[i] >= FRAME_PIXELS) return false;
+    }
+
+    for (int i = 0; i < count; i++) {
+        uint8_t packed = colors[i / 2];
+        _pixels[indices[i]] = (i % 2 == 0) ? (packed >> 4) : (packed & 0x0F);
+    }
+    return true;
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// 屏幕像素数量 (8x8)
+#define FRAME_PIXELS 64
+
+// 二进制帧: 帧头0xAA + 数据(64) + 保留(1) + 校验和(1)，校验和为前65字节的异或
+#define FRAME_HEADER 0xAA
+#define FRAME_LENGTH 66
+
+// 压缩帧: 帧头0xAB + 类型(1) + 序号(1) + 负载长度(1) + 负载 + 校验和(1)
+// 校验和为类型到负载末尾所有字节的异或
+#define PACKET_HEADER       0xAB
+#define PACKET_MAX_PAYLOAD  (2 + FRAME_PIXELS + FRAME_PIXELS / 2)   // 差分帧最坏情况
+#define PACKET_MAX_LENGTH   (3 + PACKET_MAX_PAYLOAD + 1)
+
+// 压缩帧类型
+#define PACKET_PACKED 0x01  // 完整帧，每字节两个像素 (高4位在前)，32字节
+#define PACKET_RLE    0x02  // 游程编码完整帧，每字节 (游程长度-1)<<4 | 颜色
+#define PACKET_DELTA  0x03  // 差分帧: 基准序号(1) + 数量(1) + 像素序号[数量] + 颜色 (每字节两个，高4位在前)
+#define PACKET_PRESENT 0x04 // 显示已缓存的帧: 帧序号(1) [+ 显示时刻(4，小端，毫秒，主机已换算为屏幕本机时钟)]
+#define PACKET_SYNC   0x05  // 时钟同步: 主机当前时刻(4，小端，毫秒)，屏幕回复 "SYNC:主机时刻,本机时刻"
+
+// 帧类型的延迟显示标志 - 帧只缓存，等待PACKET_PRESENT再显示
+#define PACKET_DEFERRED 0x80
+
+// 解析结果
+enum FrameParseResult {
+    FRAME_PARSE_NONE,     // 还没有完整的帧
+    FRAME_PARSE_PIXELS,   // 收到一帧像素数据
+    FRAME_PARSE_TEST,     // 收到TEST命令
+    FRAME_PARSE_RESYNC,   // 压缩帧损坏或差分帧基准不符，需要请求关键帧
+    FRAME_PARSE_PRESENT,  // 收到显示命令
+    FRAME_PARSE_SYNC      // 收到时钟同步
+};
+
+// 串口屏幕协议的流式解析器
+// 逐字节输入，同时支持0xAA二进制帧、0xAB压缩帧与 "SCREEN:a,b,...\n" / "TEST\n" 文本格式，
+// 不分配堆内存，也不等待后续数据。
+// 压缩帧带序号，差分帧只有在基准序号与当前帧一致时才会应用。
+class FrameParser {
+public:
+    FrameParser();
+
+    // 回到行首状态，保留当前像素
+    void reset();
+
+    // 输入一个字节
+    FrameParseResult push(uint8_t byte);
+
+    // 当前像素的颜色编号 (0-15)，按行优先排列
+    const uint8_t* pixels() const { return _pixels; }
+
+    // 统计
+    uint32_t frames() const { return _frames; }
+    uint32_t checksumErrors() const { return _checksumErrors; }
+
+    // 当前像素是否来自带序号的压缩帧，以及该帧的序号
+    bool hasSequence() const { return _sequenced; }
+    uint8_t sequence() const { return _sequence; }
+
+    // 最近一帧是否为延迟显示的帧
+    bool isDeferred() const { return _deferred; }
+
+    // 最近一次显示命令: 帧序号与可选的显示时刻 (屏幕本机时钟)
+    uint8_t presentSequence() const { return _presentSequence; }
+    bool hasPresentTime() const { return _hasPresentTime; }
+    uint32_t presentTimeMs() const { return _presentTimeMs; }
+
+    // 最近一次时钟同步的主机时刻
+    uint32_t syncTimeMs() const { return _syncTimeMs; }
+
+private:
+    enum State {
+        STATE_LINE_START,   // 行首，等待帧头或命令
+        STATE_PREFIX,       // 正在匹配文本命令前缀
+        STATE_VALUES,       // 正在解析SCREEN数值
+        STATE_SKIP_LINE,    // 丢弃到行尾
+        STATE_BINARY,       // 正在接收二进制帧
+        STATE_PACKET        // 正在接收压缩帧
+    };
+
+    FrameParseResult pushPrefix(uint8_t byte);
+    FrameParseResult finishPacket();
+    bool decodePacked(const uint8_t* payload, uint8_t length);
+    bool decodeRle(const uint8_t* payload, uint8_t length);
+    bool decodeDelta(const uint8_t* payload, uint8_t length);
+    void storeValue();
+
+    State _state;
+    uint8_t _pixels[FRAME_PIXELS];
+
+    // 文本解析状态
+    char _prefix[8];
+    uint8_t _prefixLength;
+    uint8_t _index;         // 下一个像素序号
+    uint16_t _value;        // 正在累加的数值 (只用到低4位)
+
+    // 二进制帧与压缩帧共用的缓冲
+    uint8_t _binary[PACKET_MAX_LENGTH];
+    uint8_t _binaryLength;
+
+    // 当前像素对应的压缩帧序号
+    bool _sequenced;
+    uint8_t _sequence;
+    bool _deferred;
+
+    // 显示命令与时钟同步
+    uint8_t _presentSequence;
+    bool _hasPresentTime;
+    uint32_t _presentTimeMs;
+    uint32_t _syncTimeMs;
+
+    uint32_t _frames;
+    uint32_t _checksumErrors;
+};
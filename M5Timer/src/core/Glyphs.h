@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stdint.h>
+
+// 数字字形
+// 每行一个8位掩码，最高位对应字形最左列；全部在编译期确定，存放在Flash中。
+struct Glyph {
+    uint8_t width;      // 字形宽度 (列)
+    uint8_t height;     // 字形高度 (行)
+    uint8_t rows[8];    // 每行的点阵掩码
+};
+
+// 4x8数字字体 (一屏显示两位数)
+constexpr Glyph FONT_4X8[10] = {
+    {4, 8, {0b11110000, 0b10010000, 0b10010000, 0b10010000, 0b10010000, 0b10010000, 0b10010000, 0b11110000}},  // 0
+    {4, 8, {0b00100000, 0b01100000, 0b10100000, 0b00100000, 0b00100000, 0b00100000, 0b00100000, 0b11110000}},  // 1
+    {4, 8, {0b11110000, 0b00010000, 0b00010000, 0b11110000, 0b10000000, 0b10000000, 0b10000000, 0b11110000}},  // 2
+    {4, 8, {0b11110000, 0b00010000, 0b00010000, 0b11110000, 0b00010000, 0b00010000, 0b00010000, 0b11110000}},  // 3
+    {4, 8, {0b10010000, 0b10010000, 0b10010000, 0b11110000, 0b00010000, 0b00010000, 0b00010000, 0b00010000}},  // 4
+    {4, 8, {0b11110000, 0b10000000, 0b10000000, 0b11110000, 0b00010000, 0b00010000, 0b00010000, 0b11110000}},  // 5
+    {4, 8, {0b11110000, 0b10000000, 0b10000000, 0b11110000, 0b10010000, 0b10010000, 0b10010000, 0b11110000}},  // 6
+    {4, 8, {0b11110000, 0b00010000, 0b00010000, 0b00010000, 0b00010000, 0b00010000, 0b00010000, 0b00010000}},  // 7
+    {4, 8, {0b11110000, 0b10010000, 0b10010000, 0b11110000, 0b10010000, 0b10010000, 0b10010000, 0b11110000}},  // 8
+    {4, 8, {0b11110000, 0b10010000, 0b10010000, 0b11110000, 0b00010000, 0b00010000, 0b00010000, 0b11110000}},  // 9
+};
+
+// 3x5比例数字字体 (三位数)，"1"只占一列
+constexpr Glyph FONT_3X5[10] = {
+    {3, 5, {0b11100000, 0b10100000, 0b10100000, 0b10100000, 0b11100000, 0, 0, 0}},  // 0
+    {1, 5, {0b10000000, 0b10000000, 0b10000000, 0b10000000, 0b10000000, 0, 0, 0}},  // 1
+    {3, 5, {0b11100000, 0b00100000, 0b11100000, 0b10000000, 0b11100000, 0, 0, 0}},  // 2
+    {3, 5, {0b11100000, 0b00100000, 0b11100000, 0b00100000, 0b11100000, 0, 0, 0}},  // 3
+    {3, 5, {0b10100000, 0b10100000, 0b11100000, 0b00100000, 0b00100000, 0, 0, 0}},  // 4
+    {3, 5, {0b11100000, 0b10000000, 0b11100000, 0b00100000, 0b11100000, 0, 0, 0}},  // 5
+    {3, 5, {0b11100000, 0b10000000, 0b11100000, 0b10100000, 0b11100000, 0, 0, 0}},  // 6
+    {3, 5, {0b11100000, 0b00100000, 0b00100000, 0b00100000, 0b00100000, 0, 0, 0}},  // 7
+    {3, 5, {0b11100000, 0b10100000, 0b11100000, 0b10100000, 0b11100000, 0, 0, 0}},  // 8
+    {3, 5, {0b11100000, 0b10100000, 0b11100000, 0b00100000, 0b11100000, 0, 0, 0}},  // 9
+};
+
+// 字形之间的间隔 (列)
+#define GLYPH_SPACING 1
+
+// 8列能完整显示的最大三位数: 不含"1"的三位数需要9列，百位为1时最多8列
+#define GLYPH_MAX_NUMBER 199
+
+// 在8列宽的屏幕上按比例宽度居中排版一串数字 (最多8个)，把每个字形的起始列写入xs
+// 放不下时先去掉窄字形 ("1") 旁的间隔，再去掉其余间隔; 去掉间隔后仍超过8列返回false
+inline bool layoutDigits(const uint8_t* digits, int count, const Glyph* font, int* xs) {
+    uint8_t gaps[8];
+    int total = 0;
+    for (int i = 0; i < count; i++) {
+        total += font[digits[i]].width;
+        gaps[i] = (i + 1 < count) ? GLYPH_SPACING : 0;
+        total += gaps[i];
+    }
+    for (int i = 0; i + 1 < count && total > 8; i++) {
+        if (font[digits[i]].width == 1 || font[digits[i + 1]].width == 1) {
+            total -= gaps[i];
+            gaps[i] = 0;
+        }
+    }
+    for (int i = 0; i + 1 < count && total > 8; i++) {
+        total -= gaps[i];
+        gaps[i] = 0;
+    }
+
+    int x = total < 8 ? (8 - total) / 2 : 0;
+    for (int i = 0; i < count; i++) {
+        xs[i] = x;
+        x += font[digits[i]].width + gaps[i];
+    }
+    return total <= 8;
+}
@@ -0,0 +1,123 @@
+#include "ImuFifo.h"
+#include <M5Unified.h>
+
+// MPU6886寄存器
+#define REG_SMPLRT_DIV      0x19
+#define REG_CONFIG          0x1A
+#define REG_ACCEL_CONFIG    0x1C
+#define REG_ACCEL_CONFIG2   0x1D
+#define REG_ACCEL_WOM_X_THR 0x20
+#define REG_ACCEL_WOM_Y_THR 0x21
+#define REG_ACCEL_WOM_Z_THR 0x22
+#define REG_FIFO_EN         0x23
+#define REG_INT_PIN_CFG     0x37
+#define REG_INT_ENABLE      0x38
+#define REG_INT_STATUS      0x3A
+#define REG_ACCEL_INTEL_CTRL 0x69
+#define REG_USER_CTRL       0x6A
+#define REG_PWR_MGMT_2      0x6C
+#define REG_FIFO_COUNTH     0x72
+#define REG_FIFO_R_W        0x74
+#define REG_WHO_AM_I        0x75
+
+// 加速度量程 ±8g
+#define ACCEL_LSB_PER_G     4096.0f
+
+ImuFifo::ImuFifo() {
+    _ready = false;
+    _transactions = 0;
+    _overflows = 0;
+}
+
+bool ImuFifo::writeRegister(uint8_t reg, uint8_t value) {
+    _transactions++;
+    return M5.In_I2C.writeRegister8(IMU_I2C_ADDR, reg, value, IMU_I2C_FREQ);
+}
+
+uint8_t ImuFifo::readRegister(uint8_t reg) {
+    _transactions++;
+    return M5.In_I2C.readRegister8(IMU_I2C_ADDR, reg, IMU_I2C_FREQ);
+}
+
+bool ImuFifo::readRegisters(uint8_t reg, uint8_t* buffer, size_t length) {
+    _transactions++;
+    return M5.In_I2C.readRegister(IMU_I2C_ADDR, reg, buffer, length, IMU_I2C_FREQ);
+}
+
+bool ImuFifo::begin() {
+    // 旧款M5StickC使用SH200Q，不支持FIFO与运动唤醒
+    uint8_t id = readRegister(REG_WHO_AM_I);
+    if (id != IMU_WHO_AM_I_VALUE) {
+        Serial.printf("ImuFifo: 未检测到MPU6886 (ID=0x%02X)\n", id);
+        return false;
+    }
+
+    bool ok = true;
+    ok &= writeRegister(REG_PWR_MGMT_2, 0x00);                            // 加速度计与陀螺仪全部开启
+    ok &= writeRegister(REG_SMPLRT_DIV, 1000 / IMU_SAMPLE_RATE_HZ - 1);   // 1kHz / (1 + DIV)
+    ok &= writeRegister(REG_CONFIG, 0x01);                                // DLPF开启，FIFO满时覆盖最旧数据
+    ok &= writeRegister(REG_ACCEL_CONFIG, 0x10);                          // ±8g
+    ok &= writeRegister(REG_ACCEL_CONFIG2, 0x00);
+
+    // 运动唤醒: 与上一个样本比较，任一轴超过阈值即触发
+    ok &= writeRegister(REG_ACCEL_WOM_X_THR, IMU_WOM_THRESHOLD);
+    ok &= writeRegister(REG_ACCEL_WOM_Y_THR, IMU_WOM_THRESHOLD);
+    ok &= writeRegister(REG_ACCEL_WOM_Z_THR, IMU_WOM_THRESHOLD);
+    ok &= writeRegister(REG_ACCEL_INTEL_CTRL, 0xC0);
+
+    // INT引脚: 低电平有效，推挽输出，锁存直到读取INT_STATUS
+    ok &= writeRegister(REG_INT_PIN_CFG, 0xA0);
+    ok &= writeRegister(REG_INT_ENABLE, 0xE0);
+
+    // FIFO: 加速度 + 陀螺仪
+    ok &= writeRegister(REG_FIFO_EN, 0x18);
+    resetFifo();
+
+    if (!ok) {
+        Serial.println("ImuFifo: 配置失败");
+        return false;
+    }
+
+    clearInterrupt();
+    _ready = true;
+    Serial.println("ImuFifo: FIFO与运动唤醒已启用");
+    return true;
+}
+
+void ImuFifo::resetFifo() {
+    writeRegister(REG_USER_CTRL, 0x04);   // FIFO_RST
+    writeRegister(REG_USER_CTRL, 0x40);   // FIFO_EN
+}
+
+uint8_t ImuFifo::clearInterrupt() {
+    return readRegister(REG_INT_STATUS);
+}
+
+// 读取FIFO计数后一次读出所有完整的包
+size_t ImuFifo::read(MotionSample* samples, size_t maxSamples) {
+    if (!_ready) return 0;
+
+    uint8_t countBytes[2];
+    if (!readRegisters(REG_FIFO_COUNTH, countBytes, 2)) return 0;
+    size_t bytes = ((countBytes[0] & 0x1F) << 8) | countBytes[1];
+    if (bytes >= IMU_FIFO_SIZE) {
+        _overflows++;
+        resetFifo();
+        return 0;
+    }
+    size_t packets = bytes / IMU_FIFO_PACKET;
+
+    if (packets > maxSamples) packets = maxSamples;
+    if (packets > IMU_FIFO_MAX_PACKETS) packets = IMU_FIFO_MAX_PACKETS;
+    if (packets == 0) return 0;
+
+    if (!readRegisters(REG_FIFO_R_W, _buffer, packets * IMU_FIFO_PACKET)) return 0;
+
+    for (size_t i = 0; i < packets; i++) {
+        const uint8_t* packet = _buffer + i * IMU_FIFO_PACKET;
+        samples[i].x = (int16_t)((packet[0] << 8) | packet[1]) / ACCEL_LSB_PER_G;
+        samples[i].y = (int16_t)((packet[2] << 8) | packet[3]) / ACCEL_LSB_PER_G;
+        samples[i].z = (int16_t)((packet[4] << 8) | packet[5]) / ACCEL_LSB_PER_G;
+    }
+    return packets;
+}
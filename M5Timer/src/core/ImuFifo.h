@@ -0,0 +1,59 @@
+#pragma once
+
+#include <Arduino.h>
+#include "MotionClassifier.h"
+
+// MPU6886 I2C地址与芯片ID
+#define IMU_I2C_ADDR        0x68
+#define IMU_WHO_AM_I_VALUE  0x19
+#define IMU_I2C_FREQ        400000
+
+// FIFO采样率与包格式 (加速度 + 温度 + 陀螺仪，共14字节)
+#define IMU_SAMPLE_RATE_HZ  100
+#define IMU_FIFO_PACKET     14
+#define IMU_FIFO_SIZE       1024    // 片上FIFO字节数 (不是包长的整数倍)
+#define IMU_FIFO_MAX_PACKETS 64     // 单次突发读取的最大样本数
+
+// 运动唤醒阈值 (4mg/LSB)
+#define IMU_WOM_THRESHOLD   40
+
+// MPU6886 FIFO + 运动唤醒
+// 传感器按固定采样率把样本写入片上FIFO，检测到运动时通过INT引脚触发中断，
+// 任务被唤醒后一次突发读取FIFO中的全部样本。
+class ImuFifo {
+public:
+    ImuFifo();
+
+    // 检测MPU6886并配置FIFO与运动唤醒，不支持时返回false
+    bool begin();
+
+    bool isReady() const { return _ready; }
+
+    // 一次突发读取FIFO中的样本，返回样本数量
+    // FIFO已满时最旧的数据被覆盖过，包边界已错位，清空FIFO并返回0
+    size_t read(MotionSample* samples, size_t maxSamples);
+
+    // 读取中断状态，清除锁存的运动中断
+    uint8_t clearInterrupt();
+
+    // 清空FIFO (溢出或静止期间长时间未读取后)
+    void resetFifo();
+
+    uint32_t sampleIntervalUs() const { return 1000000 / IMU_SAMPLE_RATE_HZ; }
+
+    // 已执行的I2C事务数量
+    uint32_t transactions() const { return _transactions; }
+
+    // 因FIFO溢出而丢弃的次数
+    uint32_t overflows() const { return _overflows; }
+
+private:
+    bool writeRegister(uint8_t reg, uint8_t value);
+    uint8_t readRegister(uint8_t reg);
+    bool readRegisters(uint8_t reg, uint8_t* buffer, size_t length);
+
+    bool _ready;
+    uint32_t _transactions;
+    uint32_t _overflows;
+    uint8_t _buffer[IMU_FIFO_PACKET * IMU_FIFO_MAX_PACKETS];
+};
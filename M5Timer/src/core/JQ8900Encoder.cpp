@@ -0,0 +1,104 @@
+#include "JQ8900Encoder.h"
+
+JQ8900Encoder::JQ8900Encoder() {
+    reset();
+}
+
+// 清空缓冲区
+void JQ8900Encoder::reset() {
+    _count = 0;
+    _segmentCount = 0;
+    _lastByteSegment = 0;
+    _lastByteGapUs = 0;
+    _totalUs = 0;
+    _overflow = false;
+}
+
+// 开始新的一段
+bool JQ8900Encoder::beginSegment() {
+    if (_segmentCount >= JQ8900_MAX_SEGMENTS) {
+        _overflow = true;
+        return false;
+    }
+    _segmentStart[_segmentCount++] = _count;
+    return true;
+}
+
+// 分段包含的电平段数量
+size_t JQ8900Encoder::segmentLength(size_t segment) const {
+    size_t end = (segment + 1 < _segmentCount) ? _segmentStart[segment + 1] : _count;
+    return end - _segmentStart[segment];
+}
+
+// 追加一个电平段，同一分段内相同电平的相邻段自动合并，超长段自动拆分
+bool JQ8900Encoder::appendPhase(uint8_t level, uint32_t durationUs) {
+    if (durationUs == 0) return true;
+    if (_segmentCount == 0 && !beginSegment()) return false;
+    _totalUs += durationUs;
+
+    // 与上一段电平相同时先尽量合并 (不跨越分段边界)
+    if (_count > _segmentStart[_segmentCount - 1] && _phases[_count - 1].level == level) {
+        uint32_t room = JQ8900_MAX_PHASE_US - _phases[_count - 1].durationUs;
+        uint32_t merged = durationUs < room ? durationUs : room;
+        _phases[_count - 1].durationUs += merged;
+        durationUs -= merged;
+    }
+
+    // 剩余部分按最大时长拆分
+    while (durationUs > 0) {
+        if (_count >= JQ8900_MAX_PHASES) {
+            _overflow = true;
+            return false;
+        }
+        uint32_t chunk = durationUs < JQ8900_MAX_PHASE_US ? durationUs : JQ8900_MAX_PHASE_US;
+        _phases[_count].level = level;
+        _phases[_count].durationUs = chunk;
+        _count++;
+        durationUs -= chunk;
+    }
+    return true;
+}
+
+// 追加一个字节: 开始信号 + 引导码 + 8位数据(低位在前) + 结束信号 + 间隔
+bool JQ8900Encoder::appendByte(uint8_t data, uint32_t gapUs) {
+    if (!beginSegment()) return false;
+    _lastByteSegment = _segmentCount - 1;
+    appendPhase(1, JQ8900_START_US);
+    appendPhase(0, JQ8900_LEAD_US);
+
+    for (uint8_t i = 0; i < 8; i++) {
+        if (data & 0x01) {
+            // 数据1 (高:低 = 3:1)
+            appendPhase(1, JQ8900_BIT_LONG_US);
+            appendPhase(0, JQ8900_BIT_SHORT_US);
+        } else {
+            // 数据0 (高:低 = 1:3)
+            appendPhase(1, JQ8900_BIT_SHORT_US);
+            appendPhase(0, JQ8900_BIT_LONG_US);
+        }
+        data >>= 1;
+    }
+
+    // 最小字节间隔保留在本段内，保证中止后下一个字节仍有足够间隔
+    uint32_t minGap = gapUs < JQ8900_BYTE_GAP_US ? gapUs : JQ8900_BYTE_GAP_US;
+    appendPhase(1, JQ8900_END_US + minGap);
+    _lastByteGapUs = minGap;
+    if (gapUs > minGap) {
+        appendIdle(gapUs - minGap);
+    }
+    return !_overflow;
+}
+
+// 追加一段高电平空闲时间
+bool JQ8900Encoder::appendIdle(uint32_t durationUs) {
+    if (durationUs == 0) return true;
+    if (!beginSegment()) return false;
+    appendPhase(1, durationUs);
+    return !_overflow;
+}
+
+uint32_t JQ8900Encoder::byteDurationUs(uint32_t gapUs) {
+    return JQ8900_START_US + JQ8900_LEAD_US +
+           8 * (JQ8900_BIT_SHORT_US + JQ8900_BIT_LONG_US) +
+           JQ8900_END_US + gapUs;
+}
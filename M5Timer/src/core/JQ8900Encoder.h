@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// JQ8900一线协议时序 (单位: 微秒)
+#define JQ8900_START_US      1000   // 开始信号 (高电平)
+#define JQ8900_LEAD_US       4000   // 引导码 (低电平)
+#define JQ8900_BIT_SHORT_US  200    // 位短电平
+#define JQ8900_BIT_LONG_US   600    // 位长电平 (数据1 高:低 = 3:1, 数据0 高:低 = 1:3)
+#define JQ8900_END_US        1000   // 结束信号 (高电平)
+#define JQ8900_BYTE_GAP_US   10000  // 字节之间的间隔 (建议10ms以上)
+#define JQ8900_CMD_GAP_US    50000  // 命令之间的间隔
+
+// 单个电平段最大时长，与RMT条目的15位时长字段一致 (1us/tick)
+#define JQ8900_MAX_PHASE_US  32767
+
+// 编码缓冲区容量 (电平段数量)，足够容纳一次选曲播放的完整序列
+#define JQ8900_MAX_PHASES    256
+
+// 分段数量上限 - 每个字节一段，超过最小间隔的命令间隔单独一段
+#define JQ8900_MAX_SEGMENTS  32
+
+// 一个电平段: 电平 + 持续时间
+struct JQ8900Phase {
+    uint8_t level;        // 0 = 低电平, 1 = 高电平
+    uint16_t durationUs;  // 持续时间 (微秒)
+};
+
+// JQ8900命令序列编码器
+// 将整段命令字节序列编码为电平段缓冲区，不依赖任何硬件。
+// 序列按字节边界分段，发送端逐段交给RMT，需要中止时在段边界停止。
+class JQ8900Encoder {
+public:
+    JQ8900Encoder();
+
+    // 清空缓冲区，开始一段新的序列
+    void reset();
+
+    // 追加一个字节，gapUs为该字节结束后保持高电平的额外时间
+    // 最小字节间隔与字节同段，多出的部分另起一段以便中止时跳过
+    bool appendByte(uint8_t data, uint32_t gapUs = JQ8900_BYTE_GAP_US);
+
+    // 追加一段保持高电平的空闲时间 (单独成段)
+    bool appendIdle(uint32_t durationUs);
+
+    const JQ8900Phase* phases() const { return _phases; }
+    size_t count() const { return _count; }
+    bool overflowed() const { return _overflow; }
+
+    // 分段信息
+    size_t segmentCount() const { return _segmentCount; }
+    size_t segmentStart(size_t segment) const { return _segmentStart[segment]; }
+    size_t segmentLength(size_t segment) const;
+
+    // 最后一个字节所在的分段 (其后只剩命令间隔)
+    size_t lastByteSegment() const { return _lastByteSegment; }
+
+    // 最后一个字节的结束信号之后、仍在同一分段内的间隔 (微秒)
+    // 该分段发完的时刻减去此值即为字节结束信号发完、模块执行命令的时刻
+    uint32_t lastByteGapUs() const { return _lastByteGapUs; }
+
+    // 整段序列的总时长 (微秒)
+    uint32_t totalDurationUs() const { return _totalUs; }
+
+    // 单个字节 (含gapUs) 在线上所占的时长，每位固定800us，与数据无关
+    static uint32_t byteDurationUs(uint32_t gapUs = JQ8900_BYTE_GAP_US);
+
+private:
+    bool beginSegment();
+    bool appendPhase(uint8_t level, uint32_t durationUs);
+
+    JQ8900Phase _phases[JQ8900_MAX_PHASES];
+    size_t _count;
+    size_t _segmentStart[JQ8900_MAX_SEGMENTS];
+    size_t _segmentCount;
+    size_t _lastByteSegment;
+    uint32_t _lastByteGapUs;
+    uint32_t _totalUs;
+    bool _overflow;
+};
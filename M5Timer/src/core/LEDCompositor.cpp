@@ -0,0 +1,194 @@
+#include "LEDCompositor.h"
+
+LEDCompositor::LEDCompositor(LEDMatrix& matrix) : _matrix(matrix) {
+    _count = 0;
+    _dirty = ~0ULL;
+}
+
+bool LEDCompositor::isValid(int layer) const {
+    return layer >= 0 && layer < _count;
+}
+
+// 添加图层，按z顺序插入绘制顺序表
+int LEDCompositor::addLayer(const char* name, int z) {
+    if (_count >= COMPOSITOR_MAX_LAYERS) {
+        Serial.println("LEDCompositor: 图层已满");
+        return -1;
+    }
+
+    int id = _count++;
+    Layer& layer = _layers[id];
+    layer.name = name;
+    layer.z = z;
+    layer.dx = 0;
+    layer.dy = 0;
+    layer.alpha = 255;
+    layer.visible = true;
+    layer.opaque = 0;
+    memset(layer.pixels, 0, sizeof(layer.pixels));
+
+    // z相同的图层后添加的在上面
+    int pos = id;
+    while (pos > 0 && _layers[_order[pos - 1]].z > z) {
+        _order[pos] = _order[pos - 1];
+        pos--;
+    }
+    _order[pos] = id;
+    return id;
+}
+
+int LEDCompositor::findLayer(const char* name) const {
+    for (int i = 0; i < _count; i++) {
+        if (strcmp(_layers[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+// 平移8x8位图，移出边界的像素丢弃
+uint64_t LEDCompositor::shiftMask(uint64_t mask, int dx, int dy) {
+    if (dx <= -8 || dx >= 8 || dy <= -8 || dy >= 8) return 0;
+
+    if (dx > 0) {
+        // 每行左侧dx列移到右侧，先去掉会溢出到下一行的列
+        uint8_t keep = 0xFF >> dx;
+        mask = (mask & (0x0101010101010101ULL * keep)) << dx;
+    } else if (dx < 0) {
+        uint8_t keep = (uint8_t)(0xFF << -dx);
+        mask = (mask & (0x0101010101010101ULL * keep)) >> -dx;
+    }
+
+    if (dy > 0) {
+        mask <<= dy * 8;
+    } else if (dy < 0) {
+        mask >>= -dy * 8;
+    }
+    return mask;
+}
+
+uint64_t LEDCompositor::coverage(const Layer& layer) const {
+    return shiftMask(layer.opaque, layer.dx, layer.dy);
+}
+
+// 图层上一个像素变化，记录对应的屏幕像素
+void LEDCompositor::markLayerPixel(const Layer& layer, int x, int y) {
+    int sx = x + layer.dx;
+    int sy = y + layer.dy;
+    if (sx >= 0 && sx < 8 && sy >= 0 && sy < 8) {
+        _dirty |= 1ULL << (sy * 8 + sx);
+    }
+}
+
+void LEDCompositor::clearLayer(int layer) {
+    if (!isValid(layer)) return;
+    Layer& l = _layers[layer];
+    _dirty |= coverage(l);
+    l.opaque = 0;
+}
+
+void LEDCompositor::setPixel(int layer, int x, int y, uint32_t color) {
+    if (!isValid(layer) || x < 0 || x >= 8 || y < 0 || y >= 8) return;
+    Layer& l = _layers[layer];
+    int i = y * 8 + x;
+    uint64_t bit = 1ULL << i;
+
+    // 颜色没有变化时不标记
+    if ((l.opaque & bit) && l.pixels[i] == color) return;
+    l.pixels[i] = color;
+    l.opaque |= bit;
+    markLayerPixel(l, x, y);
+}
+
+void LEDCompositor::clearPixel(int layer, int x, int y) {
+    if (!isValid(layer) || x < 0 || x >= 8 || y < 0 || y >= 8) return;
+    Layer& l = _layers[layer];
+    uint64_t bit = 1ULL << (y * 8 + x);
+    if (!(l.opaque & bit)) return;
+    l.opaque &= ~bit;
+    markLayerPixel(l, x, y);
+}
+
+void LEDCompositor::drawGlyph(int layer, const Glyph& glyph, int x, int y, uint32_t color) {
+    for (int row = 0; row < glyph.height; row++) {
+        uint8_t bits = glyph.rows[row];
+        while (bits) {
+            int col = __builtin_clz((unsigned int)bits) - 24;
+            bits &= ~(0x80 >> col);
+            setPixel(layer, x + col, y + row, color);
+        }
+    }
+}
+
+void LEDCompositor::setOffset(int layer, int dx, int dy) {
+    if (!isValid(layer)) return;
+    Layer& l = _layers[layer];
+    if (l.dx == dx && l.dy == dy) return;
+
+    // 原位置与新位置覆盖的像素都需要重算
+    _dirty |= coverage(l);
+    l.dx = dx;
+    l.dy = dy;
+    _dirty |= coverage(l);
+}
+
+void LEDCompositor::setAlpha(int layer, uint8_t alpha) {
+    if (!isValid(layer) || _layers[layer].alpha == alpha) return;
+    _layers[layer].alpha = alpha;
+    _dirty |= coverage(_layers[layer]);
+}
+
+void LEDCompositor::setVisible(int layer, bool visible) {
+    if (!isValid(layer) || _layers[layer].visible == visible) return;
+    _layers[layer].visible = visible;
+    _dirty |= coverage(_layers[layer]);
+}
+
+bool LEDCompositor::isVisible(int layer) const {
+    return isValid(layer) && _layers[layer].visible;
+}
+
+void LEDCompositor::invalidate() {
+    _dirty = ~0ULL;
+}
+
+// 按透明度混合两种颜色
+uint32_t LEDCompositor::blend(uint32_t below, uint32_t above, uint8_t alpha) {
+    if (alpha == 255) return above;
+    if (alpha == 0) return below;
+
+    uint32_t result = 0;
+    for (int shift = 0; shift < 24; shift += 8) {
+        uint32_t b = (below >> shift) & 0xFF;
+        uint32_t a = (above >> shift) & 0xFF;
+        result |= ((a * alpha + b * (255 - alpha) + 127) / 255) << shift;
+    }
+    return result;
+}
+
+// 只重算变化的像素，从下到上逐层混合后写入后台缓冲区
+void LEDCompositor::compose() {
+    uint64_t dirty = _dirty;
+    if (dirty == 0) return;
+    _dirty = 0;
+
+    while (dirty) {
+        int i = __builtin_ctzll(dirty);
+        dirty &= dirty - 1;
+        int x = i & 7;
+        int y = i >> 3;
+
+        uint32_t color = 0;  // 背景为黑色
+        for (int k = 0; k < _count; k++) {
+            const Layer& l = _layers[_order[k]];
+            if (!l.visible || l.alpha == 0) continue;
+            int lx = x - l.dx;
+            int ly = y - l.dy;
+            if (lx < 0 || lx >= 8 || ly < 0 || ly >= 8) continue;
+            int li = ly * 8 + lx;
+            if (l.opaque & (1ULL << li)) {
+                color = blend(color, l.pixels[li], l.alpha);
+            }
+        }
+        _matrix.setPixel(x, y, color);
+    }
+    _matrix.present();
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <Arduino.h>
+#include "LEDMatrix.h"
+#include "Glyphs.h"
+
+// 最多图层数
+#define COMPOSITOR_MAX_LAYERS 4
+
+// LED图层合成器
+// 每个图层是一块8x8画布，未绘制的像素透明，可设置z顺序、整体透明度和偏移。
+// 图层内容或属性变化时只记录受影响的屏幕像素，compose()只重算这些像素，
+// 写入LEDMatrix后台缓冲区并提交，其余像素保持不变。
+class LEDCompositor {
+public:
+    LEDCompositor(LEDMatrix& matrix);
+
+    // 添加图层，z越大越靠上，返回图层编号 (已满返回-1)
+    int addLayer(const char* name, int z);
+    int findLayer(const char* name) const;
+
+    // 图层内容 (图层坐标)
+    void clearLayer(int layer);
+    void setPixel(int layer, int x, int y, uint32_t color);
+    void clearPixel(int layer, int x, int y);  // 恢复为透明
+    void drawGlyph(int layer, const Glyph& glyph, int x, int y, uint32_t color);
+
+    // 图层属性
+    void setOffset(int layer, int dx, int dy);
+    void setAlpha(int layer, uint8_t alpha);   // 255为不透明
+    void setVisible(int layer, bool visible);
+    bool isVisible(int layer) const;
+
+    // 其他代码直接改写过LED矩阵后调用，下一次合成全部重算
+    void invalidate();
+
+    // 重算变化的像素并提交，没有变化时不做任何事
+    void compose();
+
+private:
+    struct Layer {
+        const char* name;
+        int z;
+        int8_t dx, dy;          // 偏移 (屏幕坐标 = 图层坐标 + 偏移)
+        uint8_t alpha;
+        bool visible;
+        uint64_t opaque;        // 已绘制的像素 (图层坐标，第y*8+x位)
+        uint32_t pixels[64];    // 图层颜色 (图层坐标)
+    };
+
+    bool isValid(int layer) const;
+    uint64_t coverage(const Layer& layer) const;   // 图层覆盖的屏幕像素
+    void markLayerPixel(const Layer& layer, int x, int y);
+    static uint64_t shiftMask(uint64_t mask, int dx, int dy);
+    static uint32_t blend(uint32_t below, uint32_t above, uint8_t alpha);
+
+    LEDMatrix& _matrix;
+    Layer _layers[COMPOSITOR_MAX_LAYERS];
+    uint8_t _order[COMPOSITOR_MAX_LAYERS];   // 按z从下到上排列的图层编号
+    int _count;
+    uint64_t _dirty;                         // 需要重算的屏幕像素
+};
@@ -0,0 +1,36 @@
+#include "LEDFrameBuffer.h"
+#include <string.h>
+
+LEDFrameBuffer::LEDFrameBuffer() {
+    memset(_buffers, 0, sizeof(_buffers));
+    memset(_shown, 0, sizeof(_shown));
+    _front = _buffers[0];
+    _back = _buffers[1];
+}
+
+void LEDFrameBuffer::clear() {
+    memset(_back, 0, sizeof(_buffers[0]));
+}
+
+void LEDFrameBuffer::commit() {
+    uint32_t* submitted = _back;
+    _back = _front;
+    _front = submitted;
+    memcpy(_back, _front, sizeof(_buffers[0]));
+}
+
+void LEDFrameBuffer::copyFront(uint32_t* frame) const {
+    memcpy(frame, _front, sizeof(_buffers[0]));
+}
+
+bool LEDFrameBuffer::applyShown(const uint32_t* frame) {
+    // 64个像素顺序比较，编译器可以展开; 只在画面变化时发送
+    bool changed = false;
+    for (int i = 0; i < LED_FRAME_PIXELS; i++) {
+        if (frame[i] != _shown[i]) {
+            changed = true;
+            _shown[i] = frame[i];
+        }
+    }
+    return changed;
+}
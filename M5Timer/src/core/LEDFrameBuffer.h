@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdint.h>
+
+// 帧缓冲的像素数量 (8x8)
+#define LED_FRAME_PIXELS 64
+
+// LED双缓冲 (不含锁与输出，不依赖任何硬件)
+// 绘制只写后台缓冲区; 提交时交换前后台; 刷新时复制前台，与已发送的画面逐个比较64个像素，
+// 清空后重绘相同内容的像素不算变化。
+// 单生产者: clear/setPixel/commit必须在同一个绘制任务中调用，后台缓冲区不加锁，
+// 其他任务并发绘制会写进刚交换出去的前台。
+// 只有commit与copyFront之间跨任务，调用方负责在这两处加同一把锁。
+class LEDFrameBuffer {
+public:
+    LEDFrameBuffer();
+
+    // 清空后台缓冲区
+    void clear();
+
+    // 写后台缓冲区，index必须在0-63之间 (只能在绘制任务中调用)
+    void setPixel(int index, uint32_t color) {
+        _back[index] = color;
+    }
+
+    // 提交后台缓冲区: 交换前后台，新的后台从新的前台复制，继续在上一帧上绘制
+    void commit();
+
+    // 复制已提交的画面到frame
+    void copyFront(uint32_t* frame) const;
+
+    // 把frame合并到已发送的画面，返回是否有像素改变
+    bool applyShown(const uint32_t* frame);
+
+    // 已发送到LED的画面
+    const uint32_t* shown() const { return _shown; }
+
+private:
+    uint32_t _buffers[2][LED_FRAME_PIXELS];
+    uint32_t* _front;           // 已提交的画面
+    uint32_t* _back;            // 正在绘制的画面
+    uint32_t _shown[LED_FRAME_PIXELS];
+};
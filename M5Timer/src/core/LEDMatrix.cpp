@@ -6,159 +6,84 @@ const uint32_t Green = 0x00FF00;
 const uint32_t Blue = 0x0000FF;
 const uint32_t Yellow = 0xFFFF00;
 
-// 4x8数字点阵定义
-const bool DIGITS[10][8][4] = {
-    { // 0
-        {1,1,1,1},
-        {1,0,0,1},
-        {1,0,0,1},
-        {1,0,0,1},
-        {1,0,0,1},
-        {1,0,0,1},
-        {1,0,0,1},
-        {1,1,1,1}
-    },
-    { // 1
-        {0,0,1,0},
-        {0,1,1,0},
-        {1,0,1,0},
-        {0,0,1,0},
-        {0,0,1,0},
-        {0,0,1,0},
-        {0,0,1,0},
-        {1,1,1,1}
-    },
-    { // 2
-        {1,1,1,1},
-        {0,0,0,1},
-        {0,0,0,1},
-        {1,1,1,1},
-        {1,0,0,0},
-        {1,0,0,0},
-        {1,0,0,0},
-        {1,1,1,1}
-    },
-    { // 3
-        {1,1,1,1},
-        {0,0,0,1},
-        {0,0,0,1},
-        {1,1,1,1},
-        {0,0,0,1},
-        {0,0,0,1},
-        {0,0,0,1},
-        {1,1,1,1}
-    },
-    { // 4
-        {1,0,0,1},
-        {1,0,0,1},
-        {1,0,0,1},
-        {1,1,1,1},
-        {0,0,0,1},
-        {0,0,0,1},
-        {0,0,0,1},
-        {0,0,0,1}
-    },
-    { // 5
-        {1,1,1,1},
-        {1,0,0,0},
-        {1,0,0,0},
-        {1,1,1,1},
-        {0,0,0,1},
-        {0,0,0,1},
-        {0,0,0,1},
-        {1,1,1,1}
-    },
-    { // 6
-        {1,1,1,1},
-        {1,0,0,0},
-        {1,0,0,0},
-        {1,1,1,1},
-        {1,0,0,1},
-        {1,0,0,1},
-        {1,0,0,1},
-        {1,1,1,1}
-    },
-    { // 7
-        {1,1,1,1},
-        {0,0,0,1},
-        {0,0,0,1},
-        {0,0,0,1},
-        {0,0,0,1},
-        {0,0,0,1},
-        {0,0,0,1},
-        {0,0,0,1}
-    },
-    { // 8
-        {1,1,1,1},
-        {1,0,0,1},
-        {1,0,0,1},
-        {1,1,1,1},
-        {1,0,0,1},
-        {1,0,0,1},
-        {1,0,0,1},
-        {1,1,1,1}
-    },
-    { // 9
-        {1,1,1,1},
-        {1,0,0,1},
-        {1,0,0,1},
-        {1,1,1,1},
-        {0,0,0,1},
-        {0,0,0,1},
-        {0,0,0,1},
-        {1,1,1,1}
-    }
+// 坐标到LED序号的蛇形映射: 偶数行（0,2,4,6）从右到左，奇数行从左到右
+constexpr uint8_t serpentineIndex(int x, int y) {
+    return (y % 2 == 0) ? y * 8 + (7 - x) : y * 8 + x;
+}
+
+#define LED_INDEX_ROW(y) { \
+    serpentineIndex(0, y), serpentineIndex(1, y), serpentineIndex(2, y), serpentineIndex(3, y), \
+    serpentineIndex(4, y), serpentineIndex(5, y), serpentineIndex(6, y), serpentineIndex(7, y) }
+
+// 编译期生成的坐标 -> LED序号表 [y][x]
+static constexpr uint8_t LED_INDEX[8][8] = {
+    LED_INDEX_ROW(0), LED_INDEX_ROW(1), LED_INDEX_ROW(2), LED_INDEX_ROW(3),
+    LED_INDEX_ROW(4), LED_INDEX_ROW(5), LED_INDEX_ROW(6), LED_INDEX_ROW(7)
 };
 
-LEDMatrix::LEDMatrix() : strip(NUM_LEDS, LED_PIN, NEO_GRB + NEO_KHZ800) {
+static_assert(LED_INDEX[0][0] == 7 && LED_INDEX[0][7] == 0, "偶数行应从右到左");
+static_assert(LED_INDEX[1][0] == 8 && LED_INDEX[7][7] == 63, "奇数行应从左到右");
+
+LEDMatrix::LEDMatrix() : output(LED_PIN), colorLut(LED_GAMMA, BRIGHTNESS) {
     needsFullUpdate = true;
-    
-    // 初始化缓存
-    for (int i = 0; i < NUM_LEDS; i++) {
-        pixelCache[i] = 0;
-        pixelChanged[i] = false;
-    }
+    stripMutex = NULL;
+    portMUX_INITIALIZE(&bufferLock);
 }
 
 void LEDMatrix::begin() {
-    // 初始化NeoPixel
-    strip.begin();
-    strip.setBrightness(BRIGHTNESS);
+    if (stripMutex == NULL) {
+        stripMutex = xSemaphoreCreateMutex();
+    }
+    
+    // 初始化RMT输出 (引脚可能刚被麦克风占用过，LED上的内容未知，下一次提交发送整帧)
+    output.begin();
+    needsFullUpdate = true;
     clear();
 }
 
-void LEDMatrix::update() {
-    bool hasChanges = false;
+// 提交后台缓冲区并刷新显示
+// 必须在绘制任务中调用，锁只防止update()读到交换到一半的前台
+void LEDMatrix::present() {
+    portENTER_CRITICAL(&bufferLock);
+    frames.commit();
+    portEXIT_CRITICAL(&bufferLock);
     
-    // 检查是否有像素变化
-    for (int i = 0; i < NUM_LEDS; i++) {
-        if (pixelChanged[i]) {
-            hasChanges = true;
-            strip.setPixelColor(i, pixelCache[i]); // 将更改应用到NeoPixel
-            pixelChanged[i] = false;  // 重置变化标记
-        }
+    update();
+}
+
+void LEDMatrix::update() {
+    if (stripMutex != NULL) {
+        xSemaphoreTake(stripMutex, portMAX_DELAY);
     }
     
-    // 只有在有变化时才更新显示
+    // 复制前台缓冲区后立即释放，不在临界区内编码输出
+    uint32_t frame[NUM_LEDS];
+    portENTER_CRITICAL(&bufferLock);
+    frames.copyFront(frame);
+    portEXIT_CRITICAL(&bufferLock);
+    
+    // 与已发送的画面比较 (清空后重绘相同内容的像素不算变化)
+    bool hasChanges = frames.applyShown(frame);
+    
+    // 只有在有变化时才发送，RMT在后台发送整帧，这里不等待
     if (hasChanges || needsFullUpdate) {
-        strip.show();
+        output.write(frames.shown(), NUM_LEDS, colorLut.table());
         needsFullUpdate = false;
     }
+    
+    if (stripMutex != NULL) {
+        xSemaphoreGive(stripMutex);
+    }
 }
 
 void LEDMatrix::clear() {
-    for (int i = 0; i < NUM_LEDS; i++) {
-        if (pixelCache[i] != 0) {
-            pixelCache[i] = 0;
-            pixelChanged[i] = true;
-        }
-    }
-    // 不直接调用strip.show()，由调用方决定何时更新显示
+    frames.clear();
+    // 不直接刷新，由调用方决定何时提交
 }
 
 void LEDMatrix::clearAll() {
     clear();
-    update(); // 显式调用update以更新显示
+    present(); // 显式提交以更新显示
 }
 
 void LEDMatrix::setPixel(int x, int y, uint32_t color) {
@@ -170,77 +95,37 @@ void LEDMatrix::setPixel(int x, int y, uint32_t color) {
 
 void LEDMatrix::setPixel(int index, uint32_t color) {
     if(index >= 0 && index < NUM_LEDS) {
-        if (pixelCache[index] != color) {
-            pixelCache[index] = color;
-            pixelChanged[index] = true;
-            // 不直接调用strip.setPixelColor，而是在update时统一处理
-        }
+        // 只写后台缓冲区，在present时统一比较并提交
+        frames.setPixel(index, color);
     }
 }
 
 int LEDMatrix::getIndex(int x, int y) {
     if(x >= 0 && x < 8 && y >= 0 && y < 8) {
-        // 偶数行（0,2,4,6）从右到左
-        if(y % 2 == 0) {
-            return y * 8 + (7 - x);  // 从右到左
-        } else {
-            return y * 8 + x;        // 从左到右
-        }
+        return LED_INDEX[y][x];
     }
     return 0;
 }
 
-void LEDMatrix::showDigit(int digit, int xOffset, uint32_t color) {
-    if(digit < 0 || digit > 9) return;
-    
-    for(int y = 0; y < 8; y++) {
-        for(int x = 0; x < 4; x++) {
-            if(DIGITS[digit][y][x]) {
-                setPixel(x + xOffset, y, color);
-            }
-        }
-    }
-}
-
-void LEDMatrix::showNumber(int number, uint32_t color) {
-    // 先将所有LED设为关闭状态，不调用clear()以避免立即刷新
-    for (int y = 0; y < 8; y++) {
-        for (int x = 0; x < 8; x++) {
-            setPixel(x, y, 0);  // 设置为关闭状态
-        }
-    }
-    
-    if(number >= 0 && number <= 99) {
-        if(number < 10) {
-            // 个位数，显示在中间
-            showDigit(number, 2, color);
-        } else {
-            // 两位数，分别显示在左右两边
-            showDigit(number / 10, 0, color);
-            showDigit(number % 10, 4, color);
-        }
-    }
-    update();  // 只在最后更新一次显示
+// 等待LED数据发送完成 (需要确保画面已显示时使用)
+bool LEDMatrix::waitForOutput(TickType_t timeout) {
+    return output.wait(timeout);
 }
 
-void LEDMatrix::showTwoNumbers(int leftNum, int rightNum, uint32_t leftColor, uint32_t rightColor) {
-    // 先将所有LED设为关闭状态，不调用clear()
-    for (int y = 0; y < 8; y++) {
-        for (int x = 0; x < 8; x++) {
-            setPixel(x, y, 0);  // 设置为关闭状态
-        }
+// 设置亮度 - 画面保持原始精度，只重建查找表，然后重新发送整帧
+void LEDMatrix::setBrightness(uint8_t value) {
+    // 与编码输出互斥，避免重建正在被读取的表
+    if (stripMutex != NULL) {
+        xSemaphoreTake(stripMutex, portMAX_DELAY);
     }
-    
-    if(leftNum >= 0 && leftNum <= 9) {
-        showDigit(leftNum, 0, leftColor);  // 左边数字使用指定颜色
-    }
-    if(rightNum >= 0 && rightNum <= 9) {
-        showDigit(rightNum, 4, rightColor);   // 右边数字使用指定颜色
+    colorLut.setBrightness(value);
+    needsFullUpdate = true;
+    if (stripMutex != NULL) {
+        xSemaphoreGive(stripMutex);
     }
-    update();  // 只在最后更新一次显示
+    update();
 }
 
-// 获取NeoPixel对象的引用，用于调整亮度
-Adafruit_NeoPixel& LEDMatrix::getStrip() {
-    return strip;
+uint8_t LEDMatrix::getBrightness() const {
+    return colorLut.brightness();
 } 
\ No newline at end of file
@@ -1,11 +1,15 @@
 #pragma once
 
-#include <Adafruit_NeoPixel.h>
 #include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "WS2812Output.h"
+#include "ColorLut.h"
+#include "LEDFrameBuffer.h"
 
 // LED配置
-#define NUM_LEDS    64      // 8x8矩阵
-#define LED_PIN     0       // LED数据引脚
+#define NUM_LEDS    LED_FRAME_PIXELS  // 8x8矩阵
+#define LED_PIN     0       // LED数据引脚 (与麦克风PDM时钟共用GPIO0，麦克风工作期间LED不可用)
 #define BRIGHTNESS  51      // 亮度20% (255 * 0.2 ≈ 51)
 
 // 定义颜色
@@ -14,32 +18,38 @@
 #define COLOR_BLUE   0x0000FF
 #define COLOR_YELLOW 0xFFFF00
 
+// LED矩阵 - 双缓冲
+// 绘制操作只写后台缓冲区，present()在锁内交换前后台缓冲区并刷新显示，
+// update()只读取前台缓冲区，因此不会显示绘制到一半的画面。
+// 一帧只有一个绘制者: clear/setPixel/present必须都在绘制任务 (ModeTask) 中调用，后台缓冲区不加锁;
+// update()与setBrightness()只读前台缓冲区，可以在其他任务中调用。
 class LEDMatrix {
 public:
     LEDMatrix();
     void begin();
-    void update();
+    void present();   // 交换前后台缓冲区并刷新显示
+    void update();    // 把前台缓冲区刷新到LED (异步发送，立即返回)
+    bool waitForOutput(TickType_t timeout = portMAX_DELAY);  // 等待LED数据发送完成
     void clear();
     void clearAll();
     
-    // 像素操作
+    // 像素操作 (写入后台缓冲区)
     void setPixel(int x, int y, uint32_t color);
     void setPixel(int index, uint32_t color);
     
-    // 数字显示相关方法
-    void showNumber(int number, uint32_t color = COLOR_GREEN);  // 默认绿色
-    void showTwoNumbers(int leftNum, int rightNum, uint32_t leftColor = COLOR_BLUE, uint32_t rightColor = COLOR_YELLOW);
-    
-    // 获取NeoPixel对象引用（用于调整亮度）
-    Adafruit_NeoPixel& getStrip();
+    // 亮度 (0-255)，只切换查找表，然后重新发送当前画面
+    void setBrightness(uint8_t value);
+    uint8_t getBrightness() const;
 
 private:
-    Adafruit_NeoPixel strip;
+    WS2812Output output;
     int getIndex(int x, int y);  // 添加坐标转换方法
-    void showDigit(int digit, int xOffset, uint32_t color);
     
-    // 像素缓存
-    uint32_t pixelCache[NUM_LEDS];    // 存储每个像素的当前颜色
-    bool pixelChanged[NUM_LEDS];      // 标记每个像素是否发生变化
+    // 前后台缓冲区与已发送到LED的颜色
+    LEDFrameBuffer frames;
+    portMUX_TYPE bufferLock;          // 只保护缓冲区交换与读取前台缓冲区，不保护后台绘制
+    
     bool needsFullUpdate;             // 是否需要完全更新
+    ColorLut colorLut;                // 伽马 x 亮度查找表，编码输出时应用
+    SemaphoreHandle_t stripMutex;     // 多个任务刷新显示时保护输出
 }; 
\ No newline at end of file
@@ -0,0 +1,197 @@
+#include "LcdDigitRenderer.h"
+#include <esp_heap_caps.h>
+
+LcdDigitRenderer::LcdDigitRenderer() {
+    memset(_glyphs, 0, sizeof(_glyphs));
+    _span = NULL;
+    _ready = false;
+    _x = 0;
+    _y = 0;
+    _count = 0;
+    memset(_widths, 0, sizeof(_widths));
+    memset(_offsets, 0, sizeof(_offsets));
+    memset(_shown, -1, sizeof(_shown));
+    _shownColor = 0;
+    _shownBg = 0;
+    _invalid = true;
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+LcdDigitRenderer::~LcdDigitRenderer() {
+    if (_span != NULL) {
+        M5.Display.waitDMA();
+        heap_caps_free(_span);
+    }
+}
+
+// 用1位画布渲染每个字符，读回像素打包为字形缓存
+bool LcdDigitRenderer::begin() {
+    if (_ready) return true;
+
+    M5Canvas canvas(&M5.Display);
+    canvas.setColorDepth(1);
+    if (!canvas.createSprite(LCD_GLYPH_W, LCD_GLYPH_H)) {
+        Serial.println("LcdDigitRenderer: 创建字形画布失败");
+        return false;
+    }
+    canvas.setTextSize(LCD_DIGIT_TEXT_SIZE);
+
+    const char* chars = LCD_GLYPH_CHARS;
+    for (int g = 0; g < LCD_GLYPH_COUNT; g++) {
+        canvas.fillSprite(0);
+        canvas.setTextColor(1);
+        canvas.setCursor(0, 0);
+        canvas.print(chars[g]);
+
+        uint8_t* glyph = _glyphs[g];
+        memset(glyph, 0, GLYPH_ROW_BYTES * LCD_GLYPH_H);
+        for (int y = 0; y < LCD_GLYPH_H; y++) {
+            for (int x = 0; x < LCD_GLYPH_W; x++) {
+                if (canvas.readPixel(x, y) != 0) {
+                    glyph[y * GLYPH_ROW_BYTES + x / 8] |= 0x80 >> (x % 8);
+                }
+            }
+        }
+    }
+    canvas.deleteSprite();
+
+    // 一整行单元的缓冲区，必须位于可DMA的内存中
+    _span = (uint16_t*)heap_caps_malloc(LCD_MAX_CELLS * LCD_GLYPH_W * LCD_GLYPH_H * sizeof(uint16_t),
+                                        MALLOC_CAP_DMA);
+    if (_span == NULL) {
+        Serial.println("LcdDigitRenderer: 分配DMA缓冲区失败，改为直接绘制");
+        return false;
+    }
+
+    _ready = true;
+    _invalid = true;
+    Serial.println("LcdDigitRenderer: 字形缓存已生成");
+    return true;
+}
+
+void LcdDigitRenderer::setLayout(int x, int y, const uint8_t* widths, int count) {
+    if (count > LCD_MAX_CELLS) count = LCD_MAX_CELLS;
+    _x = x;
+    _y = y;
+    _count = count;
+
+    int offset = 0;
+    for (int i = 0; i < count; i++) {
+        _widths[i] = widths[i] < LCD_GLYPH_W ? widths[i] : LCD_GLYPH_W;
+        _offsets[i] = offset;
+        offset += _widths[i];
+    }
+    _invalid = true;
+}
+
+void LcdDigitRenderer::invalidate() {
+    _invalid = true;
+}
+
+int LcdDigitRenderer::glyphIndex(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c == '.') return 10;
+    return 11;  // 其他字符显示为空格
+}
+
+// 把一个单元的字形展开为RGB565像素
+void LcdDigitRenderer::renderCell(int cell, int glyph, uint16_t* dst, int stride,
+                                  uint16_t fg, uint16_t bg) const {
+    const uint8_t* bits = _glyphs[glyph];
+    int width = _widths[cell];
+    for (int y = 0; y < LCD_GLYPH_H; y++) {
+        const uint8_t* row = bits + y * GLYPH_ROW_BYTES;
+        uint16_t* out = dst + y * stride;
+        for (int x = 0; x < width; x++) {
+            out[x] = (row[x / 8] & (0x80 >> (x % 8))) ? fg : bg;
+        }
+    }
+}
+
+uint32_t LcdDigitRenderer::draw(const char* text, uint16_t color, uint16_t bgColor) {
+    if (!_ready) {
+        return drawFallback(text, color, bgColor);
+    }
+
+    // 找出内容变化的单元范围
+    bool colorChanged = _invalid || color != _shownColor || bgColor != _shownBg;
+    int first = -1;
+    int last = -1;
+    int8_t glyphs[LCD_MAX_CELLS];
+    size_t length = strlen(text);
+    for (int i = 0; i < _count; i++) {
+        glyphs[i] = glyphIndex(i < (int)length ? text[i] : ' ');
+        if (colorChanged || glyphs[i] != _shown[i]) {
+            if (first < 0) first = i;
+            last = i;
+        }
+    }
+
+    _stats.frames++;
+    if (first < 0) {
+        _stats.frameBytes = 0;
+        return 0;
+    }
+    if (_invalid) {
+        _stats.fullRedraws++;
+    }
+
+    // 上一帧的DMA传输结束后才能改写缓冲区
+    M5.Display.waitDMA();
+
+    // 屏幕使用大端RGB565
+    uint16_t fg = (color >> 8) | (color << 8);
+    uint16_t bg = (bgColor >> 8) | (bgColor << 8);
+    int spanX = _offsets[first];
+    int spanW = _offsets[last] + _widths[last] - spanX;
+    for (int i = first; i <= last; i++) {
+        renderCell(i, glyphs[i], _span + (_offsets[i] - spanX), spanW, fg, bg);
+        _shown[i] = glyphs[i];
+    }
+
+    M5.Display.pushImageDMA(_x + spanX, _y, spanW, LCD_GLYPH_H, (const lgfx::swap565_t*)_span);
+
+    _shownColor = color;
+    _shownBg = bgColor;
+    _invalid = false;
+
+    uint32_t bytes = spanW * LCD_GLYPH_H * sizeof(uint16_t);
+    _stats.frameBytes = bytes;
+    _stats.totalBytes += bytes;
+    return bytes;
+}
+
+// 没有字形缓存时直接用文本绘制每个变化的单元
+uint32_t LcdDigitRenderer::drawFallback(const char* text, uint16_t color, uint16_t bgColor) {
+    bool colorChanged = _invalid || color != _shownColor || bgColor != _shownBg;
+    size_t length = strlen(text);
+    uint32_t bytes = 0;
+
+    M5.Display.setTextSize(LCD_DIGIT_TEXT_SIZE);
+    M5.Display.setTextColor(color, bgColor);
+    for (int i = 0; i < _count; i++) {
+        char c = i < (int)length ? text[i] : ' ';
+        int8_t glyph = glyphIndex(c);
+        if (!colorChanged && glyph == _shown[i]) continue;
+
+        M5.Display.setClipRect(_x + _offsets[i], _y, _widths[i], LCD_GLYPH_H);
+        M5.Display.setCursor(_x + _offsets[i], _y);
+        M5.Display.print(c);
+        M5.Display.clearClipRect();
+        _shown[i] = glyph;
+        bytes += LCD_GLYPH_W * LCD_GLYPH_H * sizeof(uint16_t);
+    }
+
+    _stats.frames++;
+    if (_invalid) _stats.fullRedraws++;
+    _stats.frameBytes = bytes;
+    _stats.totalBytes += bytes;
+    _shownColor = color;
+    _shownBg = bgColor;
+    _invalid = false;
+    return bytes;
+}
+
+void LcdDigitRenderer::getStats(LcdRenderStats* stats) const {
+    *stats = _stats;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <M5Unified.h>
+
+// 字符单元尺寸 (默认6x8字体放大6倍)
+#define LCD_DIGIT_TEXT_SIZE 6
+#define LCD_GLYPH_W         36
+#define LCD_GLYPH_H         48
+#define LCD_MAX_CELLS       6
+
+// 缓存的字符: 数字、小数点和空格
+#define LCD_GLYPH_CHARS     "0123456789. "
+#define LCD_GLYPH_COUNT     12
+
+// LCD刷新统计
+struct LcdRenderStats {
+    uint32_t frames;        // draw()调用次数
+    uint32_t frameBytes;    // 最近一帧通过SPI发送的像素字节数
+    uint32_t totalBytes;    // 累计发送的像素字节数
+    uint32_t fullRedraws;   // 整行重绘次数
+};
+
+// 大号数字的LCD渲染器
+// 开始时把每个字符渲染成1位字形缓存；每帧只比较各字符单元，
+// 把从第一个到最后一个变化单元的区域展开到连续缓冲区，用一次DMA传输推送到屏幕。
+class LcdDigitRenderer {
+public:
+    LcdDigitRenderer();
+    ~LcdDigitRenderer();
+
+    // 生成字形缓存并分配DMA缓冲区 (需在显示屏初始化后调用)
+    bool begin();
+
+    // 设置单元布局: 从(x, y)开始依次排列，每个单元宽widths[i] (不超过字形宽度，超出部分被裁掉)
+    void setLayout(int x, int y, const uint8_t* widths, int count);
+
+    // 下一帧重绘全部单元 (屏幕被其他代码覆盖后调用)
+    void invalidate();
+    bool isInvalid() const { return _invalid; }
+
+    // 绘制文本，每个字符占一个单元，返回本帧发送的字节数
+    uint32_t draw(const char* text, uint16_t color, uint16_t bgColor);
+
+    void getStats(LcdRenderStats* stats) const;
+
+private:
+    static int glyphIndex(char c);
+    void renderCell(int cell, int glyph, uint16_t* dst, int stride, uint16_t fg, uint16_t bg) const;
+    uint32_t drawFallback(const char* text, uint16_t color, uint16_t bgColor);
+
+    // 1位字形缓存，每行按位打包
+    static const int GLYPH_ROW_BYTES = (LCD_GLYPH_W + 7) / 8;
+    uint8_t _glyphs[LCD_GLYPH_COUNT][GLYPH_ROW_BYTES * LCD_GLYPH_H];
+
+    uint16_t* _span;        // 推送用的连续缓冲区 (屏幕字节序的RGB565)
+    bool _ready;
+
+    int _x, _y;
+    int _count;
+    uint8_t _widths[LCD_MAX_CELLS];
+    int _offsets[LCD_MAX_CELLS];        // 单元相对_x的起点
+
+    // 屏幕上当前显示的内容
+    int8_t _shown[LCD_MAX_CELLS];
+    uint16_t _shownColor;
+    uint16_t _shownBg;
+    bool _invalid;
+
+    LcdRenderStats _stats;
+};
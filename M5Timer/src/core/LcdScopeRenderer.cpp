@@ -0,0 +1,140 @@
+#include "LcdScopeRenderer.h"
+#include <esp_heap_caps.h>
+
+LcdScopeRenderer::LcdScopeRenderer() {
+    _pixels = NULL;
+    _ready = false;
+    _x = 0;
+    _y = 0;
+    _width = 0;
+    _height = 0;
+    memset(_top, 0, sizeof(_top));
+    memset(_bottom, 0, sizeof(_bottom));
+    memset(_shownTop, 0, sizeof(_shownTop));
+    memset(_shownBottom, 0, sizeof(_shownBottom));
+    _shownBg = 0;
+    _invalid = true;
+}
+
+LcdScopeRenderer::~LcdScopeRenderer() {
+    if (_pixels != NULL) {
+        M5.Display.waitDMA();
+        heap_caps_free(_pixels);
+    }
+}
+
+bool LcdScopeRenderer::begin(int x, int y, int width, int height) {
+    if (width > LCD_SCOPE_MAX_W) width = LCD_SCOPE_MAX_W;
+    if (height > LCD_SCOPE_MAX_H) height = LCD_SCOPE_MAX_H;
+
+    // 已分配的缓冲区不够大时重新分配
+    if (_pixels != NULL && width * height > _width * _height) {
+        M5.Display.waitDMA();
+        heap_caps_free(_pixels);
+        _pixels = NULL;
+    }
+    _x = x;
+    _y = y;
+    _width = width;
+    _height = height;
+    _invalid = true;
+
+    if (_pixels == NULL) {
+        // 整个区域的缓冲区，必须位于可DMA的内存中
+        _pixels = (uint16_t*)heap_caps_malloc(width * height * sizeof(uint16_t), MALLOC_CAP_DMA);
+        if (_pixels == NULL) {
+            Serial.println("LcdScopeRenderer: 分配DMA缓冲区失败");
+            _ready = false;
+            return false;
+        }
+    }
+
+    _ready = true;
+    return true;
+}
+
+void LcdScopeRenderer::invalidate() {
+    _invalid = true;
+}
+
+// 把采样均分到各列，求每列的最小/最大行号，并向前一列的末尾采样延伸使波形连续
+void LcdScopeRenderer::computeSpans(const int16_t* samples, int count, int gain) {
+    // 行号 = 中线 + 采样 * gain * 半高 / 32768，每个采样一次乘法和移位
+    int32_t mid = _height / 2;
+    int32_t scale = gain * (_height / 2);
+    int32_t maxRow = _height - 1;
+
+    int32_t previous = -1;
+    int sample = 0;
+    for (int col = 0; col < _width; col++) {
+        int end = (col + 1) * count / _width;
+        if (end <= sample) end = sample + 1;
+
+        int32_t lo = maxRow;
+        int32_t hi = 0;
+        int32_t row = mid;
+        for (; sample < end && sample < count; sample++) {
+            row = mid + (((int32_t)samples[sample] * scale) >> 15);
+            if (row < 0) row = 0;
+            if (row > maxRow) row = maxRow;
+            if (row < lo) lo = row;
+            if (row > hi) hi = row;
+        }
+        if (lo > hi) {
+            lo = hi = row;
+        }
+
+        // 与前一列相连
+        if (previous >= 0) {
+            if (previous < lo) lo = previous;
+            if (previous > hi) hi = previous;
+        }
+        previous = row;
+
+        _top[col] = (uint8_t)lo;
+        _bottom[col] = (uint8_t)hi;
+    }
+}
+
+void LcdScopeRenderer::draw(const int16_t* samples, int count, int gain, uint16_t color, uint16_t bgColor) {
+    if (!_ready || count <= 0) return;
+
+    computeSpans(samples, count, gain);
+
+    // 上一帧的DMA传输结束后才能改写缓冲区
+    M5.Display.waitDMA();
+
+    // 屏幕使用大端RGB565
+    uint16_t fg = (color >> 8) | (color << 8);
+    uint16_t bg = (bgColor >> 8) | (bgColor << 8);
+
+    if (_invalid || bgColor != _shownBg) {
+        // 整个区域填充背景
+        int total = _width * _height;
+        for (int i = 0; i < total; i++) {
+            _pixels[i] = bg;
+        }
+    } else {
+        // 只擦除上一帧的线段
+        for (int col = 0; col < _width; col++) {
+            uint16_t* p = _pixels + _shownTop[col] * _width + col;
+            for (int row = _shownTop[col]; row <= _shownBottom[col]; row++, p += _width) {
+                *p = bg;
+            }
+        }
+    }
+
+    // 画新线段
+    for (int col = 0; col < _width; col++) {
+        uint16_t* p = _pixels + _top[col] * _width + col;
+        for (int row = _top[col]; row <= _bottom[col]; row++, p += _width) {
+            *p = fg;
+        }
+    }
+    memcpy(_shownTop, _top, _width);
+    memcpy(_shownBottom, _bottom, _width);
+    _shownBg = bgColor;
+    _invalid = false;
+
+    M5.Display.pushImageDMA(_x, _y, _width, _height, (const lgfx::swap565_t*)_pixels);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <M5Unified.h>
+
+// 示波器区域的最大尺寸
+#define LCD_SCOPE_MAX_W     240
+#define LCD_SCOPE_MAX_H     64
+
+// 音频波形 (示波器) 的LCD渲染器
+// 每帧把采样按列压缩为最小/最大值，并与前一列相连成竖直线段；
+// 在屏幕字节序的像素缓冲区中只擦除上一帧的线段再画新线段，整块区域用一次DMA传输推送。
+class LcdScopeRenderer {
+public:
+    LcdScopeRenderer();
+    ~LcdScopeRenderer();
+
+    // 设置区域并分配DMA缓冲区 (需在显示屏初始化后调用)
+    bool begin(int x, int y, int width, int height);
+
+    // 下一帧清空整个区域 (屏幕被其他代码覆盖后调用)
+    void invalidate();
+
+    // 绘制一帧采样; gain: 幅度放大倍数，满幅的gain分之一对应半个区域高度
+    void draw(const int16_t* samples, int count, int gain, uint16_t color, uint16_t bgColor);
+
+private:
+    void computeSpans(const int16_t* samples, int count, int gain);
+
+    uint16_t* _pixels;      // 推送用的像素缓冲区 (屏幕字节序的RGB565)
+    bool _ready;
+
+    int _x, _y;
+    int _width, _height;
+
+    // 每列的线段 (行号，包含两端)
+    uint8_t _top[LCD_SCOPE_MAX_W];
+    uint8_t _bottom[LCD_SCOPE_MAX_W];
+
+    // 缓冲区中当前画着的线段
+    uint8_t _shownTop[LCD_SCOPE_MAX_W];
+    uint8_t _shownBottom[LCD_SCOPE_MAX_W];
+    uint16_t _shownBg;
+    bool _invalid;
+};
@@ -0,0 +1,60 @@
+#include "MatchClock.h"
+
+MatchClock::MatchClock(uint32_t durationMs) {
+    _durationUs = (int64_t)durationMs * 1000;
+    reset();
+}
+
+void MatchClock::setDurationMs(uint32_t durationMs) {
+    _durationUs = (int64_t)durationMs * 1000;
+}
+
+void MatchClock::start(int64_t nowUs) {
+    _startUs = nowUs;
+    _pausedAtUs = 0;
+    _running = true;
+    _paused = false;
+}
+
+void MatchClock::pause(int64_t nowUs) {
+    if (!_running || _paused) return;
+    _pausedAtUs = nowUs;
+    _paused = true;
+}
+
+// 继续计时 - 起点后移暂停的时长
+void MatchClock::resume(int64_t nowUs) {
+    if (!_running || !_paused) return;
+    _startUs += nowUs - _pausedAtUs;
+    _paused = false;
+}
+
+void MatchClock::reset() {
+    _startUs = 0;
+    _pausedAtUs = 0;
+    _running = false;
+    _paused = false;
+}
+
+ClockSnapshot MatchClock::snapshot(int64_t nowUs) const {
+    ClockSnapshot snap;
+    snap.nowUs = nowUs;
+    snap.running = _running;
+    snap.paused = _paused;
+
+    int64_t elapsed = 0;
+    if (_running) {
+        elapsed = (_paused ? _pausedAtUs : nowUs) - _startUs;
+        if (elapsed < 0) elapsed = 0;
+    }
+    if (elapsed > _durationUs) elapsed = _durationUs;
+
+    int64_t remaining = _durationUs - elapsed;
+    snap.elapsedUs = elapsed;
+    snap.remainingUs = remaining;
+    snap.seconds = (int32_t)(remaining / 1000000);
+    snap.hundredths = (int32_t)(remaining % 1000000 / 10000);
+    snap.ceilSeconds = (int32_t)((remaining + 999999) / 1000000);
+    snap.finished = _running && remaining == 0;
+    return snap;
+}
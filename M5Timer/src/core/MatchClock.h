@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdint.h>
+
+// 某一时刻的计时状态 (不可变快照)
+// 每帧采样一次，LED、LCD和提示判断都使用同一个快照，不会相差一帧。
+struct ClockSnapshot {
+    int64_t nowUs;          // 采样时刻 (esp_timer时间)
+    int64_t elapsedUs;      // 已计时时间，不含暂停
+    int64_t remainingUs;    // 剩余时间，不小于0
+    int32_t seconds;        // 剩余整秒数 (向下取整)
+    int32_t hundredths;     // 剩余不足一秒的部分，单位1/100秒 (向下取整)
+    int32_t ceilSeconds;    // 剩余秒数 (向上取整)
+    bool running;           // 已开始且未重置
+    bool paused;
+    bool finished;          // 剩余时间已到0
+};
+
+// 单调计时器
+// 全部使用64位微秒整数运算，不受32位millis()回绕和浮点误差影响。
+// 不直接读取时钟，由调用方传入当前时刻，便于在主机上测试。
+class MatchClock {
+public:
+    MatchClock(uint32_t durationMs);
+
+    void setDurationMs(uint32_t durationMs);
+    uint32_t durationMs() const { return (uint32_t)(_durationUs / 1000); }
+
+    void start(int64_t nowUs);
+    void pause(int64_t nowUs);
+    void resume(int64_t nowUs);
+    void reset();
+
+    bool isRunning() const { return _running; }
+    bool isPaused() const { return _paused; }
+
+    // 扣除暂停时间后的计时起点 (已计时时间 = 当前时刻 - 起点)
+    int64_t anchorUs() const { return _startUs; }
+
+    ClockSnapshot snapshot(int64_t nowUs) const;
+
+private:
+    int64_t _durationUs;
+    int64_t _startUs;
+    int64_t _pausedAtUs;
+    bool _running;
+    bool _paused;
+};
@@ -0,0 +1,128 @@
+#include "MatchProfile.h"
+#include <Preferences.h>
+
+// NVS中配置的格式版本，结构变化时递增
+#define MATCH_PROFILE_VERSION 1
+#define MATCH_PROFILE_NAMESPACE "profiles"
+
+// 内置配置 - 提示点相对结束时刻保持一致:
+// 计时开始降低亮度2秒，剩余36秒与26秒提前播放提示音，剩余1秒提前播放结束音并恢复亮度
+static constexpr MatchProfile DEFAULT_PROFILES[] = {
+    {"60s", 60000, 3000, 10, 4, {
+        {0,     0, CUE_LED_DIM,     2000},
+        {24000, 3, CUE_LED_DIM,     2000},
+        {34000, 3, CUE_LED_DIM,     2000},
+        {59000, 4, CUE_LED_RESTORE, 0}
+    }},
+    {"120s", 120000, 3000, 10, 4, {
+        {0,      0, CUE_LED_DIM,     2000},
+        {84000,  3, CUE_LED_DIM,     2000},
+        {94000,  3, CUE_LED_DIM,     2000},
+        {119000, 4, CUE_LED_RESTORE, 0}
+    }},
+    {"30s", 30000, 3000, 5, 3, {
+        {0,     0, CUE_LED_DIM,     2000},
+        {4000,  3, CUE_LED_DIM,     2000},
+        {29000, 4, CUE_LED_RESTORE, 0}
+    }}
+};
+
+#define DEFAULT_PROFILE_COUNT (sizeof(DEFAULT_PROFILES) / sizeof(DEFAULT_PROFILES[0]))
+
+// 内置配置的时长必须能在LED矩阵上显示
+static constexpr bool defaultDurationsFit(size_t i) {
+    return i >= DEFAULT_PROFILE_COUNT ||
+           (DEFAULT_PROFILES[i].durationMs <= MATCH_PROFILE_MAX_DURATION_MS && defaultDurationsFit(i + 1));
+}
+static_assert(defaultDurationsFit(0), "default profile duration exceeds MATCH_PROFILE_MAX_DURATION_MS");
+
+MatchProfileStore::MatchProfileStore() {
+    loadDefaults();
+    _active = 0;
+}
+
+void MatchProfileStore::loadDefaults() {
+    _count = DEFAULT_PROFILE_COUNT;
+    memset(_profiles, 0, sizeof(_profiles));
+    memcpy(_profiles, DEFAULT_PROFILES, sizeof(DEFAULT_PROFILES));
+}
+
+// 时长非0且能在LED矩阵上显示，倒计时不长于计时，提示点在计时范围内并按升序排列
+// (CueScheduler按升序依次布置定时器)
+bool MatchProfileStore::isValid(const MatchProfile& profile) {
+    if (profile.durationMs == 0 || profile.durationMs > MATCH_PROFILE_MAX_DURATION_MS) return false;
+    if (profile.preRollMs > profile.durationMs) return false;
+    if (profile.cueCount > MATCH_PROFILE_MAX_CUES) return false;
+    for (int i = 0; i < profile.cueCount; i++) {
+        if (profile.cues[i].offsetMs > profile.durationMs) return false;
+        if (i > 0 && profile.cues[i].offsetMs < profile.cues[i - 1].offsetMs) return false;
+    }
+    return true;
+}
+
+// 从NVS读取全部配置
+void MatchProfileStore::load() {
+    Preferences preferences;
+    preferences.begin(MATCH_PROFILE_NAMESPACE, true);
+    uint8_t version = preferences.getUChar("version", 0);
+    int count = preferences.getUChar("count", 0);
+    int active = preferences.getUChar("active", 0);
+
+    bool valid = version == MATCH_PROFILE_VERSION && count > 0 && count <= MATCH_PROFILE_MAX;
+    for (int i = 0; valid && i < count; i++) {
+        char key[4] = {'p', (char)('0' + i), 0};
+        if (preferences.getBytes(key, &_profiles[i], sizeof(MatchProfile)) != sizeof(MatchProfile)) {
+            valid = false;
+        }
+    }
+    preferences.end();
+
+    // 检查读入的数据，损坏或不合理的配置整表换回内置配置
+    for (int i = 0; valid && i < count; i++) {
+        _profiles[i].name[MATCH_PROFILE_NAME_LEN - 1] = '\0';
+        valid = isValid(_profiles[i]);
+    }
+
+    if (!valid) {
+        Serial.println("MatchProfile: NVS中没有有效配置，写入内置配置");
+        loadDefaults();
+        _active = 0;
+        save();
+        return;
+    }
+
+    _count = count;
+    _active = active < count ? active : 0;
+    Serial.println("MatchProfile: 已读取" + String(_count) + "个配置，当前 " + String(_profiles[_active].name));
+}
+
+// 把全部配置写入NVS
+bool MatchProfileStore::save() {
+    Preferences preferences;
+    if (!preferences.begin(MATCH_PROFILE_NAMESPACE, false)) {
+        Serial.println("MatchProfile: 打开NVS失败");
+        return false;
+    }
+
+    bool ok = true;
+    for (int i = 0; i < _count; i++) {
+        char key[4] = {'p', (char)('0' + i), 0};
+        ok = ok && preferences.putBytes(key, &_profiles[i], sizeof(MatchProfile)) == sizeof(MatchProfile);
+    }
+    preferences.putUChar("count", _count);
+    preferences.putUChar("active", _active);
+    preferences.putUChar("version", ok ? MATCH_PROFILE_VERSION : 0);
+    preferences.end();
+    return ok;
+}
+
+// 选择配置，只保存下标
+void MatchProfileStore::setActive(int index) {
+    if (index < 0 || index >= _count || index == _active) return;
+    _active = index;
+
+    Preferences preferences;
+    preferences.begin(MATCH_PROFILE_NAMESPACE, false);
+    preferences.putUChar("active", _active);
+    preferences.end();
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <Arduino.h>
+#include "CueScheduler.h"
+#include "Glyphs.h"
+
+// 配置数量与每个配置的提示数上限
+#define MATCH_PROFILE_MAX       4
+#define MATCH_PROFILE_MAX_CUES  8
+#define MATCH_PROFILE_NAME_LEN  12
+
+// 计时时长上限: LED矩阵上三位秒数只有百位为1时才放得下
+#define MATCH_PROFILE_MAX_DURATION_MS  (GLYPH_MAX_NUMBER * 1000UL)
+
+// 比赛配置: 计时时长、开始前倒计时、提示表与警示阈值
+struct MatchProfile {
+    char name[MATCH_PROFILE_NAME_LEN];
+    uint32_t durationMs;      // 计时时长
+    uint32_t preRollMs;       // 开始前倒计时时长
+    uint8_t warningSeconds;   // 最后几秒进入警示 (LCD红色，LED闪烁边框)
+    uint8_t cueCount;
+    Cue cues[MATCH_PROFILE_MAX_CUES];  // 相对计时开始，按offsetMs升序
+};
+
+// 比赛配置表
+// 开机时从NVS一次性读入固定数组，之后只按下标访问，切换配置不需要读写存储
+// (只保存当前选中的下标)。NVS中没有配置或格式版本不符时写入内置配置。
+class MatchProfileStore {
+public:
+    MatchProfileStore();
+
+    void load();
+    bool save();
+
+    int count() const { return _count; }
+    const MatchProfile& get(int index) const { return _profiles[index]; }
+
+    int activeIndex() const { return _active; }
+    const MatchProfile& active() const { return _profiles[_active]; }
+    void setActive(int index);
+
+    // 检查配置是否可以使用
+    static bool isValid(const MatchProfile& profile);
+
+private:
+    void loadDefaults();
+
+    MatchProfile _profiles[MATCH_PROFILE_MAX];
+    int _count;
+    int _active;
+};
@@ -3,6 +3,12 @@
 #include <Arduino.h>
 #include "types.h"
 
+// 默认刷新间隔 (毫秒)
+#define MODE_DEFAULT_TICK_MS 50
+
+// 不需要定时刷新，只在事件到达时唤醒
+#define MODE_NO_DEADLINE     0xFFFFFFFF
+
 class Mode {
 public:
     Mode(const char* name) : name(name) {}
@@ -13,6 +19,12 @@ public:
     virtual void exit() = 0;
     virtual void handleEvent(EventType event) = 0;
     
+    // ModeTask传入完整的事件消息; 需要事件发生时刻 (如按键边沿) 的模式重写此方法
+    virtual void handleEventMessage(const EventMessage& message) { handleEvent(message.type); }
+    
+    // 距离下一次需要调用update()的时间 (毫秒)，没有动画时返回MODE_NO_DEADLINE
+    virtual uint32_t nextDeadline() { return MODE_DEFAULT_TICK_MS; }
+    
     const char* getName() const { return name; }
     
 protected:
@@ -0,0 +1,63 @@
+#include "ModeWorker.h"
+
+ModeWorker::ModeWorker(const char* name, uint32_t stackSize, UBaseType_t priority, BaseType_t core) {
+    _name = name;
+    _stackSize = stackSize;
+    _priority = priority;
+    _core = core;
+    _step = NULL;
+    _arg = NULL;
+    _handle = NULL;
+    _stopRequested = false;
+    _done = xSemaphoreCreateBinaryStatic(&_doneBuffer);
+    _stackHighWater = 0;
+}
+
+ModeWorker::~ModeWorker() {
+    stop();
+}
+
+bool ModeWorker::start(StepFunction step, void* arg) {
+    if (_handle != NULL) {
+        Serial.println("ModeWorker: " + String(_name) + " 已在运行");
+        return false;
+    }
+
+    _step = step;
+    _arg = arg;
+    _stopRequested = false;
+    xSemaphoreTake(_done, 0);  // 清除上一次的退出信号
+
+    if (xTaskCreatePinnedToCore(taskEntry, _name, _stackSize, this, _priority, &_handle, _core) != pdPASS) {
+        Serial.println("ModeWorker: 创建任务失败 " + String(_name));
+        _handle = NULL;
+        return false;
+    }
+    return true;
+}
+
+bool ModeWorker::stop(uint32_t timeoutMs) {
+    if (_handle == NULL) return true;
+
+    _stopRequested = true;
+    if (xSemaphoreTake(_done, pdMS_TO_TICKS(timeoutMs)) != pdTRUE) {
+        Serial.println("ModeWorker: 等待任务退出超时 " + String(_name));
+        return false;
+    }
+
+    _handle = NULL;
+    Serial.printf("ModeWorker: %s 已停止, 堆栈剩余 %lu字节\n", _name, (unsigned long)_stackHighWater);
+    return true;
+}
+
+// 任务入口 - 循环执行直到收到退出请求，退出前通知stop()
+void ModeWorker::taskEntry(void* arg) {
+    ModeWorker* worker = (ModeWorker*)arg;
+    while (!worker->_stopRequested) {
+        worker->_step(worker->_arg);
+    }
+
+    worker->_stackHighWater = uxTaskGetStackHighWaterMark(NULL);
+    xSemaphoreGive(worker->_done);
+    vTaskDelete(NULL);
+}
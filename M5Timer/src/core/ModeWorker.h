@@ -0,0 +1,51 @@
+#pragma once
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+
+// 等待后台任务退出的最长时间 (毫秒)
+#define MODE_WORKER_JOIN_TIMEOUT_MS 500
+
+// 模式的后台任务
+// 在模式的begin()中启动、exit()中停止。任务循环调用step()，每次调用必须在有限时间内返回
+// (例如带超时的阻塞读取)，stop()请求退出后等待任务真正结束，之后才能释放任务使用的外设。
+// 任务固定在指定核心上运行，堆栈大小在构造时确定，停止时记录堆栈剩余量。
+class ModeWorker {
+public:
+    typedef void (*StepFunction)(void* arg);
+
+    ModeWorker(const char* name, uint32_t stackSize, UBaseType_t priority, BaseType_t core);
+    ~ModeWorker();
+
+    // 启动任务，已在运行或创建失败时返回false
+    bool start(StepFunction step, void* arg);
+
+    // 请求退出并等待任务结束，超时返回false
+    bool stop(uint32_t timeoutMs = MODE_WORKER_JOIN_TIMEOUT_MS);
+
+    bool isRunning() const { return _handle != NULL; }
+
+    // 上一次运行结束时堆栈的最小剩余量 (字节)
+    uint32_t stackHighWater() const { return _stackHighWater; }
+
+    ModeWorker(const ModeWorker&) = delete;
+    ModeWorker& operator=(const ModeWorker&) = delete;
+
+private:
+    static void taskEntry(void* arg);
+
+    const char* _name;
+    uint32_t _stackSize;
+    UBaseType_t _priority;
+    BaseType_t _core;
+
+    StepFunction _step;
+    void* _arg;
+    TaskHandle_t _handle;
+    volatile bool _stopRequested;
+    SemaphoreHandle_t _done;        // 任务退出时释放
+    StaticSemaphore_t _doneBuffer;
+    uint32_t _stackHighWater;
+};
@@ -0,0 +1,86 @@
+#include "MotionClassifier.h"
+#include <math.h>
+
+MotionClassifier::MotionClassifier() {
+    reset();
+}
+
+void MotionClassifier::reset() {
+    _hasLast = false;
+    _last.x = 0.0f;
+    _last.y = 0.0f;
+    _last.z = 0.0f;
+    _lastShakeUs = 0;
+    _shakeFired = false;
+    _tilt = MOTION_TILT_CENTER;
+    _candidate = MOTION_TILT_CENTER;
+    _candidateUs = 0;
+    _quietUs = 0;
+}
+
+// 按重力在Y轴上的分量判断倾斜方向，中间区域保持原状态 (迟滞)
+MotionTilt MotionClassifier::classifyTilt(float y) const {
+    if (y >= MOTION_TILT_ON) return MOTION_TILT_RIGHT;
+    if (y <= -MOTION_TILT_ON) return MOTION_TILT_LEFT;
+    if (fabsf(y) <= MOTION_TILT_OFF) return MOTION_TILT_CENTER;
+    return _tilt;
+}
+
+size_t MotionClassifier::process(const MotionSample* samples, size_t count, uint32_t firstTimeUs, uint32_t intervalUs,
+                                 MotionEvent* events, uint32_t* eventTimesUs, size_t maxEvents) {
+    size_t eventCount = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        const MotionSample& sample = samples[i];
+        uint32_t timeUs = firstTimeUs + (uint32_t)i * intervalUs;
+
+        // 晃动: 相邻样本三轴变化量之和超过阈值
+        if (_hasLast) {
+            float totalDelta = fabsf(sample.x - _last.x) + fabsf(sample.y - _last.y) + fabsf(sample.z - _last.z);
+
+            if (totalDelta > MOTION_SHAKE_THRESHOLD &&
+                (!_shakeFired || (uint32_t)(timeUs - _lastShakeUs) > MOTION_SHAKE_COOLDOWN_US)) {
+                _lastShakeUs = timeUs;
+                _shakeFired = true;
+                if (eventCount < maxEvents) {
+                    events[eventCount] = MOTION_EVENT_SHAKE;
+                    eventTimesUs[eventCount] = timeUs;
+                    eventCount++;
+                }
+            }
+
+            if (totalDelta < MOTION_QUIET_THRESHOLD) {
+                if (_quietUs < MOTION_QUIET_US) _quietUs += intervalUs;
+            } else {
+                _quietUs = 0;
+            }
+        }
+        _last = sample;
+        _hasLast = true;
+
+        // 倾斜: 新状态需保持一段时间才上报
+        MotionTilt tilt = classifyTilt(sample.y);
+        if (tilt == _tilt) {
+            _candidate = tilt;
+            _candidateUs = 0;
+            continue;
+        }
+        if (tilt != _candidate) {
+            _candidate = tilt;
+            _candidateUs = 0;
+        }
+        _candidateUs += intervalUs;
+
+        if (_candidateUs >= MOTION_TILT_HOLD_US) {
+            _tilt = tilt;
+            _candidateUs = 0;
+            if (eventCount < maxEvents) {
+                events[eventCount] = tilt == MOTION_TILT_LEFT ? MOTION_EVENT_TILT_LEFT :
+                                     tilt == MOTION_TILT_RIGHT ? MOTION_EVENT_TILT_RIGHT : MOTION_EVENT_TILT_CENTER;
+                eventTimesUs[eventCount] = timeUs;
+                eventCount++;
+            }
+        }
+    }
+    return eventCount;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// 晃动检测参数 (单位: g)
+#define MOTION_SHAKE_THRESHOLD   1.5f     // 相邻样本三轴变化量之和的晃动阈值
+#define MOTION_SHAKE_COOLDOWN_US 1000000  // 晃动检测冷却时间
+
+// 倾斜检测参数 (沿Y轴，即横屏时的左右方向)
+#define MOTION_TILT_ON           0.5f     // 进入倾斜的重力分量 (约30度)
+#define MOTION_TILT_OFF          0.25f    // 回到中间的重力分量 (约15度)，留出迟滞
+#define MOTION_TILT_HOLD_US      150000   // 倾斜状态需保持的时间，避免晃动误触发
+
+// 静止判定参数
+#define MOTION_QUIET_THRESHOLD   0.05f    // 相邻样本变化量低于该值视为静止
+#define MOTION_QUIET_US          1000000  // 持续静止多久后认为运动结束
+
+// 一批样本最多产生的事件数量
+#define MOTION_MAX_EVENTS        8
+
+// 加速度样本 (单位: g)
+struct MotionSample {
+    float x;
+    float y;
+    float z;
+};
+
+// 分类结果
+enum MotionEvent {
+    MOTION_EVENT_SHAKE,
+    MOTION_EVENT_TILT_LEFT,
+    MOTION_EVENT_TILT_RIGHT,
+    MOTION_EVENT_TILT_CENTER
+};
+
+// 倾斜状态
+enum MotionTilt {
+    MOTION_TILT_CENTER,
+    MOTION_TILT_LEFT,
+    MOTION_TILT_RIGHT
+};
+
+// 运动分类器
+// 对一整批等间隔加速度样本做晃动/倾斜判定，不依赖任何硬件。
+class MotionClassifier {
+public:
+    MotionClassifier();
+
+    void reset();
+
+    // 处理一批样本，firstTimeUs为第一个样本的时刻，intervalUs为采样间隔
+    // 产生的事件写入events/eventTimesUs，返回事件数量
+    size_t process(const MotionSample* samples, size_t count, uint32_t firstTimeUs, uint32_t intervalUs,
+                   MotionEvent* events, uint32_t* eventTimesUs, size_t maxEvents);
+
+    // 最近一段时间内是否没有明显运动
+    bool isQuiet() const { return _quietUs >= MOTION_QUIET_US; }
+
+    MotionTilt tilt() const { return _tilt; }
+
+private:
+    MotionTilt classifyTilt(float y) const;
+
+    bool _hasLast;
+    MotionSample _last;
+    uint32_t _lastShakeUs;
+    bool _shakeFired;       // 是否触发过晃动 (冷却计时有效)
+    MotionTilt _tilt;       // 已上报的倾斜状态
+    MotionTilt _candidate;  // 正在确认的倾斜状态
+    uint32_t _candidateUs;  // 候选状态已保持的时间
+    uint32_t _quietUs;      // 已持续静止的时间
+};
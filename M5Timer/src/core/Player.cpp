@@ -1,5 +1,6 @@
 #include "Player.h"
 #include <M5Unified.h>
+#include <esp_timer.h>
 
 // JQ8900 命令定义
 #define CMD_CLEAR 0x0A        // 清空数字
@@ -11,16 +12,23 @@
 #define CMD_STOP 0x13         // 停止
 #define CMD_NEXT 0x15         // 下一曲
 
+// 停止命令后的等待时间 (原阻塞版 delay(30) + delay(50))
+#define STOP_GAP_US 80000
+
 // 构造函数
 JQ8900Player::JQ8900Player(uint8_t pin, uint8_t maxTracks) {
     _pin = pin;
     _currentTrack = 1;
     _maxTracks = maxTracks;
     _playerState = PLAYER_STATE_IDLE;
-    _pendingTrack = 0;
-    _lastCmdTime = 0;
-    _needUpdate = false;
-    _cmdStep = 0;
+    _rmtReady = false;
+    _notifyTask = NULL;
+    _segmentIndex = 0;
+    _activeSegment = 0;
+    _txEndUs = 0;
+    _sequenceActive = false;
+    _trackSent = false;
+    _trackSentUs = 0;
     Serial.println("JQ8900Player: 创建播放器, 引脚=" + String(pin));
 }
 
@@ -30,10 +38,28 @@ void JQ8900Player::begin() {
     pinMode(_pin, OUTPUT);
     digitalWrite(_pin, HIGH);
     Serial.println("JQ8900Player: 初始化引脚 " + String(_pin));
-    
+
     // 测试引脚工作状态
     testPin();
-    
+
+    // 配置RMT: 1us分辨率，空闲时保持高电平
+    rmt_config_t config = RMT_DEFAULT_CONFIG_TX((gpio_num_t)_pin, PLAYER_RMT_CHANNEL);
+    config.clk_div = 80;  // 80MHz APB时钟 -> 1us/tick
+    config.mem_block_num = 1;
+    config.tx_config.carrier_en = false;
+    config.tx_config.idle_output_en = true;
+    config.tx_config.idle_level = RMT_IDLE_LEVEL_HIGH;
+
+    _notifyTask = xTaskGetCurrentTaskHandle();
+
+    if (rmt_config(&config) == ESP_OK && rmt_driver_install(PLAYER_RMT_CHANNEL, 0, 0) == ESP_OK) {
+        rmt_register_tx_end_callback(onTxEnd, this);
+        _rmtReady = true;
+        Serial.println("JQ8900Player: RMT发送通道已就绪");
+    } else {
+        Serial.println("JQ8900Player: RMT初始化失败");
+    }
+
     // 等待JQ8900模块初始化
     delay(500);  // 减少初始化延迟
     Serial.println("JQ8900Player: 初始化完成");
@@ -52,195 +78,228 @@ void JQ8900Player::testPin() {
     Serial.println("JQ8900Player: 引脚测试完成");
 }
 
-// 发送一个字节数据到JQ8900
-void JQ8900Player::sendByte(uint8_t data) {
-    Serial.print("JQ8900Player: 发送字节 0x");
-    Serial.println(data, HEX);
-    
-    // 开始信号，确保引脚开始于高电平
-    digitalWrite(_pin, HIGH);
-    delayMicroseconds(1000); // 减少开始信号时间
-    
-    // 引导码
-    digitalWrite(_pin, LOW);
-    delayMicroseconds(4000);  // 略微减少引导码时间
-    
-    // 发送8位数据 (从低位开始)
-    for(uint8_t i = 0; i < 8; i++) {
-        digitalWrite(_pin, HIGH);
-        if(data & 0x01) {
-            // 发送1 (高:低 = 3:1)
-            delayMicroseconds(600);
-            digitalWrite(_pin, LOW);
-            delayMicroseconds(200);
+// RMT发送完成回调 (中断上下文)
+void IRAM_ATTR JQ8900Player::onTxEnd(rmt_channel_t channel, void* arg) {
+    if (channel != PLAYER_RMT_CHANNEL) return;
+
+    JQ8900Player* player = (JQ8900Player*)arg;
+    player->_txEndUs = esp_timer_get_time();
+
+    if (player->_notifyTask != NULL) {
+        BaseType_t woken = pdFALSE;
+        xTaskNotifyFromISR(player->_notifyTask, PLAYER_NOTIFY_TX_DONE, eSetBits, &woken);
+        if (woken) {
+            portYIELD_FROM_ISR();
+        }
+    }
+}
+
+// 开始编码一段新的命令序列
+void JQ8900Player::beginSequence() {
+    // 缓冲区在发送期间由RMT中断读取，必须等上一段序列发完才能覆盖
+    while (_sequenceActive) {
+        waitIdle();
+        update();
+    }
+    _encoder.reset();
+}
+
+// 将编码好的序列交给RMT异步发送
+bool JQ8900Player::transmit() {
+    if (!_rmtReady || _encoder.segmentCount() == 0) return false;
+
+    if (_encoder.overflowed()) {
+        Serial.println("JQ8900Player: 命令序列过长，已截断");
+    }
+
+    _segmentIndex = 0;
+    _sequenceActive = sendSegment(0);
+    return _sequenceActive;
+}
+
+// 发送指定分段
+bool JQ8900Player::sendSegment(size_t segment) {
+    // 每个RMT条目包含两个电平段
+    const JQ8900Phase* phases = _encoder.phases() + _encoder.segmentStart(segment);
+    size_t count = _encoder.segmentLength(segment);
+    size_t itemCount = 0;
+    for (size_t i = 0; i < count; i += 2) {
+        rmt_item32_t& item = _items[itemCount++];
+        item.level0 = phases[i].level;
+        item.duration0 = phases[i].durationUs;
+        if (i + 1 < count) {
+            item.level1 = phases[i + 1].level;
+            item.duration1 = phases[i + 1].durationUs;
         } else {
-            // 发送0 (高:低 = 1:3)
-            delayMicroseconds(200);
-            digitalWrite(_pin, LOW);
-            delayMicroseconds(600);
+            item.level1 = 1;
+            item.duration1 = 0;  // 结束标记
         }
-        data >>= 1;  // 右移一位，准备发送下一位
     }
-    
-    // 结束信号，确保回到高电平状态
-    digitalWrite(_pin, HIGH);
-    delayMicroseconds(1000); // 减少结束信号时间
+
+    if (rmt_write_items(PLAYER_RMT_CHANNEL, _items, itemCount, false) != ESP_OK) {
+        Serial.println("JQ8900Player: RMT发送失败");
+        return false;
+    }
+    _activeSegment = segment;
+    return true;
+}
+
+// RMT是否正在发送当前分段
+bool JQ8900Player::isBusy() const {
+    return _rmtReady && rmt_wait_tx_done(PLAYER_RMT_CHANNEL, 0) != ESP_OK;
+}
+
+// 命令序列是否还有未发完的分段
+bool JQ8900Player::isSequenceActive() const {
+    return _sequenceActive;
+}
+
+// 等待当前分段发送完成
+bool JQ8900Player::waitIdle(TickType_t timeout) {
+    if (!_rmtReady) return true;
+    return rmt_wait_tx_done(PLAYER_RMT_CHANNEL, timeout) == ESP_OK;
+}
+
+// 中止正在发送的命令序列
+void JQ8900Player::abort() {
+    if (!_sequenceActive) return;
+
+    // 最后一个命令字节已开始发送时仍会完整发完，选曲照常生效
+    bool commandStarted = _segmentIndex >= _encoder.lastByteSegment();
+
+    // 正在发送的字节无法安全截断，跳过剩余分段即可
+    _segmentIndex = _encoder.segmentCount();
+
+    // 选曲播放字节还没开始发送时，被中止的选曲不会播放
+    if (_playerState == PLAYER_STATE_PREPARING && !commandStarted) {
+        _playerState = PLAYER_STATE_IDLE;
+    }
+    Serial.println("JQ8900Player: 中止命令序列");
 }
 
 // 设置音量 (0-30)
 void JQ8900Player::setVolume(uint8_t volume) {
     if(volume > 30) volume = 30;
     Serial.println("JQ8900Player: 设置音量 " + String(volume));
-    
-    // 清空数字
-    sendByte(CMD_CLEAR);
-    delay(10);  // 两个字节之间延时建议10ms以上
-    
-    // 发送十位数
-    sendByte(volume / 10);
-    delay(10);
-    
-    // 发送个位数
-    sendByte(volume % 10);
-    delay(10);
-    
-    // 发送设置音量命令
-    sendByte(CMD_VOLUME_SET);
-    delay(50);
+
+    beginSequence();
+    _encoder.appendByte(CMD_CLEAR);       // 清空数字
+    _encoder.appendByte(volume / 10);     // 十位数
+    _encoder.appendByte(volume % 10);     // 个位数
+    _encoder.appendByte(CMD_VOLUME_SET, JQ8900_CMD_GAP_US);  // 设置音量命令
+    transmit();
 }
 
 // 设置循环模式
 void JQ8900Player::setLoopMode(uint8_t mode) {
     Serial.println("JQ8900Player: 设置循环模式 " + String(mode));
-    
-    // 清空数字
-    sendByte(CMD_CLEAR);
-    delay(10);
-    
-    // 发送循环模式参数
-    sendByte(mode);
-    delay(10);
-    
-    // 发送设置循环模式命令
-    sendByte(CMD_LOOP_MODE);
-    delay(50);
+
+    beginSequence();
+    _encoder.appendByte(CMD_CLEAR);       // 清空数字
+    _encoder.appendByte(mode);            // 循环模式参数
+    _encoder.appendByte(CMD_LOOP_MODE, JQ8900_CMD_GAP_US);   // 设置循环模式命令
+    transmit();
 }
 
-// 停止播放 (阻塞版)
+// 停止播放
 void JQ8900Player::stop() {
-    Serial.println("JQ8900Player: 停止播放 (阻塞)");
-    sendByte(CMD_STOP);
-    delay(30);  // 减少等待时间
-    _playerState = PLAYER_STATE_IDLE;
-}
+    Serial.println("JQ8900Player: 停止播放");
 
-// 异步停止播放 (非阻塞版)
-void JQ8900Player::stopAsync() {
-    if (_playerState != PLAYER_STATE_STOPPING) {
-        Serial.println("JQ8900Player: 停止播放 (异步)");
+    beginSequence();
+    _encoder.appendByte(CMD_STOP, STOP_GAP_US);
+    if (transmit()) {
         _playerState = PLAYER_STATE_STOPPING;
-        _needUpdate = true;
-        _cmdStep = 0;
-        _lastCmdTime = millis();
+    } else {
+        _playerState = PLAYER_STATE_IDLE;
     }
 }
 
-// 开始播放 (阻塞版)
+// 异步停止播放
+void JQ8900Player::stopAsync() {
+    stop();
+}
+
+// 开始播放
 void JQ8900Player::play() {
     Serial.println("JQ8900Player: 开始播放");
-    sendByte(CMD_PLAY);
-    delay(50);
+
+    beginSequence();
+    _encoder.appendByte(CMD_PLAY, JQ8900_CMD_GAP_US);
+    transmit();
     _playerState = PLAYER_STATE_PLAYING;
 }
 
-// 暂停播放 (阻塞版)
+// 暂停播放
 void JQ8900Player::pause() {
     Serial.println("JQ8900Player: 暂停播放");
-    sendByte(CMD_PAUSE);
-    delay(50);
+
+    beginSequence();
+    _encoder.appendByte(CMD_PAUSE, JQ8900_CMD_GAP_US);
+    transmit();
     _playerState = PLAYER_STATE_PAUSED;
 }
 
-// 播放下一曲 (阻塞版)
+// 播放下一曲
 void JQ8900Player::next() {
     Serial.println("JQ8900Player: 下一曲");
-    sendByte(CMD_NEXT);
-    delay(50);
-    
+
+    beginSequence();
+    _encoder.appendByte(CMD_NEXT, JQ8900_CMD_GAP_US);
+    transmit();
+
     // 更新当前曲目号
     _currentTrack++;
     if(_currentTrack > _maxTracks) _currentTrack = 1;
     _playerState = PLAYER_STATE_PLAYING;
 }
 
-// 播放指定曲目 (阻塞版)
+// 播放指定曲目 - 停止、清空、四位曲目号、选曲播放编码为一整段序列
 void JQ8900Player::playTrack(uint16_t track) {
     _currentTrack = track;
-    Serial.println("JQ8900Player: 播放曲目 " + String(track) + " (阻塞)");
-    
-    // 先确保停止当前播放
-    stop();
-    delay(50); // 减少停止后的等待时间
-    
-    // 清空数字
-    sendByte(CMD_CLEAR);
-    delay(10);  // 减少两字节之间的延时
-    
-    // 发送千位数
-    sendByte((track / 1000) % 10);
-    delay(10);
-    
-    // 发送百位数
-    sendByte((track / 100) % 10);
-    delay(10);
-    
-    // 发送十位数
-    sendByte((track / 10) % 10);
-    delay(10);
-    
-    // 发送个位数
-    sendByte(track % 10);
-    delay(10);
-    
-    // 发送选曲播放命令
-    sendByte(CMD_PLAY_SPECIFIED);
-    delay(50); // 减少命令后的等待时间
-    
-    _playerState = PLAYER_STATE_PLAYING;
-    Serial.println("JQ8900Player: 播放命令已发送，曲目 " + String(track));
+    Serial.println("JQ8900Player: 播放曲目 " + String(track));
+
+    beginSequence();
+    _encoder.appendByte(CMD_STOP, STOP_GAP_US);    // 先确保停止当前播放
+    _encoder.appendByte(CMD_CLEAR);                // 清空数字
+    _encoder.appendByte((track / 1000) % 10);      // 千位数
+    _encoder.appendByte((track / 100) % 10);       // 百位数
+    _encoder.appendByte((track / 10) % 10);        // 十位数
+    _encoder.appendByte(track % 10);               // 个位数
+    _encoder.appendByte(CMD_PLAY_SPECIFIED, JQ8900_CMD_GAP_US);  // 选曲播放命令
+
+    if (transmit()) {
+        _playerState = PLAYER_STATE_PREPARING;
+    }
 }
 
-// 异步播放指定曲目 (非阻塞版)
+// 选曲命令的发送延迟: 停止 + 清空 + 四位曲目号 + 选曲播放 (不含最后的命令间隔)
+uint32_t JQ8900Player::trackLatencyUs() {
+    return JQ8900Encoder::byteDurationUs(STOP_GAP_US) +
+           5 * JQ8900Encoder::byteDurationUs() +
+           JQ8900Encoder::byteDurationUs(0);
+}
+
+// 异步播放指定曲目
 void JQ8900Player::playTrackAsync(uint16_t track) {
-    _pendingTrack = track;
-    _currentTrack = track;
-    Serial.println("JQ8900Player: 播放曲目 " + String(track) + " (异步)");
-    
-    // 设置状态为准备播放
-    _playerState = PLAYER_STATE_PREPARING;
-    _needUpdate = true;
-    _cmdStep = 0;
-    _lastCmdTime = millis();
+    playTrack(track);
 }
 
 // 播放随机曲目
 void JQ8900Player::playRandom() {
     // 生成1到_maxTracks之间的随机数
     uint8_t randomTrack = random(1, _maxTracks + 1);
-    
+
     // 确保不重复播放同一首歌
     while(randomTrack == _currentTrack && _maxTracks > 1) {
         randomTrack = random(1, _maxTracks + 1);
     }
-    
+
     Serial.println("JQ8900Player: 随机播放曲目 " + String(randomTrack));
-    
-    // 使用异步方式播放
-    playTrackAsync(randomTrack);
+    playTrack(randomTrack);
 }
 
 // 获取当前播放的曲目
-uint8_t JQ8900Player::getCurrentTrack() const {
+uint16_t JQ8900Player::getCurrentTrack() const {
     return _currentTrack;
 }
 
@@ -249,79 +308,38 @@ uint8_t JQ8900Player::getPlayerState() const {
     return _playerState;
 }
 
-// 更新播放器状态 (需要在主循环中定期调用)
+// 取出最近一次发完的选曲命令
+bool JQ8900Player::takeTrackSent(uint16_t* track, int64_t* sentUs) {
+    if (!_trackSent) return false;
+    _trackSent = false;
+    *track = _currentTrack;
+    *sentUs = _trackSentUs;
+    return true;
+}
+
+// 更新播放器状态 - 发送下一分段，序列完成后切换到最终状态
 void JQ8900Player::update() {
-    if (!_needUpdate) return;
-    
-    unsigned long currentTime = millis();
-    
-    // 确保命令间隔足够长
-    if (currentTime - _lastCmdTime < 20) return;
-    
+    if (!_sequenceActive || isBusy()) return;
+
+    // 选曲播放字节所在分段刚发完: 模块在字节结束信号后执行命令，
+    // 按发送完成中断的时刻减去段内的字节间隔记录，不等其后的命令间隔，也不受update()调用延迟影响
+    if (_playerState == PLAYER_STATE_PREPARING && _activeSegment == _encoder.lastByteSegment()) {
+        _trackSent = true;
+        _trackSentUs = _txEndUs - _encoder.lastByteGapUs();
+    }
+
+    // 继续发送下一分段
+    if (_segmentIndex + 1 < _encoder.segmentCount()) {
+        _segmentIndex++;
+        if (sendSegment(_segmentIndex)) return;
+    }
+    _sequenceActive = false;
+
     if (_playerState == PLAYER_STATE_STOPPING) {
-        // 异步停止
-        if (_cmdStep == 0) {
-            sendByte(CMD_STOP);
-            _cmdStep = 1;
-            _lastCmdTime = currentTime;
-        } else {
-            // 停止完成
-            _playerState = PLAYER_STATE_IDLE;
-            _needUpdate = false;
-            _cmdStep = 0;
-            Serial.println("JQ8900Player: 异步停止完成");
-        }
+        _playerState = PLAYER_STATE_IDLE;
+        Serial.println("JQ8900Player: 停止完成");
     } else if (_playerState == PLAYER_STATE_PREPARING) {
-        // 异步播放准备过程
-        switch (_cmdStep) {
-            case 0:  // 首先停止当前播放
-                sendByte(CMD_STOP);
-                _cmdStep = 1;
-                _lastCmdTime = currentTime;
-                break;
-            
-            case 1:  // 清空数字
-                sendByte(CMD_CLEAR);
-                _cmdStep = 2;
-                _lastCmdTime = currentTime;
-                break;
-                
-            case 2:  // 发送千位数
-                sendByte((_pendingTrack / 1000) % 10);
-                _cmdStep = 3;
-                _lastCmdTime = currentTime;
-                break;
-                
-            case 3:  // 发送百位数
-                sendByte((_pendingTrack / 100) % 10);
-                _cmdStep = 4;
-                _lastCmdTime = currentTime;
-                break;
-                
-            case 4:  // 发送十位数
-                sendByte((_pendingTrack / 10) % 10);
-                _cmdStep = 5;
-                _lastCmdTime = currentTime;
-                break;
-                
-            case 5:  // 发送个位数
-                sendByte(_pendingTrack % 10);
-                _cmdStep = 6;
-                _lastCmdTime = currentTime;
-                break;
-                
-            case 6:  // 发送播放命令
-                sendByte(CMD_PLAY_SPECIFIED);
-                _cmdStep = 7;
-                _lastCmdTime = currentTime;
-                break;
-                
-            case 7:  // 播放完成
-                _playerState = PLAYER_STATE_PLAYING;
-                _needUpdate = false;
-                _cmdStep = 0;
-                Serial.println("JQ8900Player: 异步播放完成，曲目 " + String(_pendingTrack));
-                break;
-        }
+        _playerState = PLAYER_STATE_PLAYING;
+        Serial.println("JQ8900Player: 播放命令已发送，曲目 " + String(_currentTrack));
     }
-} 
\ No newline at end of file
+}
\ No newline at end of file
@@ -2,6 +2,10 @@
 #define PLAYER_H
 
 #include <Arduino.h>
+#include <driver/rmt.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "JQ8900Encoder.h"
 
 // 循环模式定义
 #define LOOP_SINGLE 0x00      // 单曲循环
@@ -15,74 +19,116 @@
 #define PLAYER_STATE_PREPARING   3  // 准备播放
 #define PLAYER_STATE_PAUSED      4  // 暂停状态
 
+// RMT通道 - 使用最后一个通道，避免与LED输出使用的通道0/1冲突
+#define PLAYER_RMT_CHANNEL       RMT_CHANNEL_7
+
+// 任务通知位 - 命令序列发送完成
+#define PLAYER_NOTIFY_TX_DONE    0x01
+
 class JQ8900Player {
 private:
     uint8_t _pin;                // 控制引脚
-    uint8_t _currentTrack;       // 当前播放的曲目
+    uint16_t _currentTrack;      // 当前播放的曲目 (1-9999)
     uint8_t _maxTracks;          // 最大曲目数量
-    
-    // 异步操作相关
     uint8_t _playerState;        // 播放器状态
-    uint16_t _pendingTrack;      // 待播放的曲目号
-    unsigned long _lastCmdTime;  // 上次命令发送时间
-    bool _needUpdate;            // 是否需要更新状态
-    uint8_t _cmdStep;            // 命令执行步骤
-    
-    // 发送一个字节数据到JQ8900
-    void sendByte(uint8_t data);
-    
+
+    // RMT发送相关
+    JQ8900Encoder _encoder;                            // 命令序列编码器
+    rmt_item32_t _items[JQ8900_MAX_PHASES / 2 + 1];    // RMT脉冲条目缓冲区
+    bool _rmtReady;              // RMT是否初始化成功
+    TaskHandle_t _notifyTask;    // 每段发送完成时通知的任务
+    size_t _segmentIndex;        // 下一步要继续的分段 (中止时跳到末尾)
+    size_t _activeSegment;       // 交给RMT的最后一个分段
+    volatile int64_t _txEndUs;   // 最近一次分段发送完成的时刻 (发送完成中断中记录)
+    bool _sequenceActive;        // 命令序列是否仍在发送中
+    bool _trackSent;             // 选曲序列已发完，等待取走
+    int64_t _trackSentUs;        // 选曲播放字节发完的时刻 (esp_timer微秒，不含其后的命令间隔)
+
+    // 开始编码一段新的命令序列 (等待上一段序列发送完成)
+    void beginSequence();
+
+    // 将编码好的序列交给RMT异步发送，立即返回
+    bool transmit();
+
+    // 发送指定分段
+    bool sendSegment(size_t segment);
+
+    // RMT发送完成回调 (中断上下文)
+    static void onTxEnd(rmt_channel_t channel, void* arg);
+
     // 测试引脚工作状态
     void testPin();
 
 public:
     // 构造函数
     JQ8900Player(uint8_t pin, uint8_t maxTracks = 9);
-    
-    // 初始化播放器
+
+    // 初始化播放器，调用任务将接收发送完成通知
     void begin();
-    
+
     // 设置音量 (0-30)
     void setVolume(uint8_t volume);
-    
+
     // 设置循环模式
     void setLoopMode(uint8_t mode);
-    
-    // 停止播放 (阻塞版)
+
+    // 停止播放
     void stop();
-    
-    // 异步停止播放 (非阻塞版)
+
+    // 异步停止播放 (与stop相同，保留兼容)
     void stopAsync();
-    
-    // 开始播放 (阻塞版)
+
+    // 开始播放
     void play();
-    
-    // 暂停播放 (阻塞版)
+
+    // 暂停播放
     void pause();
-    
-    // 播放下一曲 (阻塞版)
+
+    // 播放下一曲
     void next();
-    
-    // 播放指定曲目 (1-9999) (阻塞版)
+
+    // 播放指定曲目 (1-9999)
     void playTrack(uint16_t track);
-    
-    // 异步播放指定曲目 (非阻塞版)
+
+    // 异步播放指定曲目 (与playTrack相同，保留兼容)
     void playTrackAsync(uint16_t track);
-    
+
     // 播放随机曲目
     void playRandom();
-    
+
     // 获取当前播放的曲目
-    uint8_t getCurrentTrack() const;
-    
+    uint16_t getCurrentTrack() const;
+
     // 获取播放器状态
     uint8_t getPlayerState() const;
-    
-    // 更新播放器状态 (需要在主循环中定期调用)
+
+    // 选曲命令从开始发送到选曲播放字节发完的时间 (微秒)，用于提前发出提示音
+    static uint32_t trackLatencyUs();
+
+    // RMT是否正在发送当前分段
+    bool isBusy() const;
+
+    // 命令序列是否还有未发完的分段
+    bool isSequenceActive() const;
+
+    // 等待当前分段发送完成，超时返回false
+    bool waitIdle(TickType_t timeout = portMAX_DELAY);
+
+    // 中止正在发送的命令序列 - 当前字节发完后不再发送剩余分段
+    // 选曲播放字节已开始发送时选曲仍会生效，状态保持准备播放直到发完
+    void abort();
+
+    // 取出最近一次发完的选曲命令 (曲目与选曲播放字节发完的时刻)，没有新的选曲完成时返回false
+    // 该时刻与trackLatencyUs()的口径一致: 从序列开始发送算起，不含最后的命令间隔
+    bool takeTrackSent(uint16_t* track, int64_t* sentUs);
+
+    // 更新播放器状态 - 分段发送完成后发送下一段，序列完成后切换状态
+    // 需要在收到PLAYER_NOTIFY_TX_DONE通知后尽快调用
     void update();
-    
+
     // 删除拷贝构造函数和赋值操作符
     JQ8900Player(const JQ8900Player&) = delete;
     JQ8900Player& operator=(const JQ8900Player&) = delete;
 };
 
-#endif // PLAYER_H 
\ No newline at end of file
+#endif // PLAYER_H
\ No newline at end of file
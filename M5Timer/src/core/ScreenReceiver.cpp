@@ -0,0 +1,101 @@
+#include "ScreenReceiver.h"
+#include <stdio.h>
+#include <string.h>
+
+ScreenReceiver::ScreenReceiver() {
+    memset(_pixels, 0, sizeof(_pixels));
+    _shownSequence = 0;
+    _events = 0;
+    _frameReceived = false;
+    _resyncNeeded = false;
+    _replyHandler = NULL;
+    _replyContext = NULL;
+}
+
+void ScreenReceiver::setReplyHandler(ScreenReplyHandler handler, void* context) {
+    _replyHandler = handler;
+    _replyContext = context;
+}
+
+void ScreenReceiver::reply(const char* line) {
+    if (_replyHandler != NULL) {
+        _replyHandler(line, _replyContext);
+    }
+}
+
+void ScreenReceiver::show(const uint8_t* pixels, uint8_t sequence) {
+    memcpy(_pixels, pixels, sizeof(_pixels));
+    _shownSequence = sequence;
+}
+
+void ScreenReceiver::push(const uint8_t* data, size_t length, uint32_t nowMs) {
+    char line[32];
+
+    for (size_t i = 0; i < length; i++) {
+        switch (_parser.push(data[i])) {
+            case FRAME_PARSE_PIXELS:
+                _frameReceived = true;
+                if (_parser.isDeferred()) {
+                    // 只缓存，等待显示命令
+                    _deferredFrame.store(_parser.pixels(), _parser.sequence());
+                } else {
+                    show(_parser.pixels(), _parser.sequence());
+                    _events |= SCREEN_RX_DISPLAY;
+                }
+                break;
+
+            case FRAME_PARSE_PRESENT:
+                // 显示时刻已由主机换算为本机时钟，不合理时 (时钟未对齐) 立即显示
+                if (_deferredFrame.onPresent(_parser.presentSequence(), _parser.hasPresentTime(),
+                                             _parser.presentTimeMs(), nowMs)) {
+                    show(_deferredFrame.take(), _deferredFrame.sequence());
+                    _events |= SCREEN_RX_DISPLAY;
+                }
+                break;
+
+            case FRAME_PARSE_SYNC:
+                // 立即回显主机时刻与本机收到的时刻，主机据此按往返时间计算时钟差
+                snprintf(line, sizeof(line), "SYNC:%lu,%lu\n",
+                         (unsigned long)_parser.syncTimeMs(), (unsigned long)nowMs);
+                reply(line);
+                break;
+
+            case FRAME_PARSE_TEST:
+                _events |= SCREEN_RX_TEST;
+                break;
+
+            case FRAME_PARSE_RESYNC:
+                _resyncNeeded = true;
+                break;
+
+            case FRAME_PARSE_NONE:
+                break;
+        }
+    }
+}
+
+uint8_t ScreenReceiver::finish() {
+    char line[16];
+
+    // 压缩帧: 确认当前画面的序号，主机以此为差分基准；丢帧后请求关键帧
+    if (!_parser.hasSequence()) {
+        if (_resyncNeeded) reply("KEY\n");
+    } else if (_frameReceived) {
+        snprintf(line, sizeof(line), "ACK:%u\n", _parser.sequence());
+        reply(line);
+    }
+
+    uint8_t events = _events;
+    _events = 0;
+    _frameReceived = false;
+    _resyncNeeded = false;
+    return events;
+}
+
+bool ScreenReceiver::presentDue(uint32_t nowMs) {
+    if (!_deferredFrame.isDue(nowMs)) return false;
+    const uint8_t* pixels = _deferredFrame.take();
+    if (pixels == NULL) return false;
+    show(pixels, _deferredFrame.sequence());
+    return true;
+}
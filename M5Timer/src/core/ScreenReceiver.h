@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "FrameParser.h"
+#include "DeferredFrame.h"
+
+// 一批数据处理后的事件
+#define SCREEN_RX_DISPLAY  0x01   // 当前画面改变，需要刷新显示
+#define SCREEN_RX_TEST     0x02   // 收到TEST命令
+
+// 应答回调: 一行完整的应答文本 (含换行)，由调用方写回串口
+typedef void (*ScreenReplyHandler)(const char* line, void* context);
+
+// 屏幕模式的串口协议分发 (不读取时钟、不访问串口与LED，不依赖任何硬件)
+// 把收到的字节交给FrameParser，延迟帧交给DeferredFrame，回显时钟同步，
+// 一批数据处理完后确认压缩帧序号或请求关键帧。ScreenMode与主机同步仿真测试共用本类。
+class ScreenReceiver {
+public:
+    ScreenReceiver();
+
+    // 设置应答回调
+    void setReplyHandler(ScreenReplyHandler handler, void* context);
+
+    // 输入一段已接收的数据，nowMs为本机时刻 (millis)
+    void push(const uint8_t* data, size_t length, uint32_t nowMs);
+
+    // 一批数据处理完: 发送ACK/KEY应答 (一次收到多帧只应答一次)，返回并清空期间的事件
+    uint8_t finish();
+
+    // 到达延迟帧的显示时刻时显示该帧，返回true
+    bool presentDue(uint32_t nowMs);
+
+    // 距离延迟帧显示时刻的时间，没有安排时返回DEFERRED_NO_DEADLINE
+    uint32_t deadlineMs(uint32_t nowMs) const { return _deferredFrame.deadlineMs(nowMs); }
+
+    // 当前应显示的画面 (颜色编号0-15，按行优先排列) 与其压缩帧序号
+    const uint8_t* pixels() const { return _pixels; }
+    uint8_t shownSequence() const { return _shownSequence; }
+
+private:
+    void reply(const char* line);
+    void show(const uint8_t* pixels, uint8_t sequence);
+
+    FrameParser _parser;
+    DeferredFrame _deferredFrame;
+    uint8_t _pixels[FRAME_PIXELS];
+    uint8_t _shownSequence;
+
+    // 本批数据的状态
+    uint8_t _events;
+    bool _frameReceived;
+    bool _resyncNeeded;
+
+    ScreenReplyHandler _replyHandler;
+    void* _replyContext;
+};
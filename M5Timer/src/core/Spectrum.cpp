@@ -0,0 +1,162 @@
+#include "Spectrum.h"
+#include <math.h>
+#include <string.h>
+
+// 128点复数FFT的级数
+#define FFT_HALF_LOG2       7
+
+// 对数刻度: 功率log2值低于下限为0行，每行对应的log2增量 (Q8)
+#define SPECTRUM_FLOOR_Q8   (12 * 256)
+#define SPECTRUM_STEP_Q8    384
+
+// 第一个频段从频点1开始 (跳过直流)
+#define SPECTRUM_FIRST_BIN  1
+
+// 每个显示帧回落的行高 (Q8) 与峰值保持的显示帧数
+#define LEVEL_FALL_Q8       64
+#define PEAK_FALL_Q8        32
+#define PEAK_HOLD_FRAMES    30
+
+FixedFFT::FixedFFT() {
+    for (int k = 0; k < FFT_HALF; k++) {
+        float angle = 2.0f * (float)M_PI * k / FFT_SIZE;
+        _cos[k] = (int16_t)lroundf(cosf(angle) * 32767.0f);
+        _sin[k] = (int16_t)lroundf(sinf(angle) * 32767.0f);
+    }
+    for (int n = 0; n < FFT_SIZE; n++) {
+        float w = 0.5f - 0.5f * cosf(2.0f * (float)M_PI * n / (FFT_SIZE - 1));
+        _window[n] = (int16_t)lroundf(w * 32767.0f);
+    }
+    for (int i = 0; i < FFT_HALF; i++) {
+        uint8_t reversed = 0;
+        for (int b = 0; b < FFT_HALF_LOG2; b++) {
+            if (i & (1 << b)) reversed |= 1 << (FFT_HALF_LOG2 - 1 - b);
+        }
+        _bitReverse[i] = reversed;
+    }
+}
+
+void FixedFFT::power(const int16_t* samples, uint32_t* bins) {
+    // 加窗并打包: z[n] = x[2n] + j*x[2n+1]，按位反转顺序存放
+    // 额外右移一位，保证每级蝶形运算后的分量不超过int16范围
+    for (int n = 0; n < FFT_HALF; n++) {
+        int i = _bitReverse[n];
+        _re[i] = (int16_t)(((int32_t)samples[2 * n] * _window[2 * n]) >> 16);
+        _im[i] = (int16_t)(((int32_t)samples[2 * n + 1] * _window[2 * n + 1]) >> 16);
+    }
+
+    // 基2时域抽取，W_size^k = W_FFT_SIZE^(k * FFT_SIZE / size)
+    for (int size = 2, step = FFT_SIZE / 2; size <= FFT_HALF; size <<= 1, step >>= 1) {
+        int half = size >> 1;
+        for (int start = 0; start < FFT_HALF; start += size) {
+            for (int k = 0; k < half; k++) {
+                int32_t wr = _cos[k * step];
+                int32_t wi = -_sin[k * step];
+                int i = start + k;
+                int j = i + half;
+                int32_t tr = ((int32_t)_re[j] * wr - (int32_t)_im[j] * wi) >> 15;
+                int32_t ti = ((int32_t)_re[j] * wi + (int32_t)_im[j] * wr) >> 15;
+                int32_t ar = _re[i];
+                int32_t ai = _im[i];
+                _re[j] = (int16_t)((ar - tr) >> 1);
+                _im[j] = (int16_t)((ai - ti) >> 1);
+                _re[i] = (int16_t)((ar + tr) >> 1);
+                _im[i] = (int16_t)((ai + ti) >> 1);
+            }
+        }
+    }
+
+    // 拆分实数频谱: X[k] = Xe[k] + W^k * Xo[k]
+    // Xe[k] = (Z[k] + conj(Z[N/2-k])) / 2, Xo[k] = (Z[k] - conj(Z[N/2-k])) / 2j
+    for (int k = 0; k < FFT_HALF; k++) {
+        int m = (FFT_HALF - k) & (FFT_HALF - 1);
+        int32_t zr = _re[k];
+        int32_t zi = _im[k];
+        int32_t cr = _re[m];
+        int32_t ci = -_im[m];
+        int32_t er = (zr + cr) >> 1;
+        int32_t ei = (zi + ci) >> 1;
+        int32_t orr = (zi - ci) >> 1;
+        int32_t oi = (cr - zr) >> 1;
+        int32_t wr = _cos[k];
+        int32_t wi = -_sin[k];
+        int32_t xr = er + ((orr * wr - oi * wi) >> 15);
+        int32_t xi = ei + ((orr * wi + oi * wr) >> 15);
+        uint32_t mr = (uint32_t)(xr < 0 ? -xr : xr);
+        uint32_t mi = (uint32_t)(xi < 0 ? -xi : xi);
+        bins[k] = mr * mr + mi * mi;
+    }
+}
+
+SpectrumAnalyzer::SpectrumAnalyzer() {
+    // 对数间隔的频段边界，每段至少一个频点
+    float ratio = powf((float)FFT_HALF / SPECTRUM_FIRST_BIN, 1.0f / SPECTRUM_BANDS);
+    _edges[0] = SPECTRUM_FIRST_BIN;
+    for (int i = 1; i <= SPECTRUM_BANDS; i++) {
+        int edge = (int)lroundf(SPECTRUM_FIRST_BIN * powf(ratio, (float)i));
+        if (edge <= _edges[i - 1]) edge = _edges[i - 1] + 1;
+        if (edge > FFT_HALF) edge = FFT_HALF;
+        _edges[i] = (uint8_t)edge;
+    }
+    reset();
+}
+
+void SpectrumAnalyzer::reset() {
+    memset(_bandQ8, 0, sizeof(_bandQ8));
+    memset(_inputQ8, 0, sizeof(_inputQ8));
+    memset(_levelQ8, 0, sizeof(_levelQ8));
+    memset(_peakQ8, 0, sizeof(_peakQ8));
+    memset(_peakHold, 0, sizeof(_peakHold));
+}
+
+// 整数部分取最高位位置，小数部分取其后8位的线性近似
+int32_t SpectrumAnalyzer::log2Q8(uint32_t value) {
+    if (value == 0) return 0;
+    int msb = 31 - __builtin_clz(value);
+    uint32_t mantissa = msb >= 8 ? (value >> (msb - 8)) : (value << (8 - msb));
+    return (msb << 8) | (mantissa & 0xFF);
+}
+
+void SpectrumAnalyzer::process(const int16_t* samples, int32_t gainQ8) {
+    _fft.power(samples, _power);
+
+    for (int band = 0; band < SPECTRUM_BANDS; band++) {
+        // 频段平均功率，高频段包含的频点多，取平均避免整体偏向高频
+        uint64_t sum = 0;
+        int first = _edges[band];
+        int last = _edges[band + 1];
+        for (int k = first; k < last; k++) {
+            sum += _power[k];
+        }
+        uint32_t average = (uint32_t)(sum / (uint32_t)(last - first));
+
+        _bandQ8[band] = log2Q8(average);
+        int32_t levelQ8 = (_bandQ8[band] + gainQ8 - SPECTRUM_FLOOR_Q8) * 256 / SPECTRUM_STEP_Q8;
+        if (levelQ8 < 0) levelQ8 = 0;
+        if (levelQ8 > SPECTRUM_ROWS * 256) levelQ8 = SPECTRUM_ROWS * 256;
+        if (levelQ8 > _inputQ8[band]) {
+            _inputQ8[band] = (int16_t)levelQ8;
+        }
+    }
+}
+
+void SpectrumAnalyzer::advance() {
+    for (int band = 0; band < SPECTRUM_BANDS; band++) {
+        // 立即上升，逐帧回落
+        int32_t levelQ8 = _inputQ8[band];
+        int32_t fallen = _levelQ8[band] - LEVEL_FALL_Q8;
+        _levelQ8[band] = (int16_t)(levelQ8 > fallen ? levelQ8 : (fallen > 0 ? fallen : 0));
+        _inputQ8[band] = 0;
+
+        // 峰值保持后回落，不低于当前行高
+        if (_levelQ8[band] >= _peakQ8[band]) {
+            _peakQ8[band] = _levelQ8[band];
+            _peakHold[band] = PEAK_HOLD_FRAMES;
+        } else if (_peakHold[band] > 0) {
+            _peakHold[band]--;
+        } else {
+            int32_t peak = _peakQ8[band] - PEAK_FALL_Q8;
+            _peakQ8[band] = (int16_t)(peak > _levelQ8[band] ? peak : _levelQ8[band]);
+        }
+    }
+}
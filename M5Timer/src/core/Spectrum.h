@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stdint.h>
+
+// FFT点数 (实数输入)
+#define FFT_SIZE          256
+#define FFT_HALF          (FFT_SIZE / 2)
+
+// 频谱柱数与每柱的LED行数
+#define SPECTRUM_BANDS    8
+#define SPECTRUM_ROWS     8
+
+// 定点 (Q15) 实数FFT
+// 256点实数序列打包成128点复数序列做基2 FFT，再拆分出实数频谱，计算量约为复数FFT的一半。
+// 每级蝶形运算后右移一位防止溢出，输出频谱为X[k] / FFT_SIZE的功率 (只用于比较相对大小)。
+// 旋转因子和Hann窗只在构造时计算一次。不依赖Arduino，便于在主机上测试。
+class FixedFFT {
+public:
+    FixedFFT();
+
+    // samples: FFT_SIZE个16位采样; bins: 输出FFT_HALF个频点的功率 (频点k对应k * 采样率 / FFT_SIZE)
+    void power(const int16_t* samples, uint32_t* bins);
+
+private:
+    int16_t _cos[FFT_HALF];      // cos(2πk/FFT_SIZE), Q15
+    int16_t _sin[FFT_HALF];      // sin(2πk/FFT_SIZE), Q15
+    int16_t _window[FFT_SIZE];   // Hann窗, Q15
+    uint8_t _bitReverse[FFT_HALF];
+    int16_t _re[FFT_HALF];
+    int16_t _im[FFT_HALF];
+};
+
+// 频谱柱状图
+// 频点按对数间隔分成SPECTRUM_BANDS段，每段取平均功率换算成对数刻度的行高。
+// 分析 (每个采集帧) 与显示 (固定帧率) 分开: 两次显示之间取各频段的最大值，
+// 行高立即上升、每个显示帧回落，峰值点保持一段时间后再回落。
+class SpectrumAnalyzer {
+public:
+    SpectrumAnalyzer();
+
+    // 分析一帧FFT_SIZE个采样; gainQ8: 功率增益的log2值 (Q8)，用于调节灵敏度
+    void process(const int16_t* samples, int32_t gainQ8);
+
+    // 推进一个显示帧: 用上一显示帧以来分析到的最大值更新行高与峰值
+    void advance();
+
+    // 当前行高与峰值所在行高 (0-SPECTRUM_ROWS)
+    uint8_t level(int band) const { return (uint8_t)(_levelQ8[band] >> 8); }
+    uint8_t peak(int band) const { return (uint8_t)(_peakQ8[band] >> 8); }
+
+    // 最近一帧各频段平均功率的log2值 (Q8，不含增益)，供节拍检测使用
+    const int32_t* bandLevels() const { return _bandQ8; }
+
+    // 各频段的起始频点 (最后一项为结束频点)
+    const uint8_t* bandEdges() const { return _edges; }
+
+    void reset();
+
+    // 功率的log2值 (Q8)，0返回0
+    static int32_t log2Q8(uint32_t value);
+
+private:
+    FixedFFT _fft;
+    uint32_t _power[FFT_HALF];
+    uint8_t _edges[SPECTRUM_BANDS + 1];
+    int32_t _bandQ8[SPECTRUM_BANDS];    // 最近一帧的频段功率 (log2, Q8)
+    int16_t _inputQ8[SPECTRUM_BANDS];   // 上一显示帧以来分析到的最大行高 (Q8)
+    int16_t _levelQ8[SPECTRUM_BANDS];   // 行高 (Q8)
+    int16_t _peakQ8[SPECTRUM_BANDS];    // 峰值行高 (Q8)
+    uint8_t _peakHold[SPECTRUM_BANDS];  // 峰值剩余保持帧数
+};
@@ -0,0 +1,106 @@
+#include "WS2812Output.h"
+
+// RMT条目的时长字段为15位
+static_assert(WS2812_T0L_TICKS + WS2812_RESET_TICKS <= 0x7FFF, "reset time must fit in one RMT item");
+
+WS2812Output::WS2812Output(uint8_t pin) {
+    _pin = pin;
+    _ready = false;
+    memset(_bytes, 0, sizeof(_bytes));
+}
+
+bool WS2812Output::begin() {
+    // 驱动已安装时只重新把通道接到引脚: 其他外设 (如麦克风I2S) 可能临时占用过该引脚
+    if (_ready) {
+        if (rmt_set_gpio(WS2812_RMT_CHANNEL, RMT_MODE_TX, (gpio_num_t)_pin, false) != ESP_OK) {
+            Serial.println("WS2812Output: RMT引脚重新连接失败");
+            return false;
+        }
+        return true;
+    }
+
+    // 40MHz时钟，空闲时保持低电平
+    rmt_config_t config = RMT_DEFAULT_CONFIG_TX((gpio_num_t)_pin, WS2812_RMT_CHANNEL);
+    config.clk_div = 2;
+    config.mem_block_num = 2;
+    config.tx_config.carrier_en = false;
+    config.tx_config.idle_output_en = true;
+    config.tx_config.idle_level = RMT_IDLE_LEVEL_LOW;
+
+    if (rmt_config(&config) != ESP_OK ||
+        rmt_driver_install(WS2812_RMT_CHANNEL, 0, 0) != ESP_OK ||
+        rmt_translator_init(WS2812_RMT_CHANNEL, translate) != ESP_OK) {
+        Serial.println("WS2812Output: RMT初始化失败");
+        return false;
+    }
+
+    _ready = true;
+    Serial.println("WS2812Output: RMT发送通道已就绪");
+    return true;
+}
+
+// RMT驱动回调 (中断上下文): 把字节转换为脉冲条目，高位在前
+// src与srcSize是尚未转换的部分，转换到最后一个字节时把复位时间加到最后一位的低电平上
+void IRAM_ATTR WS2812Output::translate(const void* src, rmt_item32_t* dest, size_t srcSize,
+                                       size_t wantedNum, size_t* translatedSize, size_t* itemNum) {
+    const uint8_t* bytes = (const uint8_t*)src;
+    size_t size = 0;
+    size_t num = 0;
+
+    while (size < srcSize && num + 8 <= wantedNum) {
+        uint8_t data = bytes[size];
+        for (int bit = 0; bit < 8; bit++) {
+            rmt_item32_t& item = dest[num++];
+            if (data & 0x80) {
+                item.level0 = 1;
+                item.duration0 = WS2812_T1H_TICKS;
+                item.level1 = 0;
+                item.duration1 = WS2812_T1L_TICKS;
+            } else {
+                item.level0 = 1;
+                item.duration0 = WS2812_T0H_TICKS;
+                item.level1 = 0;
+                item.duration1 = WS2812_T0L_TICKS;
+            }
+            data <<= 1;
+        }
+        if (size + 1 == srcSize) {
+            dest[num - 1].duration1 += WS2812_RESET_TICKS;
+        }
+        size++;
+    }
+    *translatedSize = size;
+    *itemNum = num;
+}
+
+bool WS2812Output::isBusy() const {
+    return _ready && rmt_wait_tx_done(WS2812_RMT_CHANNEL, 0) != ESP_OK;
+}
+
+bool WS2812Output::wait(TickType_t timeout) {
+    if (!_ready) return true;
+    return rmt_wait_tx_done(WS2812_RMT_CHANNEL, timeout) == ESP_OK;
+}
+
+bool WS2812Output::write(const uint32_t* colors, size_t count, const uint8_t* lut) {
+    if (!_ready) return false;
+    if (count > WS2812_MAX_LEDS) count = WS2812_MAX_LEDS;
+
+    // 字节缓冲区正在被RMT读取，必须等上一帧发完 (含帧后的复位时间)
+    wait();
+
+    // 编码为GRB，逐通道查表
+    for (size_t i = 0; i < count; i++) {
+        uint32_t color = colors[i];
+        _bytes[i * 3] = lut[(color >> 8) & 0xFF];
+        _bytes[i * 3 + 1] = lut[(color >> 16) & 0xFF];
+        _bytes[i * 3 + 2] = lut[color & 0xFF];
+    }
+
+    size_t size = count * 3;
+    if (rmt_write_sample(WS2812_RMT_CHANNEL, _bytes, size, false) != ESP_OK) {
+        Serial.println("WS2812Output: RMT发送失败");
+        return false;
+    }
+    return true;
+}
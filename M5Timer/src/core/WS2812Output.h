@@ -0,0 +1,48 @@
+#pragma once
+
+#include <Arduino.h>
+#include <driver/rmt.h>
+
+// RMT通道 - 播放器使用最后一个通道，LED使用第一个通道 (占用两块RMT内存)
+#define WS2812_RMT_CHANNEL  RMT_CHANNEL_0
+
+// WS2812时序 (40MHz RMT时钟，25ns/tick)
+#define WS2812_T0H_TICKS    16      // 0码高电平 400ns
+#define WS2812_T0L_TICKS    34      // 0码低电平 850ns
+#define WS2812_T1H_TICKS    32      // 1码高电平 800ns
+#define WS2812_T1L_TICKS    18      // 1码低电平 450ns
+#define WS2812_RESET_US     80      // 帧之间保持低电平的复位时间
+#define WS2812_RESET_TICKS  (WS2812_RESET_US * 40)  // 复位时间并入最后一位的低电平
+
+// 最大LED数量
+#define WS2812_MAX_LEDS     64
+
+// WS2812输出后端
+// 把一帧颜色编码为GRB字节缓冲区后交给RMT异步发送，RMT驱动在中断中把字节逐位转换成脉冲，
+// 发送期间CPU中断保持开启，调用方立即返回。
+// 帧后的复位低电平编码在最后一个脉冲条目里，发送完成即复位完成，连续发送不需要额外等待。
+class WS2812Output {
+public:
+    WS2812Output(uint8_t pin);
+
+    // 初始化RMT通道; 已初始化时重新把通道输出连接到引脚
+    bool begin();
+
+    // 开始发送一帧 (0xRRGGBB)，每个通道经lut (256项) 转换后编码
+    // 上一帧仍在发送时会先等待其完成
+    bool write(const uint32_t* colors, size_t count, const uint8_t* lut);
+
+    // 是否正在发送
+    bool isBusy() const;
+
+    // 栅栏: 等待当前帧发送完成
+    bool wait(TickType_t timeout = portMAX_DELAY);
+
+private:
+    static void IRAM_ATTR translate(const void* src, rmt_item32_t* dest, size_t srcSize,
+                                    size_t wantedNum, size_t* translatedSize, size_t* itemNum);
+
+    uint8_t _pin;
+    bool _ready;
+    uint8_t _bytes[WS2812_MAX_LEDS * 3];   // 发送中的GRB字节，发送完成前不能修改
+};
@@ -96,7 +96,10 @@ enum EventType {
     EVENT_SHAKE,          // 晃动事件
     EVENT_TILT_LEFT,      // 向左倾斜事件
     EVENT_TILT_RIGHT,     // 向右倾斜事件
-    EVENT_TILT_CENTER     // 恢复中间位置事件
+    EVENT_TILT_CENTER,    // 恢复中间位置事件
+    EVENT_SERIAL_DATA,    // 串口收到数据事件
+    EVENT_AUDIO_SENT,     // 选曲命令已发送到播放器
+    EVENT_BEAT            // 音乐节拍 (只在MusicMode采集期间产生并由它自己处理，见MusicMode.h)
 };
 
 // 模式类型定义
@@ -110,4 +113,5 @@ enum ModeType {
 // 事件消息结构
 struct EventMessage {
     EventType type;
+    uint32_t timestampUs;   // 事件发生时刻 (esp_timer微秒，按键为中断中采集的边沿时刻)
 }; 
\ No newline at end of file
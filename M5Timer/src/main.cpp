@@ -3,21 +3,23 @@
 #include "modes/TimerMode.h"
 #include "modes/ScreenMode.h"
 #include "modes/LightingMode.h"
-// #include "modes/MusicMode.h"
+#include "modes/MusicMode.h"
 #include "tasks/InputTask.h"
 #include "tasks/ModeTask.h"
 #include "core/LEDMatrix.h"
 #include "tasks/AudioTask.h"
+#include "core/MatchProfile.h"
 
 // 硬件引脚定义
 const uint8_t PIN_MP3_PLAYER = 26;  // MP3播放器控制引脚
 
 // 全局对象
 LEDMatrix ledMatrix;  // LED显示对象
+MatchProfileStore matchProfiles;  // 比赛配置表
 TimerMode timerMode;
 ScreenMode screenMode;
 LightingMode lightingMode;
-// MusicMode musicMode;
+MusicMode musicMode;
 
 // 全局队列句柄
 QueueHandle_t modeQueue;
@@ -47,9 +49,12 @@ void setup() {
     ledMatrix.begin();
     Serial.println("LED Matrix initialized");
     
+    // 读取比赛配置 (只在开机时读取一次)
+    matchProfiles.load();
+    
     // 创建消息队列
     modeQueue = xQueueCreate(5, sizeof(ModeMessage));
-    eventQueue = xQueueCreate(10, sizeof(EventType));
+    eventQueue = xQueueCreate(10, sizeof(EventMessage));
     audioQueue = xQueueCreate(10, sizeof(AudioMessage));
     Serial.println("Queues created");
     
@@ -76,7 +81,7 @@ void setup() {
     registerMode(&timerMode);
     registerMode(&screenMode);
     registerMode(&lightingMode);
-    // registerMode(&musicMode);
+    registerMode(&musicMode);
     initModeTask();
     Serial.println("Modes registered");
     
@@ -14,22 +14,52 @@ const uint32_t LightingMode::colorValues[5] = {
     0xFFFFFF   // 白色
 };
 
+// 静态颜色数量与全部选项数量 (静态颜色 + 动画灯效)
+#define STATIC_COLOR_COUNT 5
+#define LIGHTING_OPTION_COUNT 7
+
+// 呼吸灯: 白色在暗与亮之间往返
+static constexpr Keyframe BREATH_KEYS[] = {
+    {0,    0x101010, 0, 0, EASE_IN_OUT},
+    {1500, 0xFFFFFF, 0, 0, EASE_IN_OUT}
+};
+
+// 彩虹: 色相循环
+static constexpr Keyframe RAINBOW_KEYS[] = {
+    {0,    0xFF0000, 0, 0, EASE_LINEAR},
+    {1000, 0xFFFF00, 0, 0, EASE_LINEAR},
+    {2000, 0x00FF00, 0, 0, EASE_LINEAR},
+    {3000, 0x00FFFF, 0, 0, EASE_LINEAR},
+    {4000, 0x0000FF, 0, 0, EASE_LINEAR},
+    {5000, 0xFF00FF, 0, 0, EASE_LINEAR},
+    {6000, 0xFF0000, 0, 0, EASE_LINEAR}
+};
+
+static constexpr AnimationClip EFFECT_CLIPS[LIGHTING_OPTION_COUNT - STATIC_COLOR_COUNT] = {
+    {BREATH_KEYS, sizeof(BREATH_KEYS) / sizeof(BREATH_KEYS[0]), 1500, ANIM_PING_PONG},
+    {RAINBOW_KEYS, sizeof(RAINBOW_KEYS) / sizeof(RAINBOW_KEYS[0]), 6000, ANIM_LOOP}
+};
+
 // 颜色对应的名称
-const char* colorNames[5] = {
+const char* colorNames[LIGHTING_OPTION_COUNT] = {
     "Red",     // 红色
     "Yellow",  // 黄色
     "Blue",    // 蓝色
     "Green",   // 绿色
-    "White"    // 白色
+    "White",   // 白色
+    "Breath",  // 呼吸灯
+    "Rainbow"  // 彩虹
 };
 
 // 颜色对应的LCD颜色值 (16位RGB565格式)
-const uint16_t lcdColors[5] = {
+const uint16_t lcdColors[LIGHTING_OPTION_COUNT] = {
     0xF800,    // 红色
     0xFFE0,    // 黄色
     0x001F,    // 蓝色
     0x07E0,    // 绿色
-    0xFFFF     // 白色
+    0xFFFF,    // 白色
+    0xFFFF,    // 呼吸灯 (白色)
+    0xF81F     // 彩虹 (紫色)
 };
 
 LightingMode::LightingMode() : Mode("Lighting") {
@@ -48,6 +78,9 @@ void LightingMode::begin() {
     // 设置为最低亮度
     brightnessLevel = 0;
     
+    // 当前选项为动画灯效时从头播放
+    selectEffect();
+    
     // 更新LCD显示
     updateDisplay();
     
@@ -55,8 +88,7 @@ void LightingMode::begin() {
     updateLEDs();
     
     // 确保亮度设置生效
-    ledMatrix.getStrip().setBrightness(brightnessValues[brightnessLevel]);
-    ledMatrix.getStrip().show();
+    ledMatrix.setBrightness(brightnessValues[brightnessLevel]);
 }
 
 void LightingMode::update() {
@@ -64,16 +96,30 @@ void LightingMode::update() {
         updateDisplay();
         needDisplayUpdate = false;
     }
+    
+    // 动画灯效按经过的时间刷新
+    if (animation.isPlaying()) {
+        updateLEDs();
+    }
+}
+
+// 静态灯光只在按键时刷新，动画灯效在画面下一次变化时唤醒
+uint32_t LightingMode::nextDeadline() {
+    if (animation.isPlaying()) {
+        return animation.nextChangeMs(millis());
+    }
+    return MODE_NO_DEADLINE;
 }
 
 void LightingMode::exit() {
+    animation.stop();
+    
     // 清除LED矩阵
     ledMatrix.clear();
-    ledMatrix.update();
+    ledMatrix.present();
     
     // 恢复默认亮度
-    ledMatrix.getStrip().setBrightness(BRIGHTNESS);
-    ledMatrix.getStrip().show(); // 直接调用show确保亮度设置生效
+    ledMatrix.setBrightness(BRIGHTNESS);
 }
 
 void LightingMode::handleEvent(EventType event) {
@@ -86,8 +132,7 @@ void LightingMode::handleEvent(EventType event) {
             updateLEDs();
             
             // 然后设置亮度并立即显示 - 确保亮度设置不被覆盖
-            ledMatrix.getStrip().setBrightness(brightnessValues[brightnessLevel]);
-            ledMatrix.getStrip().show();
+            ledMatrix.setBrightness(brightnessValues[brightnessLevel]);
             
             Serial.print("Brightness changed to level ");
             Serial.print(brightnessLevel + 1);
@@ -101,20 +146,23 @@ void LightingMode::handleEvent(EventType event) {
             
         case EVENT_BUTTON_B:
             // 按B键切换颜色
-            colorIndex = (colorIndex + 1) % 5;
+            colorIndex = (colorIndex + 1) % LIGHTING_OPTION_COUNT;
+            selectEffect();
             
             Serial.print("Color changed to ");
             Serial.print(colorNames[colorIndex]);
-            Serial.print(" (0x");
-            Serial.print(colorValues[colorIndex], HEX);
-            Serial.println(")");
+            if (colorIndex < STATIC_COLOR_COUNT) {
+                Serial.print(" (0x");
+                Serial.print(colorValues[colorIndex], HEX);
+                Serial.print(")");
+            }
+            Serial.println();
             
             // 更新LED显示
             updateLEDs();
             
             // 确保亮度设置不被覆盖
-            ledMatrix.getStrip().setBrightness(brightnessValues[brightnessLevel]);
-            ledMatrix.getStrip().show();
+            ledMatrix.setBrightness(brightnessValues[brightnessLevel]);
             
             // 标记需要更新显示
             needDisplayUpdate = true;
@@ -167,8 +215,14 @@ void LightingMode::updateLEDs() {
     // 先清除所有像素
     // ledMatrix.clear();
     
-    // 获取当前选择的颜色
-    uint32_t currentColor = colorValues[colorIndex];
+    // 获取当前选择的颜色，动画灯效取当前时刻的颜色
+    uint32_t currentColor = 0;
+    AnimationSample sample;
+    if (colorIndex < STATIC_COLOR_COUNT) {
+        currentColor = colorValues[colorIndex];
+    } else if (animation.sample(millis(), &sample)) {
+        currentColor = sample.color;
+    }
     
     // 将所有LED设置为当前颜色
     for (int y = 0; y < 8; y++) {
@@ -178,5 +232,13 @@ void LightingMode::updateLEDs() {
     }
     
     // 只更新像素值，不更新亮度
-    ledMatrix.update();
-} 
\ No newline at end of file
+    ledMatrix.present();
+} 
+
+void LightingMode::selectEffect() {
+    if (colorIndex >= STATIC_COLOR_COUNT) {
+        animation.play(&EFFECT_CLIPS[colorIndex - STATIC_COLOR_COUNT], millis());
+    } else {
+        animation.stop();
+    }
+}
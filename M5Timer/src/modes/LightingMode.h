@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../core/Mode.h"
+#include "../core/Animation.h"
 
 class LightingMode : public Mode {
 public:
@@ -9,10 +10,12 @@ public:
     virtual void update() override;
     virtual void exit() override;
     virtual void handleEvent(EventType event) override;
+    virtual uint32_t nextDeadline() override;
     
 private:
     void updateDisplay();
     void updateLEDs();
+    void selectEffect();  // 切换到当前选项对应的动画 (静态颜色则停止动画)
     
     // 亮度等级 (0-9)
     uint8_t brightnessLevel;
@@ -24,6 +27,9 @@ private:
     uint8_t colorIndex;
     static const uint32_t colorValues[5];  // 红、黄、蓝、绿、白
     
+    // 动画灯效 (排在静态颜色之后)
+    AnimationPlayer animation;
+    
     // 是否需要更新显示
     bool needDisplayUpdate;
 }; 
\ No newline at end of file
@@ -1,9 +1,46 @@
 #include "MusicMode.h"
 #include "../core/LEDMatrix.h"
 #include <driver/i2s.h>
+#include <esp_timer.h>
+#include <math.h>
+
+// 频谱柱状图区域 (LCD右侧，每个频段一列，每行10像素)
+// LED矩阵的数据线与麦克风的PDM时钟都接在GPIO0，采集期间引脚归I2S所有，柱状图改画在LCD上
+#define BARS_X         168
+#define BARS_Y         55
+#define BAR_WIDTH      8
+#define BAR_PITCH      9
+#define BAR_ROW_HEIGHT 10
+#define PEAK_HEIGHT    2
+
+// 显示帧间隔 (约60帧/秒)
+#define MUSIC_FRAME_MS 16
+
+// 颜色名称所在行 (2号字高16像素)
+#define COLOR_NAME_Y   76
+#define TEXT_HEIGHT    16
+
+// 波形区域 (颜色名称下方到屏幕底部，与文字不重叠)
+#define SCOPE_X        0
+#define SCOPE_Y        (COLOR_NAME_Y + TEXT_HEIGHT + 2)
+#define SCOPE_WIDTH    160
+#define SCOPE_HEIGHT   (135 - SCOPE_Y)
+
+// 采集任务: 固定在核心0，优先级高于模式任务，及时取走DMA数据
+#define CAPTURE_STACK_SIZE 2048
+#define CAPTURE_PRIORITY   2
+#define CAPTURE_CORE       0
+#define CAPTURE_TIMEOUT_MS 100
+
+// 每个采集帧正好是一帧FFT
+static_assert(AUDIO_FRAME_SAMPLES == FFT_SIZE, "capture frame must hold one FFT frame");
+
+// 节拍闪烁: 柱状图颜色向白色混合，每个显示帧衰减的强度
+#define BEAT_PULSE_DECAY 32
 
 // 声明外部全局变量
 extern LEDMatrix ledMatrix;
+extern QueueHandle_t eventQueue;
 
 // 定义颜色值
 const uint32_t MusicMode::colorValues[5] = {
@@ -37,30 +74,44 @@ const float MusicMode::sensitivities[10] = {
     1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f
 };
 
-// 波形显示的旧Y值 (用于擦除)
-static uint16_t oldY[160] = {0};
-
-MusicMode::MusicMode() : Mode("Music") {
+MusicMode::MusicMode() : Mode("Music"),
+                         captureWorker("mic_capture", CAPTURE_STACK_SIZE, CAPTURE_PRIORITY, CAPTURE_CORE),
+                         beatDetector(SAMPLE_RATE, AUDIO_FRAME_SAMPLES) {
+    beatPulse = 0;
+    shownBarColor = 0;
+    memset(shownLevel, 0, sizeof(shownLevel));
+    memset(shownPeak, 0, sizeof(shownPeak));
     sensitivityLevel = 4;  // 默认中等灵敏度
     colorMode = 2;        // 默认蓝色
-    audioBuffer = (int16_t*)buffer;
+    lastRenderTime = 0;
+    memset(waveform, 0, sizeof(waveform));
+    memset(&stats, 0, sizeof(stats));
+    droppedAtBegin = 0;
 }
 
 void MusicMode::begin() {
     Serial.println("Entering Music Mode");
     
-    // 初始化LED矩阵
+    // 熄灭LED矩阵，等这一帧发完再把GPIO0交给麦克风时钟
     ledMatrix.begin();
     ledMatrix.clear();
-    ledMatrix.update();
+    ledMatrix.present();
+    ledMatrix.waitForOutput(pdMS_TO_TICKS(10));
     
-    // 初始化绘图区域
-    for (int i = 0; i < 8; i++) {
-        oldValues[i] = 0;
-    }
+    // 清除上一次的频谱、节拍状态与采集统计
+    spectrum.reset();
+    beatDetector.reset();
+    beatPulse = 0;
+    captureQueue.clear();
+    droppedAtBegin = captureQueue.dropped();  // 丢弃计数只增不减，本次会话从这里算起
+    memset(waveform, 0, sizeof(waveform));
+    memset(&stats, 0, sizeof(stats));
+    memset(shownLevel, 0, sizeof(shownLevel));
+    memset(shownPeak, 0, sizeof(shownPeak));
+    lastRenderTime = millis();
     
     // 初始化I2S - 直接使用用户示例代码的方法
-    i2sInit();
+    bool i2sReady = i2sInit();
     
     // 在LCD上显示当前模式
     M5.Lcd.fillScreen(BLACK);
@@ -72,35 +123,81 @@ void MusicMode::begin() {
     M5.Lcd.printf("Level: %d", sensitivityLevel);
     M5.Lcd.setCursor(0, 60);
     M5.Lcd.println("B: Color");
+    M5.Lcd.setCursor(0, COLOR_NAME_Y);
     M5.Lcd.setTextColor(audioLcdColors[colorMode]);
     M5.Lcd.println(audioColorNames[colorMode]);
     
-    // 创建任务用于音频处理
-    xTaskCreate(
-        micRecordTask,    // 任务函数
-        "mic_record_task", // 任务名称
-        2048,             // 堆栈大小
-        this,             // 参数 (传递this指针)
-        1,                // 优先级
-        NULL              // 任务句柄
-    );
+    // 屏幕已清空，波形区域整块重绘
+    scope.begin(SCOPE_X, SCOPE_Y, SCOPE_WIDTH, SCOPE_HEIGHT);
+    
+    // 启动采集任务
+    if (i2sReady) {
+        captureWorker.start(captureFrame, this);
+    }
 }
 
 void MusicMode::update() {
-    // 注意：主要处理逻辑已移至micRecordTask
-    // 此函数只处理非音频相关的更新
-    delay(10);  // 短暂延迟，避免过快循环
+    // 分析所有已采集的帧，每个采样都参与频谱计算
+    uint32_t backlog = 0;
+    const int16_t* frame;
+    while ((frame = captureQueue.peek()) != NULL) {
+        processFrame(frame);
+        captureQueue.pop();
+        backlog++;
+    }
+    if (backlog > stats.maxBacklog) {
+        stats.maxBacklog = backlog;
+    }
+    
+    // 按固定帧率刷新显示
+    unsigned long now = millis();
+    if (now - lastRenderTime < MUSIC_FRAME_MS) return;
+    lastRenderTime = now;
+    
+    spectrum.advance();
+    showWaveform();
+    drawSpectrum();
+}
+
+// 到下一个显示帧的时间
+uint32_t MusicMode::nextDeadline() {
+    unsigned long elapsed = millis() - lastRenderTime;
+    return elapsed >= MUSIC_FRAME_MS ? 0 : MUSIC_FRAME_MS - elapsed;
+}
+
+// 获取采集与处理统计
+void MusicMode::getStats(MusicCaptureStats* out) const {
+    *out = stats;
+    out->framesDropped = captureQueue.dropped() - droppedAtBegin;
 }
 
 void MusicMode::exit() {
     Serial.println("Exiting Music Mode");
     
-    // 关闭I2S
-    i2s_driver_uninstall(I2S_PORT);
+    // 先停止采集任务，确认不再调用i2s_read后再关闭I2S
+    if (captureWorker.stop()) {
+        i2s_driver_uninstall(I2S_PORT);
+    } else {
+        Serial.println("MusicMode: 采集任务未退出，保留I2S驱动");
+    }
+    
+    // I2S卸载后GPIO0仍连接着I2S时钟信号，把引脚交还给LED的RMT通道
+    ledMatrix.begin();
+    
+    // 输出采集统计
+    MusicCaptureStats captureStats;
+    getStats(&captureStats);
+    Serial.printf("MusicMode: 分析 %lu帧, 丢弃 %lu帧, 最大积压 %lu帧, 平均分析 %luus, 最长 %luus\n",
+                  (unsigned long)captureStats.framesProcessed, (unsigned long)captureStats.framesDropped,
+                  (unsigned long)captureStats.maxBacklog,
+                  (unsigned long)(captureStats.framesProcessed ? captureStats.processUsTotal / captureStats.framesProcessed : 0),
+                  (unsigned long)captureStats.processUsMax);
+    Serial.printf("MusicMode: 起音 %lu次, 节拍 %lu次, 速度 %u BPM\n",
+                  (unsigned long)captureStats.onsets, (unsigned long)captureStats.beats, beatDetector.bpm());
     
-    // 清除LED矩阵
+    // 熄灭LED矩阵 (采集期间LED上可能锁存了时钟信号形成的随机颜色)
     ledMatrix.clear();
-    ledMatrix.update();
+    ledMatrix.present();
 }
 
 void MusicMode::handleEvent(EventType event) {
@@ -122,17 +219,22 @@ void MusicMode::handleEvent(EventType event) {
             colorMode = (colorMode + 1) % 5;
             Serial.printf("Color changed to: %s\n", audioColorNames[colorMode]);
             
-            // 更新LCD显示
-            M5.Lcd.fillRect(0, 80, 160, 20, BLACK);
-            M5.Lcd.setCursor(0, 80);
+            // 更新LCD显示 (只重画颜色名称所在行，不触及波形区域)
+            M5.Lcd.fillRect(0, COLOR_NAME_Y, SCOPE_WIDTH, TEXT_HEIGHT, BLACK);
+            M5.Lcd.setCursor(0, COLOR_NAME_Y);
             M5.Lcd.setTextColor(audioLcdColors[colorMode]);
             M5.Lcd.println(audioColorNames[colorMode]);
             break;
+            
+        case EVENT_BEAT:
+            // 节拍: 柱状图闪白
+            beatPulse = 255;
+            break;
     }
 }
 
 // I2S初始化函数 - 直接从用户示例中移植
-void MusicMode::i2sInit() {
+bool MusicMode::i2sInit() {
     i2s_config_t i2s_config = {
         .mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_RX | I2S_MODE_PDM),
         .sample_rate = 44100,
@@ -140,8 +242,8 @@ void MusicMode::i2sInit() {
         .channel_format = I2S_CHANNEL_FMT_ALL_RIGHT,
         .communication_format = I2S_COMM_FORMAT_STAND_I2S,
         .intr_alloc_flags = ESP_INTR_FLAG_LEVEL1,
-        .dma_buf_count = 2,
-        .dma_buf_len = 128,
+        .dma_buf_count = 4,     // DMA缓冲约23ms，覆盖采集任务的调度抖动
+        .dma_buf_len = 256,
     };
 
     i2s_pin_config_t pin_config;
@@ -151,106 +253,122 @@ void MusicMode::i2sInit() {
 #endif
 
     pin_config.bck_io_num = I2S_PIN_NO_CHANGE;
-    pin_config.ws_io_num = 0;  // PIN_CLK
+    pin_config.ws_io_num = LED_PIN;  // PIN_CLK，与LED数据线共用GPIO0
     pin_config.data_out_num = I2S_PIN_NO_CHANGE;
     pin_config.data_in_num = 34;  // PIN_DATA
 
-    i2s_driver_install(I2S_PORT, &i2s_config, 0, NULL);
+    if (i2s_driver_install(I2S_PORT, &i2s_config, 0, NULL) != ESP_OK) {
+        Serial.println("MusicMode: I2S驱动安装失败");
+        return false;
+    }
     i2s_set_pin(I2S_PORT, &pin_config);
     i2s_set_clk(I2S_PORT, 44100, I2S_BITS_PER_SAMPLE_16BIT, I2S_CHANNEL_MONO);
+    return true;
 }
 
-// 麦克风记录任务 - 在独立任务中运行，类似用户示例
-void MusicMode::micRecordTask(void* arg) {
+// 麦克风采集 - 读取一帧DMA数据放入队列，不做任何处理，由ModeWorker循环调用
+void MusicMode::captureFrame(void* arg) {
     MusicMode* mode = (MusicMode*)arg;
-    size_t bytesRead;
+    static int16_t discard[AUDIO_FRAME_SAMPLES];  // 队列满时读出并丢弃，避免DMA溢出
+    size_t bytesRead = 0;
     
-    while (1) {
-        // 读取I2S数据 - 需要通过指针访问
-        i2s_read(I2S_NUM_0, (char*)mode->buffer, mode->READ_LEN, &bytesRead, 
-                 (100 / portTICK_RATE_MS));
-        
-        // 通过指针调用方法
-        mode->showWaveform();
-        mode->processAudio();
-        mode->updateLEDs();
-        
-        // 添加延迟，避免过快更新
-        vTaskDelay(100 / portTICK_RATE_MS);
+    int16_t* frame = mode->captureQueue.beginWrite();
+    bool queued = frame != NULL;
+    if (!queued) {
+        frame = discard;
+    }
+    
+    // 阻塞到DMA填满一帧，超时后返回以便检查停止请求
+    i2s_read(I2S_PORT, (char*)frame, AUDIO_FRAME_BYTES, &bytesRead, pdMS_TO_TICKS(CAPTURE_TIMEOUT_MS));
+    
+    // 超时或没有读满的帧不完整，放弃并计入丢弃 (队列满时beginWrite()已经计过)
+    if (queued) {
+        if (bytesRead == AUDIO_FRAME_BYTES) {
+            mode->captureQueue.commitWrite();
+        } else {
+            mode->captureQueue.abortWrite();
+        }
     }
 }
 
-void MusicMode::processAudio() {
-    // 将音频数据分成8段
-    int segmentSize = READ_LEN / 2 / 8;  // 每个段的大小
+// 分析一帧采样并记录耗时
+void MusicMode::processFrame(const int16_t* frame) {
+    int64_t startUs = esp_timer_get_time();
     
-    for (int i = 0; i < 8; i++) {
-        // 计算当前段的平均能量
-        long sum = 0;
-        
-        for (int j = 0; j < segmentSize; j++) {
-            int index = i * segmentSize + j;
-            if (index < READ_LEN/2) {
-                int16_t sample = audioBuffer[index];
-                sum += abs(sample);
-            }
+    // 幅度增益换算成功率增益的log2值 (Q8)
+    float gain = GAIN_FACTOR * sensitivities[sensitivityLevel];
+    int32_t gainQ8 = (int32_t)(log2f(gain) * 2.0f * 256.0f);
+    spectrum.process(frame, gainQ8);
+    
+    // 节拍检测，节拍通过事件队列通知当前模式
+    uint8_t beatFlags = beatDetector.process(spectrum.bandLevels(), SPECTRUM_BANDS);
+    if (beatFlags & BEAT_FLAG_ONSET) {
+        stats.onsets++;
+    }
+    if ((beatFlags & BEAT_FLAG_BEAT) && eventQueue != NULL) {
+        EventMessage eventMsg;
+        eventMsg.type = EVENT_BEAT;
+        eventMsg.timestampUs = (uint32_t)startUs;
+        if (xQueueSend(eventQueue, &eventMsg, 0) == pdTRUE) {
+            stats.beats++;
         }
-        
-        // 计算平均能量并应用增益
-        float avgEnergy = (float)sum / segmentSize;
-        avgEnergy *= GAIN_FACTOR * sensitivities[sensitivityLevel];
-        
-        // 映射到LED高度 (1-7)
-        int height = map(avgEnergy, 0, 32767, 1, 7);
-        height = constrain(height, 1, 7);
-        
-        // 平滑处理
-        height = (oldValues[i] * 0.7f) + (height * 0.3f);
-        oldValues[i] = height;
+    }
+    
+    // 保留最近一帧用于绘制波形
+    memcpy(waveform, frame, sizeof(waveform));
+    
+    uint32_t elapsedUs = (uint32_t)(esp_timer_get_time() - startUs);
+    stats.framesProcessed++;
+    stats.processUsTotal += elapsedUs;
+    if (elapsedUs > stats.processUsMax) {
+        stats.processUsMax = elapsedUs;
     }
 }
 
-void MusicMode::updateLEDs() {
-    // 清除LED
-    ledMatrix.clear();
-    
-    // 获取当前选择的颜色
+// 在LCD上绘制频谱柱状图，只重画行高、峰值或颜色变化的列
+void MusicMode::drawSpectrum() {
+    // 获取当前选择的颜色，节拍时向白色混合
     uint32_t currentColor = colorValues[colorMode];
+    if (beatPulse > 0) {
+        uint32_t mixed = 0;
+        for (int shift = 0; shift <= 16; shift += 8) {
+            uint32_t c = (currentColor >> shift) & 0xFF;
+            c += ((255 - c) * beatPulse) >> 8;
+            mixed |= c << shift;
+        }
+        currentColor = mixed;
+        beatPulse = beatPulse > BEAT_PULSE_DECAY ? beatPulse - BEAT_PULSE_DECAY : 0;
+    }
+    uint16_t barColor = M5.Lcd.color565((currentColor >> 16) & 0xFF, (currentColor >> 8) & 0xFF, currentColor & 0xFF);
     
-    // 为每列绘制音频柱状图
-    for (int x = 0; x < 8; x++) {
-        int height = oldValues[x];
+    // 低频在左，从底部向上绘制
+    for (int band = 0; band < SPECTRUM_BANDS; band++) {
+        uint8_t height = spectrum.level(band);
+        uint8_t peak = spectrum.peak(band);
+        if (height == shownLevel[band] && peak == shownPeak[band] &&
+            (height == 0 || barColor == shownBarColor)) {
+            continue;
+        }
         
-        // 从底部开始绘制每一列
-        for (int y = 7; y >= (8 - height); y--) {
-            ledMatrix.setPixel(x, y, currentColor);
+        // 柱顶以上填背景，柱体用当前颜色，不先整列清空避免闪烁
+        int x = BARS_X + band * BAR_PITCH;
+        int top = BARS_Y + (SPECTRUM_ROWS - height) * BAR_ROW_HEIGHT;
+        M5.Lcd.fillRect(x, BARS_Y, BAR_WIDTH, top - BARS_Y, BLACK);
+        if (height > 0) {
+            M5.Lcd.fillRect(x, top, BAR_WIDTH, height * BAR_ROW_HEIGHT, barColor);
         }
+        
+        // 峰值线画在柱顶上方
+        if (peak > height) {
+            M5.Lcd.fillRect(x, BARS_Y + (SPECTRUM_ROWS - peak) * BAR_ROW_HEIGHT, BAR_WIDTH, PEAK_HEIGHT, WHITE);
+        }
+        shownLevel[band] = height;
+        shownPeak[band] = peak;
     }
-    
-    // 更新LED显示
-    ledMatrix.update();
+    shownBarColor = barColor;
 }
 
 void MusicMode::showWaveform() {
-    // 完全模仿用户示例代码的方式绘制波形
-    int y;
-    for (int n = 0; n < 160; n++) {
-        // 只处理LCD宽度内的像素
-        if (n < 160) {
-            // 获取并放大音频数据
-            y = audioBuffer[n] * GAIN_FACTOR;
-            
-            // 映射到LCD坐标
-            y = map(y, INT16_MIN, INT16_MAX, 110-25, 110+25);
-            
-            // 擦除旧点
-            M5.Lcd.drawPixel(n, oldY[n], BLACK);
-            
-            // 绘制新点
-            M5.Lcd.drawPixel(n, y, audioLcdColors[colorMode]);
-            
-            // 记录当前点位置
-            oldY[n] = y;
-        }
-    }
-} 
\ No newline at end of file
+    // 整帧采样按列压缩后一次推送
+    scope.draw(waveform, AUDIO_FRAME_SAMPLES, GAIN_FACTOR, audioLcdColors[colorMode], BLACK);
+}
@@ -1,10 +1,34 @@
 #pragma once
 
 #include "../core/Mode.h"
+#include "../core/Spectrum.h"
+#include "../core/AudioFrameQueue.h"
+#include "../core/ModeWorker.h"
+#include "../core/LcdScopeRenderer.h"
+#include "../core/BeatDetector.h"
 #include <M5Unified.h>
 #include <driver/i2s.h>
 
+// 采集与处理统计
+struct MusicCaptureStats {
+    uint32_t framesProcessed;  // 已分析的采集帧数
+    uint32_t framesDropped;    // 队列满或没有读满被丢弃的采集帧数
+    uint32_t maxBacklog;       // 一个显示帧内处理的最大积压帧数
+    uint32_t processUsTotal;   // 分析耗时累计 (微秒)
+    uint32_t processUsMax;     // 单帧最大分析耗时 (微秒，含节拍检测)
+    uint32_t onsets;           // 检测到的起音数
+    uint32_t beats;            // 发出的节拍事件数
+};
+
 // 音频可视化模式
+// 采集任务连续读取I2S的DMA数据，整帧放入无锁队列；模式任务取出全部帧做频谱分析，
+// 并按固定帧率刷新LED与LCD，采集与显示互不等待。
+// 采集任务只在模式激活期间运行，退出时先停止任务再卸载I2S驱动。
+// 分析时同时检测节拍，以EVENT_BEAT发送到事件队列。
+// 麦克风时钟与LED矩阵共用GPIO0，采集期间LED不可用，频谱柱状图画在LCD上；
+// 退出时卸载I2S后把引脚交还给LED。
+// 因此节拍只在本模式内使用 (柱状图闪白): LightingMode与ScreenMode都要驱动LED矩阵，
+// 无法同时采集音频，不订阅节拍; 模式切换后队列中残留的EVENT_BEAT会被其他模式忽略。
 class MusicMode : public Mode {
 public:
     MusicMode();
@@ -12,27 +36,47 @@ public:
     void update() override;
     void exit() override;
     void handleEvent(EventType event) override;
+    uint32_t nextDeadline() override;
     
-    // I2S相关静态方法
-    static void micRecordTask(void* arg);
-    
-    // 音频处理 - 需要在任务中访问
-    void processAudio();
-    void updateLEDs();
-    void showWaveform();
+    // 获取采集与处理统计
+    void getStats(MusicCaptureStats* stats) const;
     
-    // I2S配置 - 需要在任务中访问
+    // I2S配置
     static const i2s_port_t I2S_PORT = I2S_NUM_0;
     static const int SAMPLE_RATE = 44100;
-    static const int READ_LEN = 2 * 256;
     static const int GAIN_FACTOR = 3;
     
-    // 音频缓冲区 - 需要在任务中访问
-    uint8_t buffer[READ_LEN];
-    
 private:
-    int16_t *audioBuffer;
-    int16_t oldValues[8];  // 用于存储上一帧的LED高度
+    // 采集任务每次读取一帧 (带超时，保证能及时响应停止请求)
+    static void captureFrame(void* arg);
+    
+    void processFrame(const int16_t* frame);
+    void drawSpectrum();
+    void showWaveform();
+    
+    // 采集任务与帧队列 (采集任务 -> 模式任务)
+    ModeWorker captureWorker;
+    AudioFrameQueue captureQueue;
+    
+    // 频谱柱状图 (行高与峰值) 与节拍检测
+    SpectrumAnalyzer spectrum;
+    BeatDetector beatDetector;
+    uint8_t beatPulse;          // 节拍闪烁强度 (0-255)，每个显示帧衰减
+    
+    // LCD上已绘制的柱状图，只重画变化的列
+    uint8_t shownLevel[SPECTRUM_BANDS];
+    uint8_t shownPeak[SPECTRUM_BANDS];
+    uint16_t shownBarColor;
+    
+    // 最近一帧的采样与波形渲染器
+    int16_t waveform[AUDIO_FRAME_SAMPLES];
+    LcdScopeRenderer scope;
+    
+    // 显示帧率控制
+    unsigned long lastRenderTime;
+    
+    MusicCaptureStats stats;
+    uint32_t droppedAtBegin;   // 进入模式时队列的累计丢弃数
     
     // 显示参数
     uint8_t sensitivityLevel;   // 麦克风灵敏度等级 (0-9)
@@ -45,5 +89,5 @@ private:
     static const float sensitivities[10];  // 灵敏度级别
     
     // I2S相关方法
-    void i2sInit();
-}; 
\ No newline at end of file
+    bool i2sInit();
+}; 
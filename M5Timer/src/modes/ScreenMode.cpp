@@ -1,12 +1,34 @@
 #include "ScreenMode.h"
 #include <M5Unified.h>
 #include "../core/LEDMatrix.h"
+#include "../tasks/ModeTask.h"
 
 // 声明外部全局变量
 extern LEDMatrix ledMatrix;
 
-// 定义动画帧数
-const int ANIMATION_FRAMES = 16;  // 16个不同的帧，每行按顺序轮换
+// 测试动画: 每行一种颜色，每200ms向上移动一行，16帧一个周期
+// 关键帧的y为颜色偏移量，阶跃播放
+static constexpr Keyframe TEST_SCROLL_KEYS[] = {
+    {   0, 0, 0,  0, EASE_STEP},
+    { 200, 0, 0,  1, EASE_STEP},
+    { 400, 0, 0,  2, EASE_STEP},
+    { 600, 0, 0,  3, EASE_STEP},
+    { 800, 0, 0,  4, EASE_STEP},
+    {1000, 0, 0,  5, EASE_STEP},
+    {1200, 0, 0,  6, EASE_STEP},
+    {1400, 0, 0,  7, EASE_STEP},
+    {1600, 0, 0,  8, EASE_STEP},
+    {1800, 0, 0,  9, EASE_STEP},
+    {2000, 0, 0, 10, EASE_STEP},
+    {2200, 0, 0, 11, EASE_STEP},
+    {2400, 0, 0, 12, EASE_STEP},
+    {2600, 0, 0, 13, EASE_STEP},
+    {2800, 0, 0, 14, EASE_STEP},
+    {3000, 0, 0, 15, EASE_STEP},
+};
+static constexpr AnimationClip TEST_SCROLL_CLIP = {
+    TEST_SCROLL_KEYS, sizeof(TEST_SCROLL_KEYS) / sizeof(TEST_SCROLL_KEYS[0]), 3200, ANIM_LOOP
+};
 
 // 全局 ScreenMode 实例指针
 static ScreenMode* screenModeInstance = nullptr;
@@ -29,13 +51,15 @@ static ScreenMode* screenModeInstance = nullptr;
 #define NEOPIXEL_LPINK   0xFFB6C1
 #define NEOPIXEL_GRAY    0x808080
 
-#define FRAME_HEADER 0xAA
-#define FRAME_TAIL 0x55
-#define FRAME_LENGTH 66  // 帧头(1) + 数据(64) + 校验和(1)
+// 协议应答直接写回串口
+static void writeReply(const char* line, void* context) {
+    Serial.print(line);
+}
 
 ScreenMode::ScreenMode() : Mode("Screen") {
     // 保存实例指针
     screenModeInstance = this;
+    receiver.setReplyHandler(writeReply, NULL);
     
     // 初始化颜色映射表 - 使用24位RGB值
     colorMap[0] = NEOPIXEL_BLACK;   // 0: 黑色（关闭）
@@ -61,9 +85,6 @@ ScreenMode::ScreenMode() : Mode("Screen") {
     // 初始化动画参数
     isTestMode = false;
     currentFrame = 0;
-    animationStartTime = 0;
-    frameIntervalMs = 200; // 200ms 每帧
-    lastFrameTime = 0;
 }
 
 void ScreenMode::begin() {
@@ -74,7 +95,7 @@ void ScreenMode::begin() {
     
     // 清空矩阵
     ledMatrix.clear();
-    ledMatrix.update();
+    ledMatrix.present();
     Serial.println("LED矩阵已初始化并清空");
     
     // 初始化屏幕数据
@@ -92,49 +113,53 @@ void ScreenMode::update() {
     // 处理串行数据命令
     parseSerialData();
     
+    // 到达显示命令指定的时刻
+    if (receiver.presentDue(millis())) {
+        showReceivedFrame();
+    }
+    
     if (isTestMode) {
-        // 更新动画帧
-        unsigned long currentTime = millis();
-        if (currentTime - lastFrameTime >= frameIntervalMs) {
-            lastFrameTime = currentTime;
-            currentFrame = (currentFrame + 1) % ANIMATION_FRAMES;
-            
-            // 生成并显示动画帧
-            generateFrameData();
+        // 按经过的时间求当前帧，帧号变化时才生成新画面
+        AnimationSample sample;
+        if (testAnimation.sample(millis(), &sample)) {
+            int frame = (sample.yQ8 >> 8) & 0x0F;
+            if (frame != currentFrame) {
+                currentFrame = frame;
+                generateFrameData();
+            }
         }
     }
 }
 
+// 测试动画按帧间隔刷新，否则等待串口数据事件
+uint32_t ScreenMode::nextDeadline() {
+    uint32_t deadline = MODE_NO_DEADLINE;
+    unsigned long now = millis();
+    
+    if (isTestMode) {
+        deadline = testAnimation.nextChangeMs(now);
+    }
+    uint32_t presentDeadline = receiver.deadlineMs(now);
+    if (presentDeadline < deadline) deadline = presentDeadline;
+    return deadline;
+}
+
 void ScreenMode::exit() {
     // 清除显示
     ledMatrix.clear();
-    ledMatrix.update();
+    ledMatrix.present();
 }
 
 void ScreenMode::handleEvent(EventType event) {
     switch (event) {
         case EVENT_BUTTON_A:
             // 按A键切换测试模式
-            isTestMode = !isTestMode;
-            if (isTestMode) {
-                animationStartTime = millis();
-                lastFrameTime = animationStartTime;
-                currentFrame = 0;
-                
-                // 更新显示文本
-                M5.Display.fillScreen(BLACK);
-                M5.Display.setTextColor(WHITE, BLACK);
-                M5.Display.setTextSize(2);
-                M5.Display.setCursor(10, 10);
-                M5.Display.println("Screen Mode");
-                M5.Display.setCursor(10, 40);
-                M5.Display.println("Test Mode");
-                
-                // 立即显示第一帧
-                generateFrameData();
+            if (!isTestMode) {
+                startTestMode();
             } else {
+                isTestMode = false;
                 ledMatrix.clear();
-                ledMatrix.update();
+                ledMatrix.present();
                 
                 // 更新显示文本
                 M5.Display.fillScreen(BLACK);
@@ -167,7 +192,7 @@ void ScreenMode::updateDisplay() {
     }
     
     // 更新LED矩阵显示
-    ledMatrix.update();
+    ledMatrix.present();
 }
 
 void ScreenMode::generateFrameData() {
@@ -196,116 +221,47 @@ void ScreenMode::generateFrameData() {
 }
 
 void ScreenMode::parseSerialData() {
-    if (Serial.available() > 0) {
-        // 检查是否是二进制数据（以0xAA开头）
-        if (Serial.peek() == FRAME_HEADER) {
-            parseSerialBinaryData();
-        } else {
-            parseSerialTextData();
-        }
+    ByteRing& ring = getSerialRxRing();
+    uint8_t chunk[64];
+    size_t length;
+    
+    // 逐块取出已接收的数据交给协议分发，不等待不完整的行或帧
+    while ((length = ring.read(chunk, sizeof(chunk))) > 0) {
+        receiver.push(chunk, length, millis());
     }
-}
-
-void ScreenMode::parseSerialBinaryData() {
-    static uint8_t buffer[FRAME_LENGTH];
-    static int bufferIndex = 0;
-    static bool frameStarted = false;
+    uint8_t events = receiver.finish();
     
-    while (Serial.available() > 0) {
-        uint8_t inByte = Serial.read();
-        
-        // 检测帧头
-        if (!frameStarted && inByte == FRAME_HEADER) {
-            frameStarted = true;
-            bufferIndex = 0;
-            continue;
-        }
-        
-        if (frameStarted) {
-            buffer[bufferIndex++] = inByte;
-            
-            // 检查是否接收到完整帧
-            if (bufferIndex == FRAME_LENGTH) {
-                // 验证校验和
-                uint8_t checksum = 0;
-                for (int i = 0; i < FRAME_LENGTH - 1; i++) {
-                    checksum ^= buffer[i];  // 使用异或作为简单的校验方式
-                }
-                
-                // 如果校验和正确
-                if (checksum == buffer[FRAME_LENGTH - 1]) {
-                    // 更新屏幕数据
-                    for (int y = 0; y < 8; y++) {
-                        for (int x = 0; x < 8; x++) {
-                            screenData[y][x] = buffer[y * 8 + x] & 0x0F;  // 确保值在0-15范围内
-                        }
-                    }
-                    // 更新显示
-                    updateDisplay();
-                }
-                
-                // 重置接收状态
-                frameStarted = false;
-                bufferIndex = 0;
-            }
-        }
+    if (events & SCREEN_RX_TEST) {
+        startTestMode();
+    }
+    
+    // 一次收到多帧时只刷新一次
+    if (events & SCREEN_RX_DISPLAY) {
+        showReceivedFrame();
     }
 }
 
-void ScreenMode::parseSerialTextData() {
-    String data = Serial.readStringUntil('\n');
-    data.trim();
+// 显示串口收到的画面
+void ScreenMode::showReceivedFrame() {
+    memcpy(screenData, receiver.pixels(), sizeof(screenData));
+    updateDisplay();
+}
+
+void ScreenMode::startTestMode() {
+    // 启动测试模式
+    isTestMode = true;
+    testAnimation.play(&TEST_SCROLL_CLIP, millis());
+    currentFrame = 0;
     
-    // 处理命令字符串
-    if (data.startsWith("TEST")) {
-        // 启动测试模式
-        isTestMode = true;
-        animationStartTime = millis();
-        lastFrameTime = animationStartTime;
-        currentFrame = 0;
-        
-        // 更新显示文本
-        M5.Display.fillScreen(BLACK);
-        M5.Display.setTextColor(WHITE, BLACK);
-        M5.Display.setTextSize(2);
-        M5.Display.setCursor(10, 10);
-        M5.Display.println("Screen Mode");
-        M5.Display.setCursor(10, 40);
-        M5.Display.println("Test Mode");
-        
-        // 立即显示第一帧
-        generateFrameData();
-    }
-    else if (data.startsWith("SCREEN:")) {
-        // 解析屏幕数据格式：SCREEN:0,1,2,...
-        String payload = data.substring(7); // 跳过"SCREEN:"前缀
-        int index = 0;
-        int startPos = 0;
-        int commaPos;
-        
-        while ((commaPos = payload.indexOf(',', startPos)) != -1 && index < 64) {
-            String valueStr = payload.substring(startPos, commaPos);
-            int value = valueStr.toInt();
-            
-            int y = index / 8;
-            int x = index % 8;
-            screenData[y][x] = value & 0x0F; // 确保值在0-15范围内
-            
-            startPos = commaPos + 1;
-            index++;
-        }
-        
-        // 处理最后一个值
-        if (index < 64) {
-            String valueStr = payload.substring(startPos);
-            int value = valueStr.toInt();
-            
-            int y = index / 8;
-            int x = index % 8;
-            screenData[y][x] = value & 0x0F;
-        }
-        
-        // 更新显示
-        updateDisplay();
-    }
-} 
\ No newline at end of file
+    // 更新显示文本
+    M5.Display.fillScreen(BLACK);
+    M5.Display.setTextColor(WHITE, BLACK);
+    M5.Display.setTextSize(2);
+    M5.Display.setCursor(10, 10);
+    M5.Display.println("Screen Mode");
+    M5.Display.setCursor(10, 40);
+    M5.Display.println("Test Mode");
+    
+    // 立即显示第一帧
+    generateFrameData();
+}
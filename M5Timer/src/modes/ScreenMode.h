@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../core/Mode.h"
+#include "../core/ScreenReceiver.h"
+#include "../core/Animation.h"
 
 class ScreenMode : public Mode {
 public:
@@ -9,23 +11,24 @@ public:
     virtual void update() override;
     virtual void exit() override;
     virtual void handleEvent(EventType event) override;
+    virtual uint32_t nextDeadline() override;
     
 private:
     void updateDisplay();
     void generateFrameData();  // 生成并打印当前帧数据
     void parseSerialData();
-    void parseSerialBinaryData();  // 添加二进制数据解析方法声明
-    void parseSerialTextData();    // 添加文本数据解析方法声明
+    void startTestMode();      // 开始测试动画
+    void showReceivedFrame();  // 显示串口收到的画面
     
     // 屏幕数据
     uint8_t screenData[8][8];
     // 颜色字典 - 存储颜色编号对应的颜色值
     uint32_t colorMap[16];
+    // 串口协议分发 - 解析帧与命令，缓存延迟显示的帧 (收到显示命令或到达指定的本机时刻才显示，
+    // 使多块屏幕同时切换)，并生成SYNC/ACK/KEY应答
+    ScreenReceiver receiver;
     
-    unsigned long animationStartTime;
-    unsigned long lastFrameTime;
     bool isTestMode;          // 是否显示测试动画
-    int testDurationMs;       // 测试动画持续时间（毫秒）
-    int frameIntervalMs;      // 帧间隔（毫秒）
+    AnimationPlayer testAnimation;  // 测试动画播放器
     int currentFrame;         // 当前帧
 }; 
\ No newline at end of file
@@ -1,12 +1,13 @@
 #include "TimerMode.h"
 #include <M5Unified.h>
-#include <math.h>  // 添加数学库以使用ceil()函数
 #include "../core/LEDMatrix.h"
 #include "../core/Player.h"
+#include "../core/CueScheduler.h"
 #include "../tasks/AudioTask.h"
 
 // 声明外部全局变量
 extern LEDMatrix ledMatrix;
+extern MatchProfileStore matchProfiles;
 
 // 添加播放器引脚定义
 #define PIN_MP3_PLAYER     26      // MP3播放器控制引脚
@@ -17,6 +18,22 @@ extern LEDMatrix ledMatrix;
 #define LED_DIM_BRIGHT     3        // 调暗亮度 (约1%)
 #define LED_SOUND_BRIGHT   25       // 声音播放时的亮度 (10%)
 
+// 倒计时剩余0.6秒时播放开始声音 (计时时长与倒计时时长由比赛配置决定)
+#define COUNTDOWN_END_SOUND_US 600000
+
+// 开始前的提示声音: 选曲命令发完1秒后开始倒计时，音频任务0.5秒内没有回报则按请求时刻计算
+#define PREROLL_TRACK          1
+#define PREROLL_LEAD_US        1000000
+#define PREROLL_TIMEOUT_US     500000
+
+// 事件时间戳的最大可信时长，超过则认为时间戳无效，按处理时刻计算
+#define EVENT_MAX_AGE_US       1000000
+
+// LED警示边框 (最后几秒由比赛配置决定)
+#define WARNING_FLASH_MS   250      // 边框闪烁半周期
+#define WARNING_COLOR      0xFFFFFF // 白色
+#define WARNING_ALPHA      128      // 半透明叠加在数字上
+
 // UI相关常量 - 调整为适应135x240的屏幕
 #define INFO_BAR_Y         100      // 信息条Y坐标
 #define INFO_BAR_HEIGHT    35       // 信息条高度
@@ -28,6 +45,12 @@ extern LEDMatrix ledMatrix;
 #define TIME_DISPLAY_WIDTH  180     // 时间显示宽度区域
 #define VERSION_TEXT       "v1.0"   // 版本号文本
 
+// 时间数字单元: "SS.HH"，沿用原来的文本位置 (秒数个位被小数点单元覆盖的两列不显示)
+static const uint8_t TIME_CELL_WIDTHS[] = {36, 28, 36, 36, 36};
+
+// 三位秒数 "SSS.HH": 收窄字符间距和小数点单元，总宽度不超过时间显示区域
+static const uint8_t TIME_CELL_WIDTHS_WIDE[] = {32, 32, 32, 20, 32, 32};
+
 // 定义常用颜色
 #define BLACK 0x0000
 #define WHITE 0xFFFF
@@ -56,26 +79,40 @@ const uint32_t LED_PHASE2_COLOR = 0xFFFF00;  // 黄色 (35-25秒)
 const uint32_t LED_PHASE3_COLOR = 0x0000FF;  // 蓝色 (25-10秒)
 const uint32_t LED_PHASE4_COLOR = 0xFF0000;  // 红色 (10-0秒)
 
-TimerMode::TimerMode() : Mode("Timer") {
+// 比赛配置在进入模式时应用，构造时计时时长暂为0
+TimerMode::TimerMode() : Mode("Timer"), matchClock(0), countdownClock(0), cueScheduler(cueClock), compositor(ledMatrix) {
     remainingSeconds = 60;
-    lastRemainingSeconds = 60;
     isRunning = false;
     isPaused = false;
     isCountdown = false;
     countdownSeconds = 3;
     isStartSoundPlayed = false;
-    startTime = 0;
-    pauseTime = 0;
+    isPreRoll = false;
+    preRollRequestUs = 0;
+    preRollAnchorUs = -1;
+    eventTimeUs = -1;
     lastDisplayedTime = 0;
     lastDisplayedSeconds = 60;
+    countdownShown = -1;
     lastDisplayedMilliseconds = 0;
     isPlayingSoundAtKeyTime = false;  // 初始化新添加的变量
     soundBrightnessLevel = 0;         // 初始化声音播放时的亮度级别
+    soundDimDurationMs = 0;
+    warningSeconds = 0;
+    wideTime = false;
+    
+    // 初始化提示调度器 (提示表来自比赛配置)
+    cueScheduler.setAudioLatencyUs(JQ8900Player::trackLatencyUs());
+    cueScheduler.setAudioHandler(audioCueTrack);  // 在esp_timer任务中调用，只入队不输出日志
     
     // 初始化颜色 - 改为红色和绿色
     tensColor = 0xFF0000;  // 红色
     onesColor = 0x00FF00;  // 绿色
     
+    // 创建LED图层
+    setupLedLayers();
+    
+    
     // 初始化UI状态
     brightnessLevel = 2;  // 默认中等亮度
     isBrightnessSelected = false;
@@ -104,9 +141,21 @@ void TimerMode::begin() {
     // 清除屏幕
     M5.Display.fillScreen(BLACK);
     
+    // 生成时间数字的字形缓存 (只在第一次进入时生成)
+    timeRenderer.begin();
+    timeRenderer.invalidate();
+    
+    // 应用当前比赛配置 (未在计时时)
+    if (!isRunning && !isCountdown) {
+        applyProfile();
+    }
+    
     // 确保LED矩阵已初始化
     ledMatrix.begin();
     
+    // 其他模式可能改写过LED矩阵，下一次合成全部重算
+    compositor.invalidate();
+    
     // 设置正常亮度
     updateBrightness();
     isDimmed = false;
@@ -129,7 +178,6 @@ void TimerMode::begin() {
     
     // 显示秒表图标
     showStopwatchIcon();
-    ledMatrix.update();  // 确保更新显示
     
     // 重置活动时间
     lastActivityTime = millis();
@@ -141,8 +189,9 @@ void TimerMode::update() {
     // 更新省电模式状态（只保留亮度变暗功能）
     updatePowerSavingMode();
     
-    // 获取当前时间
+    // 获取当前时间，本帧所有显示与判断都使用同一个计时快照
     unsigned long currentTime = millis();
+    captureClock();
     
     // 如果在充电，每500ms更新一次电池图标以展示充电动画
     bool isCharging = M5.Power.isCharging();
@@ -156,13 +205,13 @@ void TimerMode::update() {
         // 倒计时是活动状态
         resetActivityTimer();
         
-        unsigned long elapsedMillis = currentTime - startTime;
-        int elapsedSeconds = elapsedMillis / 1000;
-        int millisInCurrentSecond = elapsedMillis % 1000;
-        countdownSeconds = 3 - elapsedSeconds;
+        // 等待提示声音发出后再开始倒计时
+        if (isPreRoll) {
+            updatePreRoll();
+        }
         
         // 当倒计时还剩不到0.6秒时，提前播放开始声音并开始计时
-        if (countdownSeconds == 1 && millisInCurrentSecond >= 400 && !isStartSoundPlayed) {
+        if (clockSnap.remainingUs <= COUNTDOWN_END_SOUND_US && !isStartSoundPlayed) {
             Serial.println("TimerMode: 播放倒计时结束声音");
             // 使用AudioTask播放
             audioStop();
@@ -170,7 +219,7 @@ void TimerMode::update() {
             isStartSoundPlayed = true;
         }
         
-        if (countdownSeconds <= 0) {
+        if (clockSnap.finished) {
             isCountdown = false;
             startTimer();
         } else {
@@ -181,61 +230,19 @@ void TimerMode::update() {
             updateLEDDisplay();
         }
     } else if (isRunning && !isPaused) {
-        unsigned long elapsedMillis = currentTime - startTime;
-        int elapsedSeconds = elapsedMillis / 1000;
-        int millisInCurrentSecond = elapsedMillis % 1000;
-        
-        // 计算剩余秒数和毫秒
-        float remainingTime = 60.0f - (elapsedMillis / 1000.0f);
-        remainingSeconds = ceil(remainingTime);  // 使用向上取整而不是向下取整
-        int remainingMillis = (int)((remainingTime - (int)remainingTime) * 1000);  // 小数部分是毫秒
-        
-        // 在关键时间点提前播放声音并降低LED亮度（36、26、1秒时就触发）
-        if (lastRemainingSeconds > 36 && remainingSeconds <= 36) {
-            // 提前播放35秒声音
-            audioPlayTrack(3);
-            // 降低LED亮度到当前亮度的两个级别
-            soundBrightnessLevel = brightnessLevel >= 2 ? brightnessLevel - 2 : 0;
-            int soundBrightness = map(soundBrightnessLevel, 0, 4, 5, LED_NORMAL_BRIGHT);
-            ledMatrix.getStrip().setBrightness(soundBrightness);
-            ledMatrix.getStrip().show();
-            isPlayingSoundAtKeyTime = true;
-            // 设置计时器，2秒后恢复原始亮度
-            soundPlayStartTime = currentTime;
-        } else if (lastRemainingSeconds > 26 && remainingSeconds <= 26) {
-            // 提前播放25秒声音
-            audioPlayTrack(3);
-            // 降低LED亮度到当前亮度的两个级别
-            soundBrightnessLevel = brightnessLevel >= 2 ? brightnessLevel - 2 : 0;
-            int soundBrightness = map(soundBrightnessLevel, 0, 4, 5, LED_NORMAL_BRIGHT);
-            ledMatrix.getStrip().setBrightness(soundBrightness);
-            ledMatrix.getStrip().show();
-            isPlayingSoundAtKeyTime = true;
-            // 设置计时器，2秒后恢复原始亮度
-            soundPlayStartTime = currentTime;
-        } else if (lastRemainingSeconds > 1 && remainingSeconds <= 1) {
-            // 提前播放0秒声音
-            audioPlayTrack(4);
-            // 确保不会降低LED亮度，并且恢复到原始亮度
-            isPlayingSoundAtKeyTime = false; // 确保不会触发亮度恢复逻辑
-            // 确保LED使用原始亮度
-            ledMatrix.getStrip().setBrightness(originalBrightness);
-            ledMatrix.getStrip().show();
-        }
-        lastRemainingSeconds = remainingSeconds;
+        // 关键时间点的声音由提示调度器按时发出，这里执行其挂起的LED亮度动作
+        applyCueActions();
         
         // 如果正在播放关键时间点的声音，检查是否需要恢复亮度
-        if (isPlayingSoundAtKeyTime && (currentTime - soundPlayStartTime >= 2000)) {
-            // 声音播放2秒后恢复原始亮度
-            ledMatrix.getStrip().setBrightness(originalBrightness);
-            ledMatrix.getStrip().show();
+        if (isPlayingSoundAtKeyTime && (currentTime - soundPlayStartTime >= soundDimDurationMs)) {
+            // 声音播放一段时间后恢复原始亮度
+            ledMatrix.setBrightness(originalBrightness);
             isPlayingSoundAtKeyTime = false;
         }
         
         // 当计时器到达0秒时停止运行
         // 但不要立即重置，只标记为不运行，保持显示
-        if (remainingTime <= 0) {  // 使用remainingTime而非remainingSeconds判断
-            remainingSeconds = 0;  // 确保显示0.00秒
+        if (clockSnap.finished) {
             isRunning = false;      // 标记为不运行
             resetActivityTimer();
             
@@ -259,11 +266,40 @@ void TimerMode::update() {
     }
 }
 
+// 倒计时和计时中每帧刷新，否则只在充电动画或调暗时刻到来时唤醒
+uint32_t TimerMode::nextDeadline() {
+    if (isCountdown || (isRunning && !isPaused)) {
+        return MODE_DEFAULT_TICK_MS;
+    }
+    
+    uint32_t deadline = MODE_NO_DEADLINE;
+    if (M5.Power.isCharging()) {
+        deadline = 500;
+    }
+    if (!isDimmed) {
+        unsigned long inactiveTime = millis() - lastActivityTime;
+        uint32_t untilDim = inactiveTime >= DIM_TIMEOUT ? 0 : DIM_TIMEOUT - inactiveTime;
+        if (untilDim < deadline) deadline = untilDim;
+    }
+    return deadline;
+}
+
 void TimerMode::exit() {
+    // 取消未触发的提示
+    cueScheduler.disarm();
+    
     // 清除显示
     M5.Display.fillScreen(BLACK);
     ledMatrix.clear();  // 清除LED显示
-    ledMatrix.update();
+    ledMatrix.present();
+    compositor.invalidate();
+    
+    // 输出LCD刷新统计
+    LcdRenderStats stats;
+    timeRenderer.getStats(&stats);
+    Serial.printf("TimerMode: LCD时间刷新 %lu帧, 共%lu字节, 整行重绘%lu次\n",
+                  (unsigned long)stats.frames, (unsigned long)stats.totalBytes,
+                  (unsigned long)stats.fullRedraws);
     
     // 停止声音播放
     audioStop();
@@ -274,7 +310,9 @@ void TimerMode::drawTimer() {
     // 清除计时器显示区域，但不包括右上角的版本号
     M5.Display.fillRect(0, 0, 205, INFO_BAR_Y, BLACK);
     
-    // 更新时间显示
+    // 更新时间显示 (区域已清空，全部重绘)
+    timeRenderer.invalidate();
+    countdownShown = -1;
     updateTimeDisplay();
     
     // 重新绘制版本号
@@ -282,6 +320,10 @@ void TimerMode::drawTimer() {
     M5.Display.setTextColor(DARK_GRAY, BLACK);
     M5.Display.setCursor(210, 5);
     M5.Display.print(VERSION_TEXT);
+    
+    // 在左上角显示当前比赛配置
+    M5.Display.setCursor(TIME_DISPLAY_X, 5);
+    M5.Display.print(matchProfiles.active().name);
 }
 
 void TimerMode::drawInfoBar() {
@@ -419,8 +461,16 @@ void TimerMode::drawBatteryIcon() {
     }
 }
 
-void TimerMode::showStopwatchIcon() {
-    // 在LED矩阵上显示一个香水瓶图标，宽6像素，高8像素，绿色轮廓和红色点缀
+// 创建LED图层: 图标与数字互斥显示，警示边框叠加在数字上方
+void TimerMode::setupLedLayers() {
+    iconLayer = compositor.addLayer("icon", 0);
+    digitsLayer = compositor.addLayer("digits", 0);
+    warningLayer = compositor.addLayer("warning", 10);
+    ledDigitsValue = -1;
+    ledTensColor = 0;
+    ledOnesColor = 0;
+    
+    // 香水瓶图标，宽6像素，高8像素，绿色轮廓和红色点缀
     const uint8_t icon[8][6] = {
         {0,1,1,1,1,0},
         {0,0,1,1,0,0},
@@ -436,25 +486,89 @@ void TimerMode::showStopwatchIcon() {
     uint32_t bottleColor = 0x00FF00;     // 亮绿色瓶身
     uint32_t accentColor = 0xFF0000;     // 红色点缀
     
-    // 先清除所有像素
-    ledMatrix.clear();
-    
     // 绘制图标，水平居中
     int offsetX = 1; // (8-6)/2 = 1，用于水平居中
     for(int y = 0; y < 8; y++) {
         for(int x = 0; x < 6; x++) {
             if(icon[y][x] == 1) {
-                ledMatrix.setPixel(x + offsetX, y, bottleColor);
+                compositor.setPixel(iconLayer, x + offsetX, y, bottleColor);
             } else if(icon[y][x] == 2) {
-                ledMatrix.setPixel(x + offsetX, y, accentColor);
+                compositor.setPixel(iconLayer, x + offsetX, y, accentColor);
             }
         }
     }
     
-    ledMatrix.update();  // 更新显示
+    // 警示边框: 最外一圈像素
+    for (int i = 0; i < 8; i++) {
+        compositor.setPixel(warningLayer, i, 0, WARNING_COLOR);
+        compositor.setPixel(warningLayer, i, 7, WARNING_COLOR);
+        compositor.setPixel(warningLayer, 0, i, WARNING_COLOR);
+        compositor.setPixel(warningLayer, 7, i, WARNING_COLOR);
+    }
+    compositor.setAlpha(warningLayer, WARNING_ALPHA);
+    
+    compositor.setVisible(digitsLayer, false);
+    compositor.setVisible(warningLayer, false);
+}
+
+void TimerMode::showStopwatchIcon() {
+    compositor.setVisible(iconLayer, true);
+    compositor.setVisible(digitsLayer, false);
+    compositor.setVisible(warningLayer, false);
+    compositor.compose();  // 更新显示
+}
+
+// 在数字图层上绘制数字，与当前内容相同时不重绘
+void TimerMode::drawLedDigits(int value, uint32_t tens, uint32_t ones) {
+    compositor.setVisible(iconLayer, false);
+    compositor.setVisible(digitsLayer, true);
+    
+    // 比赛配置的时长不超过GLYPH_MAX_NUMBER秒，三位数总能放下
+    if (value > GLYPH_MAX_NUMBER) value = GLYPH_MAX_NUMBER;
+    if (value == ledDigitsValue && tens == ledTensColor && ones == ledOnesColor) return;
+    
+    ledDigitsValue = value;
+    ledTensColor = tens;
+    ledOnesColor = ones;
+    
+    compositor.clearLayer(digitsLayer);
+    if (value >= 100) {
+        // 三位数 (100-199) 使用3x5比例字体，百位和十位使用十位颜色
+        uint8_t digits[3] = {
+            (uint8_t)(value / 100 % 10), (uint8_t)(value / 10 % 10), (uint8_t)(value % 10)
+        };
+        int xs[3];
+        layoutDigits(digits, 3, FONT_3X5, xs);
+        int y = (8 - FONT_3X5[0].height) / 2;
+        compositor.drawGlyph(digitsLayer, FONT_3X5[digits[0]], xs[0], y, tens);
+        compositor.drawGlyph(digitsLayer, FONT_3X5[digits[1]], xs[1], y, tens);
+        compositor.drawGlyph(digitsLayer, FONT_3X5[digits[2]], xs[2], y, ones);
+    } else if (value >= 10) {
+        // 两位数，分别显示在左右两边
+        compositor.drawGlyph(digitsLayer, FONT_4X8[value / 10 % 10], 0, 0, tens);
+        compositor.drawGlyph(digitsLayer, FONT_4X8[value % 10], 4, 0, ones);
+    } else if (value >= 0) {
+        // 个位数，显示在中间
+        compositor.drawGlyph(digitsLayer, FONT_4X8[value], 2, 0, ones);
+    }
+}
+
+// 事件消息带有发生时刻 (esp_timer低32位，按键为中断中采集的边沿时刻)，
+// 换算回64位后供暂停/继续使用，事件排队与处理前的绘制时间不计入计时
+void TimerMode::handleEventMessage(const EventMessage& message) {
+    int64_t nowUs = esp_timer_get_time();
+    uint32_t ageUs = (uint32_t)nowUs - message.timestampUs;
+    eventTimeUs = ageUs <= EVENT_MAX_AGE_US ? nowUs - ageUs : nowUs;
+    handleEvent(message.type);
+    eventTimeUs = -1;
 }
 
 void TimerMode::handleEvent(EventType event) {
+    // 音频任务的发送回报不是用户活动，随后的update()会处理提示声音状态
+    if (event == EVENT_AUDIO_SENT) {
+        return;
+    }
+    
     // 任何事件发生时，都视为活动
     resetActivityTimer();
     
@@ -472,7 +586,7 @@ void TimerMode::handleEvent(EventType event) {
             } else {
                 // 开始/暂停/继续/重置
                 if (isCountdown) {
-                    // 在倒计时阶段，按暂停则直接返回初始状态
+                    // 在提示声音或倒计时阶段，按暂停则直接返回初始状态
                     resetTimer();
                 } else if (!isRunning && remainingSeconds == 0) {
                     // 计时结束后，按下按钮重置计时器
@@ -493,6 +607,12 @@ void TimerMode::handleEvent(EventType event) {
             
         case EVENT_BUTTON_A_LONG:
             if (!isBrightnessSelected) {
+                if (!isCountdown && !matchClock.isRunning()) {
+                    // 未开始计时: 切换到下一个比赛配置
+                    matchProfiles.setActive((matchProfiles.activeIndex() + 1) % matchProfiles.count());
+                    applyProfile();
+                    Serial.println("TimerMode: 切换比赛配置 " + String(matchProfiles.active().name));
+                }
                 // 重置计时器
                 resetTimer();
             }
@@ -527,27 +647,22 @@ void TimerMode::updateDisplay() {
 
 void TimerMode::updateLEDDisplay() {
     // 在LED矩阵上显示剩余时间（向上取整）
-    // 计算向上取整的剩余秒数
-    int ceiledSeconds;
+    int ceiledSeconds = clockSnap.ceilSeconds;
+    bool showWarning = false;
     
     if (isCountdown) {
         // 倒计时状态，显示倒计时数字
-        ledMatrix.showNumber(countdownSeconds, COLOR_BLUE);
-        ledMatrix.update();
+        drawLedDigits(ceiledSeconds, COLOR_BLUE, COLOR_BLUE);
+        compositor.setVisible(warningLayer, false);
+        compositor.compose();
         // 倒计时状态下，保持心跳
         resetActivityTimer();
         return;
     } else if (isRunning && !isPaused) {
-        // 计算精确的剩余时间
-        unsigned long currentTime = millis();
-        unsigned long elapsedMillis = currentTime - startTime;
-        float remainingTime = 60.0f - (elapsedMillis / 1000.0f);
-        
-        // 使用向上取整而不是向下取整（转换为int类型）
-        ceiledSeconds = ceil(remainingTime);
-        
-        // 确保不会出现负值
-        if (ceiledSeconds < 0) ceiledSeconds = 0;
+        // 最后几秒闪烁警示边框，只切换图层可见性，数字不重绘
+        if (ceiledSeconds > 0 && ceiledSeconds <= warningSeconds) {
+            showWarning = (clockSnap.elapsedUs / 1000 / WARNING_FLASH_MS) % 2 == 0;
+        }
         
         // 当秒数变化时，重置活动计时器
         static int lastCeiledSeconds = -1;
@@ -556,10 +671,6 @@ void TimerMode::updateLEDDisplay() {
             lastCeiledSeconds = ceiledSeconds;
         }
     } else {
-        // 非运行状态下使用当前存储的remainingSeconds
-        // 由于在resetTimer()中设置为60，不需要额外的向上取整
-        ceiledSeconds = remainingSeconds;
-        
         // 如果是计时结束状态(0秒)，保持心跳
         if (ceiledSeconds == 0) {
             resetActivityTimer();
@@ -567,51 +678,93 @@ void TimerMode::updateLEDDisplay() {
     }
     
     // 显示向上取整后的时间
-    if (ceiledSeconds >= 10) {
-        // 两位数显示
-        int tens = ceiledSeconds / 10;
-        int ones = ceiledSeconds % 10;
-        ledMatrix.showTwoNumbers(tens, ones, tensColor, onesColor);
-    } else {
-        // 个位数显示，不再闪烁
-        ledMatrix.showNumber(ceiledSeconds, onesColor);
-    }
-    ledMatrix.update();
+    drawLedDigits(ceiledSeconds, tensColor, onesColor);
+    compositor.setVisible(warningLayer, showWarning);
+    compositor.compose();
 }
 
+// 进入开始前的提示声音阶段 - 倒计时显示满值，等音频任务回报选曲命令发完后再开始计时
 void TimerMode::startCountdown() {
     Serial.println("TimerMode: 开始倒计时声音");
     
-    // 使用AudioTask来处理音频播放 - 先停止所有声音，然后播放倒计时开始声音
-    audioStop();
-    audioPlayTrack(1);  // 播放曲目1 (倒计时开始声音)
-    
-    // 延迟1秒后再开始倒计时，确保声音先播放
-    delay(1000);
+    // 选曲命令本身会先停止当前播放，由AudioTask异步发送
+    preRollRequestUs = esp_timer_get_time();
+    preRollAnchorUs = -1;
+    audioPlayTrack(PREROLL_TRACK);
     
-    // 开始倒计时
     isCountdown = true;
-    countdownSeconds = 3;
+    isPreRoll = true;
     isStartSoundPlayed = false;  // 重置声音播放标志
-    startTime = millis();
+    countdownClock.reset();
+    captureClock();
+}
+
+// 提示声音阶段: 确定倒计时起点，到达起点后开始倒计时
+void TimerMode::updatePreRoll() {
+    int64_t nowUs = esp_timer_get_time();
+    
+    if (preRollAnchorUs < 0) {
+        uint16_t track;
+        int64_t sentUs;
+        if (audioGetTrackSent(&track, &sentUs) && track == PREROLL_TRACK && sentUs >= preRollRequestUs) {
+            preRollAnchorUs = sentUs + PREROLL_LEAD_US;
+        } else if (nowUs - preRollRequestUs >= PREROLL_TIMEOUT_US) {
+            Serial.println("TimerMode: 未收到开始声音发送回报，按请求时刻开始倒计时");
+            preRollAnchorUs = preRollRequestUs + PREROLL_LEAD_US;
+        }
+    }
+    
+    if (preRollAnchorUs >= 0 && nowUs >= preRollAnchorUs) {
+        isPreRoll = false;
+        countdownClock.start(preRollAnchorUs);
+        captureClock();
+    }
+}
+
+// 应用当前比赛配置: 计时时长、倒计时时长、警示阈值与提示表
+void TimerMode::applyProfile() {
+    const MatchProfile& profile = matchProfiles.active();
+    matchClock.setDurationMs(profile.durationMs);
+    countdownClock.setDurationMs(profile.preRollMs);
+    warningSeconds = profile.warningSeconds;
+    cueScheduler.setTable(profile.cues, profile.cueCount);
+    
+    // 三位秒数使用较窄的字符单元
+    wideTime = profile.durationMs >= 100000;
+    if (wideTime) {
+        timeRenderer.setLayout(TIME_DISPLAY_X, TIME_DISPLAY_Y, TIME_CELL_WIDTHS_WIDE,
+                               sizeof(TIME_CELL_WIDTHS_WIDE) / sizeof(TIME_CELL_WIDTHS_WIDE[0]));
+    } else {
+        timeRenderer.setLayout(TIME_DISPLAY_X, TIME_DISPLAY_Y, TIME_CELL_WIDTHS,
+                               sizeof(TIME_CELL_WIDTHS) / sizeof(TIME_CELL_WIDTHS[0]));
+    }
+    captureClock();
+}
+
+// 采样当前计时快照，并同步供按钮与信息条使用的剩余秒数
+void TimerMode::captureClock() {
+    int64_t nowUs = esp_timer_get_time();
+    if (isCountdown) {
+        clockSnap = countdownClock.snapshot(nowUs);
+        countdownSeconds = clockSnap.ceilSeconds;
+    } else {
+        clockSnap = matchClock.snapshot(nowUs);
+        remainingSeconds = clockSnap.ceilSeconds;
+    }
 }
 
 void TimerMode::startTimer() {
     if (!isRunning) {
-        startTime = millis();
+        int64_t nowUs = esp_timer_get_time();
+        matchClock.start(nowUs);
         isRunning = true;
         isPaused = false;
-        lastRemainingSeconds = 60; // 确保初始状态正确
         lastDisplayedTime = 0; // 重置上次显示时间
+        captureClock();
         
-        // 在计时开始时降低LED亮度到当前亮度的两个级别
-        soundBrightnessLevel = brightnessLevel >= 2 ? brightnessLevel - 2 : 0;
-        int soundBrightness = map(soundBrightnessLevel, 0, 4, 5, LED_NORMAL_BRIGHT);
-        ledMatrix.getStrip().setBrightness(soundBrightness);
-        ledMatrix.getStrip().show();
-        isPlayingSoundAtKeyTime = true;
-        // 设置计时器，2秒后恢复原始亮度
-        soundPlayStartTime = millis();
+        // 布置提示表，计时开始时的降低亮度动作立即生效
+        cueScheduler.arm(nowUs);
+        applyCueActions();
         
         drawTimer(); // 完整重绘一次
         drawInfoBar();
@@ -621,8 +774,10 @@ void TimerMode::startTimer() {
 
 void TimerMode::pauseTimer() {
     if (isRunning && !isPaused) {
-        pauseTime = millis();
+        matchClock.pause(actionTimeUs());
         isPaused = true;
+        captureClock();
+        cueScheduler.disarm();
         updateDisplay();
         updateLEDDisplay();
     }
@@ -630,28 +785,37 @@ void TimerMode::pauseTimer() {
 
 void TimerMode::resumeTimer() {
     if (isRunning && isPaused) {
-        unsigned long pauseDuration = millis() - pauseTime;
-        startTime += pauseDuration;
+        matchClock.resume(actionTimeUs());
         isPaused = false;
+        captureClock();
+        
+        // 以扣除暂停时间后的计时起点继续提示
+        cueScheduler.resume(matchClock.anchorUs());
         updateDisplay();
         updateLEDDisplay();
     }
 }
 
+// 事件处理中取事件发生时刻，否则取当前时刻
+int64_t TimerMode::actionTimeUs() const {
+    return eventTimeUs >= 0 ? eventTimeUs : esp_timer_get_time();
+}
+
 void TimerMode::resetTimer() {
-    // 使用AudioTask停止声音
+    // 取消未触发的提示并使用AudioTask停止声音
+    cueScheduler.disarm();
     audioStop();
     
-    remainingSeconds = 60;
-    lastRemainingSeconds = 60;
     isRunning = false;
     isPaused = false;
     isCountdown = false;
-    countdownSeconds = 3;
+    isPreRoll = false;
     isStartSoundPlayed = false;  // 重置声音播放标志
     isPlayingSoundAtKeyTime = false;  // 重置关键时间点声音播放标志
-    startTime = 0;
-    pauseTime = 0;
+    matchClock.reset();
+    countdownClock.reset();
+    countdownSeconds = countdownClock.durationMs() / 1000;
+    captureClock();
     updateDisplay();
     showStopwatchIcon();
 }
@@ -665,6 +829,27 @@ void TimerMode::playSound(uint16_t track) {
     Serial.println("TimerMode: 已发送异步播放命令 " + String(track));
 }
 
+// 执行提示调度器挂起的LED亮度动作
+void TimerMode::applyCueActions() {
+    CueLedAction action;
+    uint16_t durationMs;
+    if (!cueScheduler.takeLedAction(&action, &durationMs)) return;
+    
+    if (action == CUE_LED_DIM) {
+        // 降低LED亮度到当前亮度的两个级别，持续durationMs后恢复
+        soundBrightnessLevel = brightnessLevel >= 2 ? brightnessLevel - 2 : 0;
+        int soundBrightness = map(soundBrightnessLevel, 0, 4, 5, LED_NORMAL_BRIGHT);
+        ledMatrix.setBrightness(soundBrightness);
+        isPlayingSoundAtKeyTime = true;
+        soundPlayStartTime = millis();
+        soundDimDurationMs = durationMs;
+    } else if (action == CUE_LED_RESTORE) {
+        // 确保不会触发亮度恢复逻辑，并使用原始亮度
+        isPlayingSoundAtKeyTime = false;
+        ledMatrix.setBrightness(originalBrightness);
+    }
+}
+
 void TimerMode::randomizeColors() {
     // 随机选择两个不同的颜色
     int colorIndex1 = random(6);
@@ -683,8 +868,7 @@ void TimerMode::updateBrightness() {
     
     // 只有在不是播放关键时间点的声音时才设置亮度
     if (!isPlayingSoundAtKeyTime) {
-        ledMatrix.getStrip().setBrightness(brightness);
-        ledMatrix.getStrip().show();
+        ledMatrix.setBrightness(brightness);
     }
     originalBrightness = brightness;
 }
@@ -713,13 +897,12 @@ void TimerMode::wakeFromPowerSaving() {
         if (isPlayingSoundAtKeyTime) {
             // 如果正在播放关键时间点声音，保持降低的亮度
             int soundBrightness = map(soundBrightnessLevel, 0, 4, 5, LED_NORMAL_BRIGHT);
-            ledMatrix.getStrip().setBrightness(soundBrightness);
+            ledMatrix.setBrightness(soundBrightness);
         } else {
             // 否则恢复原始亮度
-            ledMatrix.getStrip().setBrightness(originalBrightness);
+            ledMatrix.setBrightness(originalBrightness);
         }
         isDimmed = false;
-        ledMatrix.getStrip().show();
     }
 }
 
@@ -731,24 +914,16 @@ void TimerMode::updatePowerSavingMode() {
     // 检查是否需要调暗LED矩阵 (1分钟无活动)
     if (inactiveTime >= DIM_TIMEOUT && !isDimmed) {
         Serial.println("省电模式: 1分钟无活动，调暗LED矩阵");
-        ledMatrix.getStrip().setBrightness(LED_DIM_BRIGHT);
-        ledMatrix.getStrip().show();
+        ledMatrix.setBrightness(LED_DIM_BRIGHT);
         isDimmed = true;
     }
 }
 
 // 更新时间显示部分，减少闪烁并增加颜色变化
 void TimerMode::updateTimeDisplay() {
-    // 计算剩余时间，包括毫秒
-    unsigned long currentTime = millis();
-    unsigned long elapsedMillis = 0;
-    float remainingTime = 60.0f;
-    
     if (isCountdown) {
-        // 倒计时状态，显示3、2、1（居中）
-        unsigned long elapsedMillis = currentTime - startTime;
-        float elapsedSeconds = elapsedMillis / 1000.0f;
-        int countdownValue = 3 - ceil(elapsedSeconds);  // 使用向上取整确保平滑过渡
+        // 倒计时状态，显示3、2、1（居中），与LED使用同一个向上取整的秒数
+        int countdownValue = clockSnap.ceilSeconds;
         
         // 检查倒计时数字是否变化，如果变化，重置活动计时器
         if (countdownValue != lastDisplayedSeconds) {
@@ -757,92 +932,74 @@ void TimerMode::updateTimeDisplay() {
         }
         
         if (countdownValue > 0) {
-            // 清除整个显示区域
-            M5.Display.fillRect(TIME_DISPLAY_X, TIME_DISPLAY_Y, TIME_DISPLAY_WIDTH, TIME_DISPLAY_HEIGHT, BLACK);
-            
-            // 显示倒计时数字（居中）
-            M5.Display.setTextSize(6);
-            M5.Display.setTextColor(LIGHT_GRAY, BLACK);
-            
-            // 计算居中位置
-            // 单个数字宽度约为6*6=36像素
-            int digitWidth = 36;
-            int centerX = TIME_DISPLAY_X + (TIME_DISPLAY_WIDTH - digitWidth) / 2;
+            // 只在数字变化或区域被清空后重绘，其余帧不碰LCD
+            if (countdownValue != countdownShown) {
+                M5.Display.fillRect(TIME_DISPLAY_X, TIME_DISPLAY_Y, TIME_DISPLAY_WIDTH, TIME_DISPLAY_HEIGHT, BLACK);
+                
+                // 显示倒计时数字（居中）
+                M5.Display.setTextSize(6);
+                M5.Display.setTextColor(LIGHT_GRAY, BLACK);
+                
+                // 计算居中位置
+                // 单个数字宽度约为6*6=36像素
+                int digitWidth = 36;
+                int centerX = TIME_DISPLAY_X + (TIME_DISPLAY_WIDTH - digitWidth) / 2;
+                
+                M5.Display.setCursor(centerX, TIME_DISPLAY_Y);
+                M5.Display.printf("%d", countdownValue);
+                countdownShown = countdownValue;
+            }
             
-            M5.Display.setCursor(centerX, TIME_DISPLAY_Y);
-            M5.Display.printf("%d", countdownValue);
+            // 倒计时结束后时间数字需要整行重绘
+            timeRenderer.invalidate();
             return;
         }
-    } else if (isRunning) {
-        if (isPaused) {
-            // 暂停状态，保持当前时间
-            elapsedMillis = pauseTime - startTime;
-        } else {
-            // 运行状态，计算经过时间
-            elapsedMillis = currentTime - startTime;
-        }
-        remainingTime = 60.0f - (elapsedMillis / 1000.0f);
-    } else if (!isCountdown && remainingSeconds == 0) {
-        // 计时结束但未重置的特殊状态，显示0.00
-        remainingTime = 0.0f;
+    } else if (!isRunning && clockSnap.remainingUs == 0) {
         // 计时结束后也定期重置活动计时器，防止进入省电模式
         resetActivityTimer();
     }
     
-    // 确保不会出现负值
-    if (remainingTime < 0) remainingTime = 0;
+    // 时间数字占用了倒计时区域，下次倒计时需要重绘
+    countdownShown = -1;
     
-    // 分离秒数和毫秒
-    int seconds = (int)remainingTime;
-    int milliseconds = (int)((remainingTime - seconds) * 100);
-    
-    // 确保当到达0秒时，显示精确的0.00而不是四舍五入
-    if (seconds == 0 && !isRunning) {
-        milliseconds = 0;
-    }
+    // 剩余时间的整秒与百分之一秒，由计时快照以整数运算得出
+    int seconds = clockSnap.seconds;
+    int milliseconds = clockSnap.hundredths;
     
     // 检查秒数是否变化，如果变化，重置活动计时器
     if (seconds != lastDisplayedSeconds) {
         resetActivityTimer();  // 添加心跳，防止进入省电模式
     }
     
-    // 清除整个显示区域
-    M5.Display.fillRect(TIME_DISPLAY_X, TIME_DISPLAY_Y, TIME_DISPLAY_WIDTH, TIME_DISPLAY_HEIGHT, BLACK);
+    // 整行重绘时先清空区域并绘制静态的"sec"
+    if (timeRenderer.isInvalid()) {
+        M5.Display.fillRect(TIME_DISPLAY_X, TIME_DISPLAY_Y, TIME_DISPLAY_WIDTH, TIME_DISPLAY_HEIGHT, BLACK);
+        
+        // 只在正常计时模式下显示sec，倒计时时不显示
+        if (!isCountdown) {
+            M5.Display.setTextSize(2);
+            M5.Display.setTextColor(DARK_GRAY, BLACK);
+            // 计算sec文本的左侧位置，不再需要计算宽度
+            int secX = TIME_DISPLAY_X + TIME_DISPLAY_WIDTH; // 直接指定偏移量
+            // 计算sec文本的y坐标，使其与数字底部对齐（数字高度约48像素）
+            int secY = TIME_DISPLAY_Y + 48 - 16; // 16是sec文本的高度
+            M5.Display.setCursor(secX, secY);
+            M5.Display.print("sec");
+        }
+    }
     
     // 设置显示颜色为固定的浅灰色，不再根据阶段变化
     uint16_t timeColor = LIGHT_GRAY;
     
-    // 最后10秒显示红色但不闪烁
-    if (seconds <= 10 && seconds > 0) {
-        timeColor = RED;    // 10-0秒: 红色
-    } else if (seconds == 0) {
-        // 0秒时使用红色
+    // 进入警示阈值后显示红色但不闪烁 (包括0秒)
+    if (seconds <= warningSeconds) {
         timeColor = RED;
     }
     
-    // 显示秒数
-    M5.Display.setTextSize(6);
-    M5.Display.setTextColor(timeColor, BLACK);
-    M5.Display.setCursor(TIME_DISPLAY_X, TIME_DISPLAY_Y);
-    M5.Display.printf("%02d", seconds);
-    
-    // 显示毫秒
-    M5.Display.setCursor(TIME_DISPLAY_X + 64, TIME_DISPLAY_Y);
-    M5.Display.printf(".%02d", milliseconds);
-    
-    // 显示"sec"，现在使用左对齐
-    M5.Display.setTextSize(2);
-    M5.Display.setTextColor(DARK_GRAY, BLACK);
-    
-    // 只在正常计时模式下显示sec，倒计时时不显示
-    if (!isCountdown) {
-        // 计算sec文本的左侧位置，不再需要计算宽度
-        int secX = TIME_DISPLAY_X + TIME_DISPLAY_WIDTH; // 直接指定偏移量
-        // 计算sec文本的y坐标，使其与数字底部对齐（数字高度约48像素）
-        int secY = TIME_DISPLAY_Y + 48 - 16; // 16是sec文本的高度
-        M5.Display.setCursor(secX, secY);
-        M5.Display.print("sec");
-    }
+    // 显示秒数和毫秒，只推送变化的字符单元
+    char text[8];
+    snprintf(text, sizeof(text), wideTime ? "%3d.%02d" : "%02d.%02d", seconds, milliseconds);
+    timeRenderer.draw(text, timeColor, BLACK);
     
     lastDisplayedSeconds = seconds;
     lastDisplayedMilliseconds = milliseconds;
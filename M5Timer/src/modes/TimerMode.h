@@ -3,6 +3,12 @@
 #include "../core/Mode.h"
 #include <Preferences.h>
 #include "../core/Player.h"
+#include "../core/CueScheduler.h"
+#include "../core/EspCueClock.h"
+#include "../core/LEDCompositor.h"
+#include "../core/LcdDigitRenderer.h"
+#include "../core/MatchClock.h"
+#include "../core/MatchProfile.h"
 
 class TimerMode : public Mode {
 public:
@@ -12,6 +18,8 @@ public:
     virtual void update() override;
     virtual void exit() override;
     virtual void handleEvent(EventType event) override;
+    virtual void handleEventMessage(const EventMessage& message) override;
+    virtual uint32_t nextDeadline() override;
 
 private:
     void updateDisplay();
@@ -20,9 +28,16 @@ private:
     void pauseTimer();
     void resumeTimer();
     void resetTimer();
+    int64_t actionTimeUs() const;  // 暂停/继续生效的时刻
     void playSound(uint16_t track);  // 播放声音函数
+    void applyCueActions();  // 执行提示调度器挂起的LED亮度动作
     void showStopwatchIcon();  // 显示秒表图标
+    void setupLedLayers();  // 创建LED图层并绘制固定内容
+    void drawLedDigits(int value, uint32_t tens, uint32_t ones);  // 在数字图层上绘制数字
     void startCountdown();  // 开始倒计时
+    void captureClock();    // 采样当前计时快照
+    void updatePreRoll();   // 提示声音阶段: 等待发送回报并开始倒计时
+    void applyProfile();    // 应用当前比赛配置
     void randomizeColors();  // 随机改变颜色
     void drawPlayPauseButton(bool isPlaying);  // 绘制播放/暂停按钮
     void drawBrightnessButton();  // 绘制亮度按钮
@@ -38,22 +53,41 @@ private:
     void wakeFromPowerSaving();       // 从省电模式唤醒
     void updatePowerSavingMode();     // 更新省电模式状态
 
-    unsigned long startTime;
-    unsigned long pauseTime;
+    MatchClock matchClock;      // 比赛计时
+    MatchClock countdownClock;  // 开始前的3秒倒计时
+    ClockSnapshot clockSnap;    // 本帧的计时快照 (倒计时中为倒计时的快照)
+    int warningSeconds;         // 最后几秒进入警示 (来自比赛配置)
+    bool wideTime;              // 计时时长为三位秒数
     int remainingSeconds;
-    int lastRemainingSeconds;  // 用于跟踪上一次的剩余时间
     bool isRunning;
     bool isPaused;
     bool isCountdown;  // 是否处于3秒倒计时状态
     int countdownSeconds;  // 倒计时秒数
     bool isStartSoundPlayed;  // 是否已经播放了开始声音
+    bool isPreRoll;           // 倒计时前等待提示声音发出 (isCountdown同时为true)
+    int64_t preRollRequestUs; // 请求播放提示声音的时刻
+    int64_t preRollAnchorUs;  // 倒计时起点，未确定时为-1
+    int64_t eventTimeUs;      // 正在处理的事件的发生时刻，不在事件处理中时为-1
     unsigned long lastDisplayedTime; // 上次显示更新的时间戳
     int lastDisplayedSeconds;      // 新增：上次显示的秒数
+    int countdownShown;            // LCD上已绘制的倒计时数字 (-1 = 未绘制)
     int lastDisplayedMilliseconds; // 新增：上次显示的毫秒数
     
     // 关键时间点降低LED亮度相关变量
     bool isPlayingSoundAtKeyTime;   // 是否正在关键时间点播放声音
     unsigned long soundPlayStartTime; // 声音开始播放的时间
+    uint16_t soundDimDurationMs;      // 降低亮度的持续时间
+    EspCueClock cueClock;             // 提示调度器的esp_timer时钟 (须在cueScheduler之前构造)
+    CueScheduler cueScheduler;        // 关键时间点提示调度器
+    
+    // LED图层
+    LEDCompositor compositor;
+    int iconLayer;                    // 秒表图标
+    int digitsLayer;                  // 剩余秒数
+    int warningLayer;                 // 最后几秒闪烁的警示边框
+    int ledDigitsValue;               // 数字图层当前显示的数值 (-1为空)
+    uint32_t ledTensColor;            // 数字图层当前的十位颜色
+    uint32_t ledOnesColor;            // 数字图层当前的个位颜色
 
     // UI相关变量
     static const uint16_t LIGHT_GRAY = 0x8410;  // 浅灰色
@@ -82,6 +116,9 @@ private:
     bool isLEDOff;                   // LED矩阵是否已关闭
     int originalBrightness;          // 原始亮度值
     
+    // 时间数字的LCD渲染器，只推送变化的字符单元
+    LcdDigitRenderer timeRenderer;
+    
     // 私有方法
     void updateTimeDisplay(); // 只更新时间显示部分，减少闪烁
 }; 
\ No newline at end of file
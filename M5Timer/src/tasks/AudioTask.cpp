@@ -1,124 +1,279 @@
 #include "AudioTask.h"
 #include "../core/Player.h"
+#include <esp_timer.h>
 
 // 移除全局变量定义，只在main.cpp中定义
 // 这里只使用extern定义的外部变量
 
+// 待执行消息的最大数量 (与audioQueue长度一致)
+#define AUDIO_BATCH_MAX 10
+
+// 音频统计计数器
+static AudioStats audioStats = {0, 0, 0, 0, 0};
+static portMUX_TYPE audioStatsLock = portMUX_INITIALIZER_UNLOCKED;
+
+// 最近一次发送完成的选曲命令 (由audioStatsLock保护)
+static bool trackSentValid = false;
+static uint16_t trackSentTrack = 0;
+static int64_t trackSentUs = 0;
+
+// 累加统计计数器 (可在任意任务中调用)
+static void addStat(uint32_t* counter, uint32_t value) {
+    portENTER_CRITICAL(&audioStatsLock);
+    *counter += value;
+    portEXIT_CRITICAL(&audioStatsLock);
+}
+
+// 是否为可以中止正在发送序列的高优先级消息
+static bool isPreempting(AudioMessageType type) {
+    return type == MSG_AUDIO_STOP || type == MSG_AUDIO_TRACK || type == MSG_AUDIO_RANDOM;
+}
+
+// 是否为会被后续停止/选曲命令取代的播放控制消息
+static bool isPlaybackControl(AudioMessageType type) {
+    return type == MSG_AUDIO_STOP || type == MSG_AUDIO_TRACK || type == MSG_AUDIO_RANDOM ||
+           type == MSG_AUDIO_PLAY || type == MSG_AUDIO_PAUSE || type == MSG_AUDIO_NEXT;
+}
+
+// 将新消息合并到待执行列表，返回新的列表长度
+// - 停止/选曲会取代之前所有播放控制消息 (选曲本身会先发送停止)
+// - 音量只保留最后一次
+static int coalesceMessage(AudioMessage* batch, int count, const AudioMessage& msg) {
+    int kept = 0;
+    for (int i = 0; i < count; i++) {
+        bool replaced = false;
+        if (msg.type == MSG_AUDIO_VOLUME) {
+            replaced = batch[i].type == MSG_AUDIO_VOLUME;
+        } else if (msg.type == MSG_AUDIO_STOP || msg.type == MSG_AUDIO_TRACK || msg.type == MSG_AUDIO_RANDOM) {
+            replaced = isPlaybackControl(batch[i].type);
+        }
+
+        if (replaced) {
+            addStat(&audioStats.coalesced, 1);
+        } else {
+            batch[kept++] = batch[i];
+        }
+    }
+
+    if (kept < AUDIO_BATCH_MAX) {
+        batch[kept++] = msg;
+    } else {
+        addStat(&audioStats.dropped, 1);
+    }
+    return kept;
+}
+
+// 记录发送完成的选曲命令并通知ModeTask
+static void reportTrackSent(JQ8900Player& player) {
+    uint16_t track;
+    int64_t sentUs;
+    if (!player.takeTrackSent(&track, &sentUs)) return;
+
+    portENTER_CRITICAL(&audioStatsLock);
+    trackSentValid = true;
+    trackSentTrack = track;
+    trackSentUs = sentUs;
+    portEXIT_CRITICAL(&audioStatsLock);
+
+    if (eventQueue != NULL) {
+        EventMessage eventMsg;
+        eventMsg.type = EVENT_AUDIO_SENT;
+        eventMsg.timestampUs = (uint32_t)sentUs;
+        xQueueSend(eventQueue, &eventMsg, 0);
+    }
+}
+
+// 空闲时输出统计计数器 (与上次输出相比有变化时)
+static void logAudioStats() {
+    static uint32_t loggedReceived = 0;
+    AudioStats stats;
+    audioGetStats(&stats);
+    if (stats.received == loggedReceived) return;
+    loggedReceived = stats.received;
+
+    Serial.printf("AudioTask: 收到 %lu 条, 合并 %lu 条, 丢弃 %lu 条, 中止 %lu 次, 执行 %lu 条\n",
+                  (unsigned long)stats.received, (unsigned long)stats.coalesced, (unsigned long)stats.dropped,
+                  (unsigned long)stats.aborted, (unsigned long)stats.executed);
+}
+
+// 执行一条音频消息
+static void executeMessage(JQ8900Player& player, const AudioMessage& msg) {
+    switch (msg.type) {
+        case MSG_AUDIO_PLAY:
+            Serial.println("AudioTask: 播放");
+            player.play();
+            break;
+
+        case MSG_AUDIO_PAUSE:
+            Serial.println("AudioTask: 暂停");
+            player.pause();
+            break;
+
+        case MSG_AUDIO_STOP:
+            Serial.println("AudioTask: 停止");
+            player.stop();
+            break;
+
+        case MSG_AUDIO_NEXT:
+            Serial.println("AudioTask: 下一曲");
+            player.next();
+            break;
+
+        case MSG_AUDIO_VOLUME:
+            Serial.println("AudioTask: 设置音量 " + String(msg.volume));
+            player.setVolume(msg.volume);
+            break;
+
+        case MSG_AUDIO_TRACK:
+            Serial.println("AudioTask: 播放曲目 " + String(msg.track));
+            player.playTrack(msg.track);
+            break;
+
+        case MSG_AUDIO_RANDOM:
+            Serial.println("AudioTask: 随机播放");
+            player.playRandom();
+            break;
+    }
+    addStat(&audioStats.executed, 1);
+}
+
 // 音频任务函数
 void audioTask(void *parameter) {
     // 获取播放器引脚
     uint8_t pin = (uint8_t)(intptr_t)parameter;
     AudioMessage msg;
-    
-    // 创建播放器实例 - 直接创建不使用单例
-    JQ8900Player player(pin);
-    
+
+    // 待执行的消息 (已合并)
+    AudioMessage pending[AUDIO_BATCH_MAX];
+    int pendingCount = 0;
+
+    // 正在发送的序列对应的消息类型，初始化序列 (音量/循环模式) 不允许被打断
+    AudioMessageType inFlightType = MSG_AUDIO_VOLUME;
+
+    // 创建播放器实例 - 静态存储，编码缓冲区较大，避免占用任务堆栈
+    static JQ8900Player player(pin);
+
     // 初始化播放器
     player.begin();
     player.setVolume(30);  // 设置默认音量为最大值30
     player.setLoopMode(LOOP_DISABLE);  // 设置默认循环模式为不循环
-    
+
     Serial.println("AudioTask: 任务启动，准备处理消息");
-    
+
     while (true) {
-        // 处理异步命令更新
+        // 序列发送中时等待当前分段完成，然后推进下一分段
+        if (player.isSequenceActive()) {
+            xTaskNotifyWait(0, PLAYER_NOTIFY_TX_DONE, NULL, pdMS_TO_TICKS(20));
+        }
         player.update();
-        
-        // 等待音频消息，使用较短的超时时间，而不是无限等待
-        if (xQueueReceive(audioQueue, &msg, pdMS_TO_TICKS(10)) == pdTRUE) {
-            // 获取音频互斥锁
-            if (xSemaphoreTake(audioMutex, pdMS_TO_TICKS(50)) == pdTRUE) {
-                // 处理音频消息 - 提高优先级
-                switch (msg.type) {
-                    case MSG_AUDIO_PLAY:
-                        Serial.println("AudioTask: 播放");
-                        player.play();
-                        break;
-                        
-                    case MSG_AUDIO_PAUSE:
-                        Serial.println("AudioTask: 暂停");
-                        player.pause();
-                        break;
-                        
-                    case MSG_AUDIO_STOP:
-                        Serial.println("AudioTask: 停止");
-                        player.stop();
-                        break;
-                        
-                    case MSG_AUDIO_NEXT:
-                        Serial.println("AudioTask: 下一曲");
-                        player.next();
-                        break;
-                        
-                    case MSG_AUDIO_VOLUME:
-                        Serial.println("AudioTask: 设置音量 " + String(msg.volume));
-                        player.setVolume(msg.volume);
-                        break;
-                        
-                    case MSG_AUDIO_TRACK:
-                        Serial.println("AudioTask: 播放曲目 " + String(msg.track));
-                        player.playTrack(msg.track);
-                        break;
-                        
-                    case MSG_AUDIO_RANDOM:
-                        Serial.println("AudioTask: 随机播放");
-                        player.playRandom();
-                        break;
-                }
-                
-                // 释放音频互斥锁
-                xSemaphoreGive(audioMutex);
+        reportTrackSent(player);
+
+        // 收集所有已到达的消息并合并，空闲且无待执行消息时一直阻塞等待
+        TickType_t wait = (player.isSequenceActive() || pendingCount > 0) ? 0 : portMAX_DELAY;
+        if (wait == portMAX_DELAY) {
+            logAudioStats();
+        }
+        int merged = 0;
+        while (xQueueReceive(audioQueue, &msg, wait) == pdTRUE) {
+            addStat(&audioStats.received, 1);
+            pendingCount = coalesceMessage(pending, pendingCount, msg);
+            merged++;
+            wait = 0;
+        }
+        if (merged > 1) {
+            Serial.println("AudioTask: 收到" + String(merged) + "条消息，合并后待执行" + String(pendingCount) + "条");
+        }
+
+        if (pendingCount == 0) continue;
+
+        // 序列发送中: 只有高优先级消息才能中止播放控制序列，音量设置不被打断
+        if (player.isSequenceActive()) {
+            if (!isPreempting(pending[0].type) || inFlightType == MSG_AUDIO_VOLUME) continue;
+            player.abort();
+            addStat(&audioStats.aborted, 1);
+        }
+
+        // 获取音频互斥锁并执行队首消息
+        if (xSemaphoreTake(audioMutex, pdMS_TO_TICKS(50)) == pdTRUE) {
+            executeMessage(player, pending[0]);
+            inFlightType = pending[0].type;
+
+            // 开始新序列前可能等完了上一段选曲
+            reportTrackSent(player);
+
+            for (int i = 1; i < pendingCount; i++) {
+                pending[i - 1] = pending[i];
             }
+            pendingCount--;
+
+            // 释放音频互斥锁
+            xSemaphoreGive(audioMutex);
         }
     }
 }
 
-// 帮助函数 - 发送音频停止命令并等待完成
+// 把一条音频消息追加到队尾，队列满时计入丢弃 (不输出日志，不分配内存)
+static bool enqueueAudioMessage(const AudioMessage& msg) {
+    if (audioQueue == NULL) return false;
+
+    // 按顺序追加到队尾，由音频任务负责合并与抢占
+    if (xQueueSend(audioQueue, &msg, 0) != pdTRUE) {
+        addStat(&audioStats.dropped, 1);
+        return false;
+    }
+    return true;
+}
+
+// 发送一条音频消息，队列满时计入丢弃并输出日志
+static void sendAudioMessage(const AudioMessage& msg) {
+    if (audioQueue != NULL && !enqueueAudioMessage(msg)) {
+        Serial.println("AudioTask: 队列已满，消息被丢弃");
+    }
+}
+
+// 帮助函数 - 发送音频停止命令
 void audioStop() {
     AudioMessage msg;
     msg.type = MSG_AUDIO_STOP;
-    
-    // 先销毁队列中的其他请求
-    if (audioQueue != NULL) {
-        xQueueReset(audioQueue);
-    }
-    
-    // 发送停止命令，设置最高优先级
-    if (audioQueue != NULL) {
-        xQueueSendToFront(audioQueue, &msg, 0);
-        
-        // 短暂延迟确保命令开始执行
-        delay(20);
-    }
+    sendAudioMessage(msg);
 }
 
-// 帮助函数 - 发送播放指定曲目命令
+// 帮助函数 - 发送播放指定曲目命令 (选曲序列本身会先停止当前播放)
 void audioPlayTrack(uint16_t track) {
-    // 先停止所有声音
-    audioStop();
-    
-    // 然后播放指定曲目
     AudioMessage msg;
     msg.type = MSG_AUDIO_TRACK;
     msg.track = track;
-    
-    if (audioQueue != NULL) {
-        Serial.println("发送播放命令，曲目: " + String(track) + " (阻塞)");
-        xQueueSendToFront(audioQueue, &msg, 0);  // 使用最高优先级，不等待
-        
-        // 短暂延迟确保命令开始执行
-        delay(20);
-    }
+
+    Serial.println("发送播放命令，曲目: " + String(track));
+    sendAudioMessage(msg);
 }
 
 // 帮助函数 - 发送播放指定曲目命令但不等待（非阻塞）
 void audioPlayTrackNonBlocking(uint16_t track) {
+    audioPlayTrack(track);
+}
+
+// 提示音 - 只入队，执行时由AudioTask输出日志，丢弃计入统计
+void audioCueTrack(uint16_t track) {
     AudioMessage msg;
     msg.type = MSG_AUDIO_TRACK;
     msg.track = track;
-    
-    if (audioQueue != NULL) {
-        Serial.println("发送播放命令，曲目: " + String(track) + " (非阻塞)");
-        xQueueSendToFront(audioQueue, &msg, 0);  // 使用最高优先级，不等待
-    }
-} 
\ No newline at end of file
+    enqueueAudioMessage(msg);
+}
+
+// 获取音频统计计数器
+void audioGetStats(AudioStats* stats) {
+    portENTER_CRITICAL(&audioStatsLock);
+    *stats = audioStats;
+    portEXIT_CRITICAL(&audioStatsLock);
+}
+
+// 获取最近一次发送完成的选曲命令
+bool audioGetTrackSent(uint16_t* track, int64_t* sentUs) {
+    portENTER_CRITICAL(&audioStatsLock);
+    bool valid = trackSentValid;
+    *track = trackSentTrack;
+    *sentUs = trackSentUs;
+    portEXIT_CRITICAL(&audioStatsLock);
+    return valid;
+}
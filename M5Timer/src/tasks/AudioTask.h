@@ -7,20 +7,41 @@
 #include <freertos/semphr.h>
 #include "../core/types.h"  // 包含共享类型定义
 
+// 音频统计计数器
+struct AudioStats {
+    uint32_t received;   // 收到的消息数
+    uint32_t coalesced;  // 被合并掉的消息数
+    uint32_t dropped;    // 队列满被丢弃的消息数
+    uint32_t aborted;    // 被高优先级消息中止的发送序列数
+    uint32_t executed;   // 实际发送到播放器的命令数
+};
+
 // 声明全局变量
 extern QueueHandle_t audioQueue;
 extern SemaphoreHandle_t audioMutex;
+extern QueueHandle_t eventQueue;
 
 // 音频任务函数
 void audioTask(void *parameter);
 
-// 帮助函数 - 发送音频停止命令并等待完成
+// 帮助函数 - 发送音频停止命令
 void audioStop();
 
-// 帮助函数 - 发送播放指定曲目命令并等待完成
+// 帮助函数 - 发送播放指定曲目命令
 void audioPlayTrack(uint16_t track);
 
 // 帮助函数 - 发送播放指定曲目命令但不等待（非阻塞）
 void audioPlayTrackNonBlocking(uint16_t track);
 
+// 提示音 - 发送播放指定曲目命令，不输出日志、不构造String
+// 供提示调度器在esp_timer任务中调用，日志由AudioTask执行命令时输出
+void audioCueTrack(uint16_t track);
+
+// 获取音频统计计数器
+void audioGetStats(AudioStats* stats);
+
+// 获取最近一次发送完成的选曲命令 (曲目与发完时刻)，还没有选曲完成时返回false
+// 每次选曲完成后还会向eventQueue发送EVENT_AUDIO_SENT唤醒ModeTask
+bool audioGetTrackSent(uint16_t* track, int64_t* sentUs);
+
 #endif // AUDIO_TASK_H 
\ No newline at end of file
@@ -1,140 +1,284 @@
 #include "InputTask.h"
 #include <M5Unified.h>
+#include <esp_timer.h>
+#include "../core/ButtonDebouncer.h"
+#include "../core/ImuFifo.h"
+#include "../core/MotionClassifier.h"
 
-// 按键长按时间阈值（毫秒）
-const unsigned long LONG_PRESS_TIME = 1000;
+// 按键引脚 (M5StickC: BtnA = GPIO37, BtnB = GPIO39，低电平有效)
+const uint8_t PIN_BUTTON_A = 37;
+const uint8_t PIN_BUTTON_B = 39;
 
-// 晃动检测相关常量
-const float SHAKE_THRESHOLD = 1.5f;  // 晃动阈值
-const unsigned long SHAKE_COOLDOWN = 1000;  // 晃动检测冷却时间（毫秒）
+// IMU中断引脚 (MPU6886 INT = GPIO35，低电平有效)
+const uint8_t PIN_IMU_INT = 35;
+
+// 边沿队列长度 - 队列满时丢弃的按键边沿由消抖状态机在锁定结束时按实际电平补齐
+const int INPUT_EDGE_QUEUE_LENGTH = 32;
 
 // 蜂鸣器音调频率
 const uint16_t BEEP_FREQUENCY = 2000;  // 更高的蜂鸣器频率，使声音更清脆
 const uint8_t BEEP_VOLUME = 64;  // 音量控制，范围0-255
 const uint16_t BEEP_DURATION = 50;  // 蜂鸣持续时间（毫秒）
 
-void inputTask(void *parameter) {
-    EventMessage eventMsg;
-    unsigned long buttonATime = 0;  // A按钮按下时间
-    unsigned long buttonBTime = 0;  // B按钮按下时间
-    bool buttonAPressed = false;
-    bool buttonBPressed = false;
-    bool buttonALongPressHandled = false;  // A按钮长按处理标记
-    bool buttonBLongPressHandled = false;  // B按钮长按处理标记
-    bool isBeeperOn = false;  // 蜂鸣器状态
-    
-    // 晃动检测相关变量
-    float lastAccelX = 0.0f, lastAccelY = 0.0f, lastAccelZ = 0.0f;
-    unsigned long lastShakeTime = 0;
+// 运动期间读取IMU FIFO的间隔（毫秒），FIFO可缓存约0.7秒的样本
+const unsigned long IMU_DRAIN_INTERVAL = 100;
+
+// 不支持FIFO时直接读取加速度的间隔（毫秒）
+const unsigned long IMU_POLL_INTERVAL = 20;
+
+// 中断中采集的按键/IMU边沿
+struct InputEdge {
+    uint8_t pin;        // 触发中断的引脚
+    bool pressed;       // 边沿后的电平 (true = 按下)
+    uint32_t timeUs;    // 中断发生时刻 (esp_timer微秒)
+};
+
+// 单个按键的状态
+struct ButtonState {
+    uint8_t pin;
+    const char* name;
+    EventType shortEvent;   // 短按事件
+    EventType longEvent;    // 长按事件
+    ButtonDebouncer debouncer;
+};
+
+static QueueHandle_t inputEdgeQueue = NULL;
+
+static ButtonState buttons[] = {
+    {PIN_BUTTON_A, "A", EVENT_BUTTON_A, EVENT_BUTTON_A_LONG, ButtonDebouncer()},
+    {PIN_BUTTON_B, "B", EVENT_BUTTON_B, EVENT_BUTTON_B_LONG, ButtonDebouncer()}
+};
+static const int BUTTON_COUNT = sizeof(buttons) / sizeof(buttons[0]);
+
+static ImuFifo imuFifo;
+static MotionClassifier motionClassifier;
+static MotionSample motionSamples[IMU_FIFO_MAX_PACKETS];
+
+// 按键边沿中断 - 只采样电平与时间戳，消抖在任务中完成
+static void IRAM_ATTR onInputEdge(void* arg) {
+    InputEdge edge;
+    edge.pin = (uint8_t)(intptr_t)arg;
+    edge.pressed = digitalRead(edge.pin) == LOW;
+    edge.timeUs = (uint32_t)esp_timer_get_time();
     
-    Serial.println("InputTask started");
+    BaseType_t woken = pdFALSE;
+    xQueueSendFromISR(inputEdgeQueue, &edge, &woken);
+    if (woken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+// IMU运动中断 - 只负责唤醒任务
+static void IRAM_ATTR onImuInterrupt() {
+    InputEdge edge;
+    edge.pin = PIN_IMU_INT;
+    edge.pressed = true;
+    edge.timeUs = (uint32_t)esp_timer_get_time();
     
-    while (true) {
-        M5.update();
-        
-        // 检测晃动
-        float accX, accY, accZ;
-        if (M5.Imu.getAccel(&accX, &accY, &accZ)) {  // 如果成功读取加速度数据
-            // 计算加速度变化
-            float deltaX = fabs(accX - lastAccelX);
-            float deltaY = fabs(accY - lastAccelY);
-            float deltaZ = fabs(accZ - lastAccelZ);
+    BaseType_t woken = pdFALSE;
+    xQueueSendFromISR(inputEdgeQueue, &edge, &woken);
+    if (woken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+// 发送带时间戳的事件
+static void sendEvent(EventType type, uint32_t timestampUs) {
+    EventMessage eventMsg;
+    eventMsg.type = type;
+    eventMsg.timestampUs = timestampUs;
+    xQueueSend(eventQueue, &eventMsg, 0);
+}
+
+// 执行消抖状态机输出的动作
+static void handleButtonAction(ButtonState& button, ButtonAction action) {
+    switch (action) {
+        case BUTTON_ACTION_PRESS:
+            Serial.printf("Button %s Pressed\n", button.name);
+            // 按下时开始蜂鸣
+            M5.Speaker.setVolume(BEEP_VOLUME);
+            M5.Speaker.tone(BEEP_FREQUENCY, BEEP_DURATION);  // 短促的蜂鸣声
+            break;
             
-            // 更新上次的加速度值
-            lastAccelX = accX;
-            lastAccelY = accY;
-            lastAccelZ = accZ;
+        case BUTTON_ACTION_SHORT:
+            // 松开时停止蜂鸣，只有在没有触发长按的情况下才发送短按
+            M5.Speaker.stop();
+            Serial.printf("Short Press %s\n", button.name);
+            sendEvent(button.shortEvent, button.debouncer.eventTimeUs());
+            break;
             
-            // 检查是否超过晃动阈值
-            float totalDelta = deltaX + deltaY + deltaZ;
-            unsigned long currentTime = millis();
+        case BUTTON_ACTION_LONG:
+            // 达到长按阈值立即触发，无需等待松开按钮
+            Serial.printf("Long Press %s\n", button.name);
+            sendEvent(button.longEvent, button.debouncer.eventTimeUs());
+            break;
             
-            if (totalDelta > SHAKE_THRESHOLD && 
-                currentTime - lastShakeTime > SHAKE_COOLDOWN) {
-                lastShakeTime = currentTime;
+        case BUTTON_ACTION_RELEASE:
+            M5.Speaker.stop();
+            break;
+            
+        case BUTTON_ACTION_NONE:
+            break;
+    }
+}
+
+// 处理所有按键的锁定结束与长按，返回距离下一次需要处理的时间（微秒）
+static uint32_t pollButtons() {
+    uint32_t nowUs = (uint32_t)esp_timer_get_time();
+    uint32_t deadline = BUTTON_NO_DEADLINE;
+    
+    for (int i = 0; i < BUTTON_COUNT; i++) {
+        ButtonState& button = buttons[i];
+        bool rawPressed = digitalRead(button.pin) == LOW;
+        ButtonAction action;
+        while ((action = button.debouncer.poll(nowUs, rawPressed)) != BUTTON_ACTION_NONE) {
+            handleButtonAction(button, action);
+        }
+        
+        uint32_t buttonDeadline = button.debouncer.nextDeadlineUs(nowUs);
+        if (buttonDeadline < deadline) deadline = buttonDeadline;
+    }
+    return deadline;
+}
+
+// 对一批加速度样本做晃动/倾斜分类并发送事件
+static void classifyMotion(const MotionSample* samples, size_t count, uint32_t lastTimeUs, uint32_t intervalUs) {
+    if (count == 0) return;
+    
+    MotionEvent events[MOTION_MAX_EVENTS];
+    uint32_t eventTimes[MOTION_MAX_EVENTS];
+    uint32_t firstTimeUs = lastTimeUs - (uint32_t)(count - 1) * intervalUs;
+    size_t eventCount = motionClassifier.process(samples, count, firstTimeUs, intervalUs,
+                                                 events, eventTimes, MOTION_MAX_EVENTS);
+    
+    for (size_t i = 0; i < eventCount; i++) {
+        switch (events[i]) {
+            case MOTION_EVENT_SHAKE:
                 Serial.println("Shake detected");
-                eventMsg.type = EVENT_SHAKE;
-                xQueueSend(eventQueue, &eventMsg, 0);
-            }
+                sendEvent(EVENT_SHAKE, eventTimes[i]);
+                break;
+            case MOTION_EVENT_TILT_LEFT:
+                Serial.println("Tilt left");
+                sendEvent(EVENT_TILT_LEFT, eventTimes[i]);
+                break;
+            case MOTION_EVENT_TILT_RIGHT:
+                Serial.println("Tilt right");
+                sendEvent(EVENT_TILT_RIGHT, eventTimes[i]);
+                break;
+            case MOTION_EVENT_TILT_CENTER:
+                Serial.println("Tilt center");
+                sendEvent(EVENT_TILT_CENTER, eventTimes[i]);
+                break;
         }
+    }
+}
+
+// 读取IMU，返回是否仍处于运动状态
+static bool drainImu() {
+    uint32_t nowUs = (uint32_t)esp_timer_get_time();
+    
+    if (imuFifo.isReady()) {
+        // 一次突发读取FIFO中的全部样本，读取后重新允许运动中断
+        size_t count = imuFifo.read(motionSamples, IMU_FIFO_MAX_PACKETS);
+        imuFifo.clearInterrupt();
+        classifyMotion(motionSamples, count, nowUs, imuFifo.sampleIntervalUs());
+        return !motionClassifier.isQuiet();
+    }
+    
+    // 不支持FIFO时逐个读取加速度
+    float accX, accY, accZ;
+    if (M5.Imu.getAccel(&accX, &accY, &accZ)) {
+        MotionSample sample = {accX, accY, accZ};
+        classifyMotion(&sample, 1, nowUs, IMU_POLL_INTERVAL * 1000);
+    }
+    return true;
+}
+
+// 进入静止时输出IMU的I2C事务与FIFO溢出计数
+static void logImuStats() {
+    Serial.printf("InputTask: IMU静止, I2C事务 %lu 次, FIFO溢出 %lu 次\n",
+                  (unsigned long)imuFifo.transactions(), (unsigned long)imuFifo.overflows());
+}
+
+// 配置按键中断
+static void beginButtons() {
+    inputEdgeQueue = xQueueCreate(INPUT_EDGE_QUEUE_LENGTH, sizeof(InputEdge));
+    
+    for (int i = 0; i < BUTTON_COUNT; i++) {
+        // GPIO37/39为仅输入引脚，板上已有上拉电阻
+        pinMode(buttons[i].pin, INPUT);
+        attachInterruptArg(buttons[i].pin, onInputEdge, (void*)(intptr_t)buttons[i].pin, CHANGE);
+    }
+    Serial.println("InputTask: 按键中断已启用");
+}
+
+// 配置IMU FIFO与运动中断
+static void beginImu() {
+    if (!imuFifo.begin()) {
+        Serial.println("InputTask: IMU不支持FIFO，改为定时读取");
+        return;
+    }
+    pinMode(PIN_IMU_INT, INPUT);
+    attachInterrupt(PIN_IMU_INT, onImuInterrupt, FALLING);
+}
+
+void inputTask(void *parameter) {
+    InputEdge edge;
+    
+    // 是否处于运动状态 (运动期间定时读取FIFO，静止后只等待运动中断)
+    bool imuActive = true;
+    unsigned long lastImuTime = 0;
+    
+    beginButtons();
+    beginImu();
+    Serial.println("InputTask started");
+    
+    while (true) {
+        // 处理锁定结束与长按，等待时间取按键截止时间与下一次IMU读取中较早者
+        uint32_t buttonDeadlineUs = pollButtons();
         
-        // 检测按键A - 长按立即触发事件
-        if (M5.BtnA.wasPressed()) {
-            buttonATime = millis();
-            buttonAPressed = true;
-            buttonALongPressHandled = false;
-            Serial.println("Button A Pressed");
-            // 按下A键时开始蜂鸣
-            M5.Speaker.setVolume(BEEP_VOLUME);
-            M5.Speaker.tone(BEEP_FREQUENCY, BEEP_DURATION);  // 短促的蜂鸣声
-            isBeeperOn = true;
-        } else if (M5.BtnA.wasReleased()) {
-            // 松开A键时停止蜂鸣
-            if (isBeeperOn) {
-                M5.Speaker.stop();
-                isBeeperOn = false;
-            }
-            
-            if (buttonAPressed && !buttonALongPressHandled) {
-                // 只有在没有处理过长按的情况下才处理短按
-                Serial.println("Short Press A");
-                eventMsg.type = EVENT_BUTTON_A;
-                xQueueSend(eventQueue, &eventMsg, 0);
-            }
-            buttonAPressed = false;
-            buttonALongPressHandled = false;
-        } else if (buttonAPressed && M5.BtnA.isPressed()) {
-            // 检查是否达到长按阈值但尚未处理
-            unsigned long pressDuration = millis() - buttonATime;
-            if (pressDuration >= LONG_PRESS_TIME && !buttonALongPressHandled) {
-                // 长按A键 - 立即触发事件，无需等待松开按钮
-                Serial.println("Long Press A");
-                // 不需要再次触发蜂鸣器，因为按下时已经开始蜂鸣
-                eventMsg.type = EVENT_BUTTON_A_LONG;
-                xQueueSend(eventQueue, &eventMsg, 0);
-                buttonALongPressHandled = true;
-            }
+        TickType_t timeout = portMAX_DELAY;
+        if (imuActive) {
+            unsigned long interval = imuFifo.isReady() ? IMU_DRAIN_INTERVAL : IMU_POLL_INTERVAL;
+            unsigned long sinceImu = millis() - lastImuTime;
+            timeout = pdMS_TO_TICKS(sinceImu >= interval ? 0 : interval - sinceImu);
+        }
+        if (buttonDeadlineUs != BUTTON_NO_DEADLINE) {
+            TickType_t buttonTimeout = pdMS_TO_TICKS((buttonDeadlineUs + 999) / 1000);
+            if (buttonTimeout < timeout) timeout = buttonTimeout;
         }
         
-        // 检测按键B - 长按立即触发事件
-        if (M5.BtnB.wasPressed()) {
-            buttonBTime = millis();
-            buttonBPressed = true;
-            buttonBLongPressHandled = false;
-            Serial.println("Button B Pressed");
-            // 按下B键时开始蜂鸣
-            M5.Speaker.setVolume(BEEP_VOLUME);
-            M5.Speaker.tone(BEEP_FREQUENCY, BEEP_DURATION);  // 短促的蜂鸣声
-            isBeeperOn = true;
-        } else if (M5.BtnB.wasReleased()) {
-            // 松开B键时停止蜂鸣
-            if (isBeeperOn) {
-                M5.Speaker.stop();
-                isBeeperOn = false;
-            }
-            
-            if (buttonBPressed && !buttonBLongPressHandled) {
-                // 只有在没有处理过长按的情况下才处理短按
-                Serial.println("Short Press B");
-                eventMsg.type = EVENT_BUTTON_B;
-                xQueueSend(eventQueue, &eventMsg, 0);
-            }
-            buttonBPressed = false;
-            buttonBLongPressHandled = false;
-        } else if (buttonBPressed && M5.BtnB.isPressed()) {
-            // 检查是否达到长按阈值但尚未处理
-            unsigned long pressDuration = millis() - buttonBTime;
-            if (pressDuration >= LONG_PRESS_TIME && !buttonBLongPressHandled) {
-                // 长按B键 - 立即切换模式，无需等待松开按钮
-                Serial.println("Long Press B - Mode Switch");
-                // 不需要再次触发蜂鸣器，因为按下时已经开始蜂鸣
-                eventMsg.type = EVENT_BUTTON_B_LONG;
-                xQueueSend(eventQueue, &eventMsg, 0);
-                buttonBLongPressHandled = true;
-            }
+        // 在按键边沿或运动中断到来前休眠
+        if (xQueueReceive(inputEdgeQueue, &edge, timeout) == pdTRUE) {
+            do {
+                if (edge.pin == PIN_IMU_INT) {
+                    // 静止期间FIFO早已写满并覆盖，包边界错位，唤醒后从空FIFO开始
+                    if (!imuActive && imuFifo.isReady()) {
+                        imuFifo.resetFifo();
+                        lastImuTime = millis();
+                    }
+                    imuActive = true;
+                    continue;
+                }
+                for (int i = 0; i < BUTTON_COUNT; i++) {
+                    if (buttons[i].pin == edge.pin) {
+                        handleButtonAction(buttons[i], buttons[i].debouncer.onEdge(edge.pressed, edge.timeUs));
+                        break;
+                    }
+                }
+            } while (xQueueReceive(inputEdgeQueue, &edge, 0) == pdTRUE);
         }
         
-        // 任务延时
-        vTaskDelay(pdMS_TO_TICKS(20));
+        if (!imuActive) continue;
+        
+        unsigned long currentTime = millis();
+        unsigned long interval = imuFifo.isReady() ? IMU_DRAIN_INTERVAL : IMU_POLL_INTERVAL;
+        if (currentTime - lastImuTime < interval) continue;
+        lastImuTime = currentTime;
+        
+        imuActive = drainImu();
+        if (!imuActive) {
+            logImuStats();
+        }
     }
-} 
\ No newline at end of file
+}
\ No newline at end of file
@@ -1,11 +1,61 @@
 #include "ModeTask.h"
 #include <M5Unified.h>
+#include <esp_timer.h>
 
 // 模式管理静态变量
 static std::vector<Mode*> modes;
+static std::vector<ModeWakeStats> modeWakeStats;  // 每个模式的唤醒计数
 static int currentModeIndex = 0;
 static bool screenModeAvailable = false; // 标记ScreenMode是否可用
 
+// 串口接收环形缓冲区
+static ByteRing serialRxRing;
+
+// 串口数据事件是否已在队列中，避免连续数据塞满事件队列
+// UART事件任务与ModeTask可能在不同核心上，读写都用原子操作
+static bool serialEventPending = false;
+
+// 串口接收回调 (在UART事件任务中运行) - 把数据搬入环形缓冲区并通知ModeTask
+static void onSerialReceive() {
+    uint8_t chunk[64];
+    int available;
+    while ((available = Serial.available()) > 0) {
+        size_t length = Serial.read(chunk, available < (int)sizeof(chunk) ? available : sizeof(chunk));
+        if (length == 0) break;
+        serialRxRing.write(chunk, length);
+    }
+    
+    if (eventQueue == NULL) return;
+    
+    // 先占用标志再发送: 若发送后才置位，ModeTask可能已处理完事件并清除标志，
+    // 之后的回调都会直接返回，ModeTask再也不会被唤醒
+    if (__atomic_exchange_n(&serialEventPending, true, __ATOMIC_ACQ_REL)) return;
+    
+    EventMessage eventMsg;
+    eventMsg.type = EVENT_SERIAL_DATA;
+    eventMsg.timestampUs = (uint32_t)esp_timer_get_time();
+    if (xQueueSend(eventQueue, &eventMsg, 0) != pdTRUE) {
+        // 队列满: 释放标志，下一次回调或ModeTask的兜底检查会处理剩余数据
+        __atomic_store_n(&serialEventPending, false, __ATOMIC_RELEASE);
+    }
+}
+
+// 打印模式的唤醒统计
+static void logModeWakeStats(int modeIndex) {
+    const ModeWakeStats& stats = modeWakeStats[modeIndex];
+    Serial.printf("ModeTask: %s 唤醒 %u 次 (事件 %u, 定时 %u)\n",
+                  modes[modeIndex]->getName(), stats.wakes, stats.eventWakes, stats.timeoutWakes);
+}
+
+// 退出当前模式
+static void exitCurrentMode() {
+    if (currentModeIndex >= 0 && currentModeIndex < modes.size()) {
+        Serial.println("ModeTask: 退出模式: " + String(modes[currentModeIndex]->getName()));
+        logModeWakeStats(currentModeIndex);
+        modes[currentModeIndex]->exit();
+    }
+}
+
 // 检查是否是ScreenMode
 bool isScreenMode(Mode* mode) {
     return (mode != nullptr && String(mode->getName()) == "Screen");
@@ -25,6 +75,7 @@ int getScreenModeIndex() {
 void registerMode(Mode* mode) {
     if (mode != nullptr) {
         modes.push_back(mode);
+        modeWakeStats.push_back(ModeWakeStats{0, 0, 0});
         Serial.println("ModeTask: 注册模式: " + String(mode->getName()));
         
         // 检查是否是ScreenMode
@@ -58,6 +109,17 @@ int getRegisteredModeCount() {
     return modes.size();
 }
 
+ByteRing& getSerialRxRing() {
+    return serialRxRing;
+}
+
+// 获取模式的唤醒计数
+bool getModeWakeStats(int modeIndex, ModeWakeStats* stats) {
+    if (modeIndex < 0 || modeIndex >= modeWakeStats.size()) return false;
+    *stats = modeWakeStats[modeIndex];
+    return true;
+}
+
 // 设置ScreenMode是否可用
 void setScreenModeAvailable(bool available) {
     screenModeAvailable = available;
@@ -69,10 +131,7 @@ void switchToNextMode() {
     if (modes.empty()) return;
     
     // 退出当前模式
-    if (currentModeIndex >= 0 && currentModeIndex < modes.size()) {
-        Serial.println("ModeTask: 退出模式: " + String(modes[currentModeIndex]->getName()));
-        modes[currentModeIndex]->exit();
-    }
+    exitCurrentMode();
     
     // 切换到下一个模式，如果ScreenMode不可用且下一个是ScreenMode，则跳过
     int nextIndex = (currentModeIndex + 1) % modes.size();
@@ -95,10 +154,7 @@ void switchToPreviousMode() {
     if (modes.empty()) return;
     
     // 退出当前模式
-    if (currentModeIndex >= 0 && currentModeIndex < modes.size()) {
-        Serial.println("ModeTask: 退出模式: " + String(modes[currentModeIndex]->getName()));
-        modes[currentModeIndex]->exit();
-    }
+    exitCurrentMode();
     
     // 切换到上一个模式，如果ScreenMode不可用且上一个是ScreenMode，则跳过
     int prevIndex = (currentModeIndex - 1 + modes.size()) % modes.size();
@@ -128,10 +184,7 @@ void switchToMode(int modeIndex) {
     }
     
     // 退出当前模式
-    if (currentModeIndex >= 0 && currentModeIndex < modes.size()) {
-        Serial.println("ModeTask: 退出模式: " + String(modes[currentModeIndex]->getName()));
-        modes[currentModeIndex]->exit();
-    }
+    exitCurrentMode();
     
     // 设置新的当前模式
     currentModeIndex = modeIndex;
@@ -152,7 +205,7 @@ bool switchToScreenMode() {
     return false;
 }
 
-// ModeTask主函数
+// ModeTask主函数 - 阻塞等待事件，超时时间由当前模式的下一个截止时间决定
 void modeTask(void *parameter) {
     EventMessage eventMsg;
     
@@ -166,27 +219,33 @@ void modeTask(void *parameter) {
     // 初始状态下，ScreenMode不可用（除非接收到串口数据）
     setScreenModeAvailable(false);
     
-    // 上次检查串口的时间
-    unsigned long lastSerialCheckTime = 0;
+    // 串口收到数据时立即唤醒，不再定时轮询
+    Serial.onReceive(onSerialReceive);
     
     while (true) {
-        // 检查串口是否有数据，每100ms检查一次，避免频繁检查
-        unsigned long currentTime = millis();
-        if (currentTime - lastSerialCheckTime > 100) {
-            lastSerialCheckTime = currentTime;
-            
-            if (Serial.available() > 0) {
-                // 检测到串口有数据，切换到ScreenMode
-                Mode* currentMode = getCurrentMode();
-                if (!isScreenMode(currentMode)) {
-                    Serial.println("ModeTask: 检测到串口数据，切换到ScreenMode");
-                    switchToScreenMode();
-                }
+        // 根据当前模式的截止时间决定等待时长，没有动画时一直等待事件
+        Mode* currentMode = getCurrentMode();
+        uint32_t deadline = (currentMode != nullptr) ? currentMode->nextDeadline() : MODE_NO_DEADLINE;
+        TickType_t timeout = portMAX_DELAY;
+        if (deadline != MODE_NO_DEADLINE) {
+            timeout = pdMS_TO_TICKS(deadline);
+            if (timeout == 0) timeout = 1;  // 至少让出一个tick
+        }
+        
+        bool hasEvent = xQueueReceive(eventQueue, &eventMsg, timeout) == pdTRUE;
+        
+        // 记录唤醒原因
+        if (currentModeIndex >= 0 && currentModeIndex < modeWakeStats.size()) {
+            ModeWakeStats& stats = modeWakeStats[currentModeIndex];
+            stats.wakes++;
+            if (hasEvent) {
+                stats.eventWakes++;
+            } else {
+                stats.timeoutWakes++;
             }
         }
         
-        // 检查事件消息
-        if (xQueueReceive(eventQueue, &eventMsg, 0) == pdTRUE) {
+        if (hasEvent) {
             // 处理事件
             switch (eventMsg.type) {
                 case EVENT_BUTTON_B_LONG:
@@ -195,23 +254,36 @@ void modeTask(void *parameter) {
                     switchToNextMode();
                     break;
                     
+                case EVENT_SERIAL_DATA:
+                    // 串口收到数据，允许下一次通知
+                    __atomic_store_n(&serialEventPending, false, __ATOMIC_RELEASE);
+                    if (!isScreenMode(getCurrentMode())) {
+                        // 检测到串口有数据，切换到ScreenMode
+                        Serial.println("ModeTask: 检测到串口数据，切换到ScreenMode");
+                        switchToScreenMode();
+                    }
+                    break;
+                    
                 default:
                     // 其他事件发送给当前模式处理
-                    Mode* currentMode = getCurrentMode();
+                    currentMode = getCurrentMode();
                     if (currentMode != nullptr) {
-                        currentMode->handleEvent(eventMsg.type);
+                        currentMode->handleEventMessage(eventMsg);
                     }
                     break;
             }
         }
         
+        // 兜底: 回调注册前已到达或通知被丢弃的串口数据
+        if ((serialRxRing.available() > 0 || Serial.available() > 0) && !isScreenMode(getCurrentMode())) {
+            Serial.println("ModeTask: 检测到串口数据，切换到ScreenMode");
+            switchToScreenMode();
+        }
+        
         // 更新当前模式
-        Mode* currentMode = getCurrentMode();
+        currentMode = getCurrentMode();
         if (currentMode != nullptr) {
             currentMode->update();
         }
-        
-        // 任务延时
-        vTaskDelay(pdMS_TO_TICKS(50));
     }
-} 
\ No newline at end of file
+}
\ No newline at end of file
@@ -7,8 +7,16 @@
 #include <freertos/semphr.h>
 #include "../core/types.h"
 #include "../core/Mode.h"
+#include "../core/ByteRing.h"
 #include <vector>
 
+// 模式唤醒计数 - 用于观察事件驱动带来的空闲唤醒减少
+struct ModeWakeStats {
+    uint32_t wakes;         // 总唤醒次数
+    uint32_t eventWakes;    // 由事件唤醒的次数
+    uint32_t timeoutWakes;  // 由截止时间到达唤醒的次数
+};
+
 // 外部队列声明
 extern QueueHandle_t modeQueue;
 extern QueueHandle_t eventQueue;
@@ -24,9 +32,13 @@ int getRegisteredModeCount();
 void switchToNextMode();
 void switchToPreviousMode();
 void switchToMode(int modeIndex);
+bool getModeWakeStats(int modeIndex, ModeWakeStats* stats);
 
 // ScreenMode相关函数
 bool isScreenMode(Mode* mode);
 int getScreenModeIndex();
 void setScreenModeAvailable(bool available);
-bool switchToScreenMode(); 
\ No newline at end of file
+bool switchToScreenMode();
+
+// 串口接收环形缓冲区 (由串口接收回调写入，ScreenMode读取)
+ByteRing& getSerialRxRing(); 
\ No newline at end of file
@@ -0,0 +1,225 @@
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+#include <chrono>
+#include "core/Spectrum.h"
+#include "core/BeatDetector.h"
+
+// 与MusicMode相同的采样率，每个分析帧FFT_SIZE个采样
+#define SAMPLE_RATE       44100
+
+// 节拍音轨: 第一拍的位置与每拍的敲击声 (衰减的噪声脉冲)
+#define CLICK_OFFSET_S    0.137
+#define CLICK_LENGTH_S    0.03
+#define CLICK_DECAY_S     0.006
+#define CLICK_AMPLITUDE   12000.0
+
+// 每个音轨的时长 (秒)
+#define TRACK_SECONDS     20.0
+
+// 节拍与敲击声的最大偏差 (毫秒)
+#define BEAT_TOLERANCE_MS 25.0
+
+// 可重复的伪随机数 (xorshift32)
+// 其他测试用的线性同余发生器低位周期太短，作为音频噪声时频谱上会出现周期性的起伏
+static uint32_t randomSeed;
+
+static uint32_t nextRandom() {
+    randomSeed ^= randomSeed << 13;
+    randomSeed ^= randomSeed >> 17;
+    randomSeed ^= randomSeed << 5;
+    return randomSeed;
+}
+
+// -1到1之间的均匀噪声
+static double noise() {
+    return nextRandom() / 2147483647.5 - 1.0;
+}
+
+// 生成节拍音轨: 背景噪声 + 440Hz正弦 + 每拍一次敲击，clicksUntilS之后不再敲击
+static std::vector<int16_t> clickTrack(double bpm, double noiseAmplitude, double toneAmplitude,
+                                       double clicksUntilS = TRACK_SECONDS) {
+    int total = (int)(SAMPLE_RATE * TRACK_SECONDS);
+    std::vector<int16_t> samples(total);
+    double period = 60.0 * SAMPLE_RATE / bpm;
+    double offset = CLICK_OFFSET_S * SAMPLE_RATE;
+    for (int i = 0; i < total; i++) {
+        double v = noiseAmplitude * noise() + toneAmplitude * sin(2.0 * M_PI * 440.0 * i / SAMPLE_RATE);
+        double phase = fmod(i - offset + period * 100, period);
+        if (i >= offset && i < clicksUntilS * SAMPLE_RATE && phase < CLICK_LENGTH_S * SAMPLE_RATE) {
+            v += CLICK_AMPLITUDE * exp(-phase / (CLICK_DECAY_S * SAMPLE_RATE)) * noise();
+        }
+        if (v > 32767) v = 32767;
+        if (v < -32768) v = -32768;
+        samples[i] = (int16_t)v;
+    }
+    return samples;
+}
+
+// 按MusicMode::processFrame的方式逐帧分析的结果
+struct TrackResult {
+    int onsets;
+    int beats;
+    int aligned;          // 与敲击声相差不超过BEAT_TOLERANCE_MS的节拍数
+    int firstBeatFrame;
+    int lastBeatFrame;
+    uint16_t bpm;
+    double maxFrameUs;    // 单帧分析 + 节拍检测的最大耗时
+    double totalUs;
+    int frames;
+};
+
+static TrackResult analyze(const std::vector<int16_t>& samples, double bpm) {
+    SpectrumAnalyzer spectrum;
+    BeatDetector detector(SAMPLE_RATE, FFT_SIZE);
+    TrackResult result = {0, 0, 0, -1, -1, 0, 0, 0, 0};
+    double period = 60.0 * SAMPLE_RATE / bpm;
+    double offset = CLICK_OFFSET_S * SAMPLE_RATE;
+
+    result.frames = (int)samples.size() / FFT_SIZE;
+    for (int frame = 0; frame < result.frames; frame++) {
+        auto start = std::chrono::steady_clock::now();
+        spectrum.process(&samples[frame * FFT_SIZE], 0);
+        uint8_t flags = detector.process(spectrum.bandLevels(), SPECTRUM_BANDS);
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        result.totalUs += us;
+        if (us > result.maxFrameUs) result.maxFrameUs = us;
+
+        if (flags & BEAT_FLAG_ONSET) result.onsets++;
+        if (flags & BEAT_FLAG_BEAT) {
+            result.beats++;
+            if (result.firstBeatFrame < 0) result.firstBeatFrame = frame;
+            result.lastBeatFrame = frame;
+            double phase = fmod(frame * (double)FFT_SIZE - offset + period * 100, period);
+            double errorMs = (phase < period - phase ? phase : period - phase) * 1000.0 / SAMPLE_RATE;
+            if (errorMs <= BEAT_TOLERANCE_MS) result.aligned++;
+        }
+    }
+    result.bpm = detector.bpm();
+    return result;
+}
+
+// [fromS, toS)内的敲击次数
+static int clicksBetween(double bpm, double fromS, double toS) {
+    double period = 60.0 / bpm;
+    int count = 0;
+    for (double t = CLICK_OFFSET_S; t < toS; t += period) {
+        if (t >= fromS) count++;
+    }
+    return count;
+}
+
+// 速度误差不超过2 BPM; 阈值历史填满后lockClicks次敲击内确定速度并开始输出节拍;
+// 锁定后每次敲击都有一拍且落在敲击声上，漏拍、多拍与偏差的拍各不超过missAllowed
+static void checkTrack(double bpm, double noiseAmplitude, double toneAmplitude, int lockClicks, int missAllowed) {
+    TrackResult result = analyze(clickTrack(bpm, noiseAmplitude, toneAmplitude), bpm);
+    double frameS = (double)FFT_SIZE / SAMPLE_RATE;
+    double warmUpS = BEAT_HISTORY_FRAMES * frameS;
+    double lockS = result.firstBeatFrame * frameS;
+    int clicks = clicksBetween(bpm, lockS, result.frames * frameS);
+
+    char message[192];
+    snprintf(message, sizeof(message),
+             "%.0f BPM, 噪声 %.0f: 检测 %u BPM, %.2f 秒锁定, 起音 %d, 节拍 %d (锁定后敲击 %d), 对齐 %d",
+             bpm, noiseAmplitude, result.bpm, lockS, result.onsets, result.beats, clicks, result.aligned);
+    TEST_MESSAGE(message);
+
+    TEST_ASSERT_INT_WITHIN(2, (int)lround(bpm), result.bpm);
+    TEST_ASSERT_TRUE(result.firstBeatFrame >= 0);
+    TEST_ASSERT_TRUE(clicksBetween(bpm, warmUpS, lockS) <= lockClicks);
+    TEST_ASSERT_INT_WITHIN(missAllowed, clicks, result.beats);
+    TEST_ASSERT_TRUE(result.aligned >= result.beats - missAllowed);
+}
+
+static const double TEMPOS[] = {70, 90, 120, 128, 150, 174};
+static const int TEMPO_COUNT = sizeof(TEMPOS) / sizeof(TEMPOS[0]);
+
+void setUp(void) {
+    randomSeed = 42;
+}
+
+void tearDown(void) {}
+
+// 安静背景下的节拍音轨: 第4次较强的起音即锁定
+void test_click_tracks_quiet(void) {
+    for (int i = 0; i < TEMPO_COUNT; i++) {
+        checkTrack(TEMPOS[i], 300, 0, 5, 1);
+    }
+}
+
+// 较强的噪声加上持续的音调 (能量高但没有起音): 敲击声的谱通量只有噪声起音的2倍左右，
+// 个别敲击被噪声掩盖或噪声起音落在相位窗口内，允许稍晚锁定与两拍偏差
+void test_click_tracks_noisy_with_tone(void) {
+    for (int i = 0; i < TEMPO_COUNT; i++) {
+        checkTrack(TEMPOS[i], 2000, 3000, 7, 2);
+    }
+}
+
+// 只有噪声: 没有节拍，速度未确定
+void test_noise_only_yields_no_beats(void) {
+    const double levels[] = {100, 300, 2000};
+    for (int i = 0; i < 3; i++) {
+        std::vector<int16_t> samples = clickTrack(120, levels[i], 0, 0);
+        TrackResult result = analyze(samples, 120);
+        TEST_ASSERT_EQUAL_INT(0, result.beats);
+        TEST_ASSERT_EQUAL_UINT16(0, result.bpm);
+    }
+}
+
+// 敲击停止后，节拍在BEAT_LOST_PERIODS个周期内停止输出
+void test_beats_stop_after_clicks_end(void) {
+    const double bpm = 120;
+    const double stopS = 10.0;
+    TrackResult result = analyze(clickTrack(bpm, 300, 0, stopS), bpm);
+
+    double framesPerBeat = 60.0 * SAMPLE_RATE / bpm / FFT_SIZE;
+    double stopFrame = stopS * SAMPLE_RATE / FFT_SIZE;
+    TEST_ASSERT_TRUE(result.beats > 0);
+    TEST_ASSERT_TRUE(result.lastBeatFrame < stopFrame + 5 * framesPerBeat);
+    TEST_ASSERT_EQUAL_UINT16(0, result.bpm);
+}
+
+// reset()后重新学习速度，与新建的检测器结果相同
+void test_reset_matches_fresh_detector(void) {
+    std::vector<int16_t> first = clickTrack(90, 300, 0);
+    std::vector<int16_t> second = clickTrack(150, 300, 0);
+    SpectrumAnalyzer spectrum;
+    BeatDetector reused(SAMPLE_RATE, FFT_SIZE);
+    BeatDetector fresh(SAMPLE_RATE, FFT_SIZE);
+
+    int frames = (int)first.size() / FFT_SIZE;
+    for (int frame = 0; frame < frames; frame++) {
+        spectrum.process(&first[frame * FFT_SIZE], 0);
+        reused.process(spectrum.bandLevels(), SPECTRUM_BANDS);
+    }
+    reused.reset();
+    for (int frame = 0; frame < frames; frame++) {
+        spectrum.process(&second[frame * FFT_SIZE], 0);
+        uint8_t expected = fresh.process(spectrum.bandLevels(), SPECTRUM_BANDS);
+        TEST_ASSERT_EQUAL_UINT8(expected, reused.process(spectrum.bandLevels(), SPECTRUM_BANDS));
+    }
+    TEST_ASSERT_EQUAL_UINT16(fresh.bpm(), reused.bpm());
+}
+
+// 每帧耗时 (频谱分析 + 节拍检测)，要求远低于1毫秒
+void test_benchmark_us_per_frame(void) {
+    TrackResult result = analyze(clickTrack(128, 2000, 3000), 128);
+
+    char message[128];
+    snprintf(message, sizeof(message), "%d 帧: 平均 %.2f 微秒/帧, 最大 %.2f 微秒",
+             result.frames, result.totalUs / result.frames, result.maxFrameUs);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(result.totalUs / result.frames < 1000.0);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_click_tracks_quiet);
+    RUN_TEST(test_click_tracks_noisy_with_tone);
+    RUN_TEST(test_noise_only_yields_no_beats);
+    RUN_TEST(test_beats_stop_after_clicks_end);
+    RUN_TEST(test_reset_matches_fresh_detector);
+    RUN_TEST(test_benchmark_us_per_frame);
+    return UNITY_END();
+}
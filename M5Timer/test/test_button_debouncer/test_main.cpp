@@ -0,0 +1,168 @@
+#include <unity.h>
+#include "core/ButtonDebouncer.h"
+
+// 按下与松开时的抖动: 边沿间隔 (微秒)，电平交替
+static const uint32_t BOUNCE_GAPS[] = {300, 150, 800, 200, 1200, 400};
+static const int BOUNCE_COUNT = sizeof(BOUNCE_GAPS) / sizeof(BOUNCE_GAPS[0]);
+
+// 收集到的动作与对应时刻
+struct ActionLog {
+    ButtonAction actions[16];
+    uint32_t timesUs[16];
+    int count;
+};
+
+static ActionLog actionLog;
+
+static void record(ButtonDebouncer& debouncer, ButtonAction action) {
+    if (action == BUTTON_ACTION_NONE || actionLog.count >= 16) return;
+    actionLog.actions[actionLog.count] = action;
+    actionLog.timesUs[actionLog.count] = debouncer.eventTimeUs();
+    actionLog.count++;
+}
+
+// 在timeUs输入一个带抖动的边沿，最终稳定为pressed，返回最后一个边沿的时刻
+static uint32_t bouncyEdge(ButtonDebouncer& debouncer, bool pressed, uint32_t timeUs) {
+    bool level = pressed;
+    record(debouncer, debouncer.onEdge(level, timeUs));
+    for (int i = 0; i < BOUNCE_COUNT; i++) {
+        level = !level;
+        timeUs += BOUNCE_GAPS[i];
+        record(debouncer, debouncer.onEdge(level, timeUs));
+    }
+    // 抖动次数为偶数，最后一个边沿回到目标电平
+    return timeUs;
+}
+
+// 按输入任务的方式以1ms间隔轮询到untilUs，rawPressed为实际电平
+static void pollUntil(ButtonDebouncer& debouncer, uint32_t fromUs, uint32_t untilUs, bool rawPressed) {
+    for (uint32_t t = fromUs; (int32_t)(untilUs - t) >= 0; t += 1000) {
+        ButtonAction action;
+        while ((action = debouncer.poll(t, rawPressed)) != BUTTON_ACTION_NONE) {
+            record(debouncer, action);
+        }
+    }
+}
+
+void setUp(void) {
+    actionLog.count = 0;
+}
+
+void tearDown(void) {}
+
+// 抖动只产生一次按下，锁定结束时电平一致不再产生动作
+void test_bounce_yields_single_press(void) {
+    ButtonDebouncer debouncer;
+    uint32_t lastEdgeUs = bouncyEdge(debouncer, true, 5000);
+    pollUntil(debouncer, lastEdgeUs, 5000 + BUTTON_LOCKOUT_US + 5000, true);
+
+    TEST_ASSERT_EQUAL_INT(1, actionLog.count);
+    TEST_ASSERT_EQUAL_INT(BUTTON_ACTION_PRESS, actionLog.actions[0]);
+    TEST_ASSERT_EQUAL_UINT32(5000, actionLog.timesUs[0]);
+    TEST_ASSERT_TRUE(debouncer.isPressed());
+}
+
+// 锁定期内松开: 锁定结束时与实际电平对齐，时刻取最后一个边沿
+void test_release_during_lockout_is_aligned(void) {
+    ButtonDebouncer debouncer;
+    record(debouncer, debouncer.onEdge(true, 1000));
+    record(debouncer, debouncer.onEdge(false, 9000));
+    pollUntil(debouncer, 10000, 1000 + BUTTON_LOCKOUT_US + 1000, false);
+
+    TEST_ASSERT_EQUAL_INT(2, actionLog.count);
+    TEST_ASSERT_EQUAL_INT(BUTTON_ACTION_PRESS, actionLog.actions[0]);
+    TEST_ASSERT_EQUAL_INT(BUTTON_ACTION_SHORT, actionLog.actions[1]);
+    TEST_ASSERT_EQUAL_UINT32(9000, actionLog.timesUs[1]);
+    TEST_ASSERT_FALSE(debouncer.isPressed());
+}
+
+// 短按: 按下与松开各带抖动，得到按下 + 短按，时刻为首个边沿
+void test_short_press(void) {
+    ButtonDebouncer debouncer;
+    uint32_t t = bouncyEdge(debouncer, true, 10000);
+    pollUntil(debouncer, t, 150000, true);
+    t = bouncyEdge(debouncer, false, 150000);
+    pollUntil(debouncer, t, 250000, false);
+
+    TEST_ASSERT_EQUAL_INT(2, actionLog.count);
+    TEST_ASSERT_EQUAL_INT(BUTTON_ACTION_PRESS, actionLog.actions[0]);
+    TEST_ASSERT_EQUAL_INT(BUTTON_ACTION_SHORT, actionLog.actions[1]);
+    TEST_ASSERT_EQUAL_UINT32(10000, actionLog.timesUs[0]);
+    TEST_ASSERT_EQUAL_UINT32(150000, actionLog.timesUs[1]);
+}
+
+// 长按: 按住达到阈值时立即触发，时刻为按下 + 阈值，松开时只产生释放
+void test_long_press(void) {
+    ButtonDebouncer debouncer;
+    uint32_t t = bouncyEdge(debouncer, true, 20000);
+    TEST_ASSERT_EQUAL_UINT32(BUTTON_LOCKOUT_US - (t - 20000), debouncer.nextDeadlineUs(t));
+    pollUntil(debouncer, t, 1500000, true);
+
+    TEST_ASSERT_EQUAL_INT(2, actionLog.count);
+    TEST_ASSERT_EQUAL_INT(BUTTON_ACTION_LONG, actionLog.actions[1]);
+    TEST_ASSERT_EQUAL_UINT32(20000 + BUTTON_LONG_PRESS_US, actionLog.timesUs[1]);
+    TEST_ASSERT_EQUAL_UINT32(BUTTON_NO_DEADLINE, debouncer.nextDeadlineUs(1500000));
+
+    t = bouncyEdge(debouncer, false, 1600000);
+    pollUntil(debouncer, t, 1700000, false);
+
+    TEST_ASSERT_EQUAL_INT(3, actionLog.count);
+    TEST_ASSERT_EQUAL_INT(BUTTON_ACTION_RELEASE, actionLog.actions[2]);
+    TEST_ASSERT_EQUAL_UINT32(1600000, actionLog.timesUs[2]);
+}
+
+// 错过长按时刻 (没有轮询) 时，松开按长按处理
+void test_long_press_without_poll(void) {
+    ButtonDebouncer debouncer;
+    record(debouncer, debouncer.onEdge(true, 0));
+    record(debouncer, debouncer.onEdge(false, 1200000));
+
+    TEST_ASSERT_EQUAL_INT(2, actionLog.count);
+    TEST_ASSERT_EQUAL_INT(BUTTON_ACTION_LONG, actionLog.actions[1]);
+}
+
+// 双击: 松开60ms后再次按下，两次都被识别
+void test_double_press(void) {
+    ButtonDebouncer debouncer;
+    uint32_t t = 0;
+    for (int i = 0; i < 2; i++) {
+        uint32_t pressUs = i * 120000;
+        t = bouncyEdge(debouncer, true, pressUs);
+        pollUntil(debouncer, t, pressUs + 60000, true);
+        t = bouncyEdge(debouncer, false, pressUs + 60000);
+        pollUntil(debouncer, t, pressUs + 60000 + BUTTON_LOCKOUT_US + 1000, false);
+    }
+
+    TEST_ASSERT_EQUAL_INT(4, actionLog.count);
+    TEST_ASSERT_EQUAL_INT(BUTTON_ACTION_PRESS, actionLog.actions[0]);
+    TEST_ASSERT_EQUAL_INT(BUTTON_ACTION_SHORT, actionLog.actions[1]);
+    TEST_ASSERT_EQUAL_INT(BUTTON_ACTION_PRESS, actionLog.actions[2]);
+    TEST_ASSERT_EQUAL_INT(BUTTON_ACTION_SHORT, actionLog.actions[3]);
+    TEST_ASSERT_EQUAL_UINT32(120000, actionLog.timesUs[2]);
+    TEST_ASSERT_EQUAL_UINT32(180000, actionLog.timesUs[3]);
+}
+
+// 时间戳在32位回绕时锁定与长按仍然正确
+void test_timestamp_wraparound(void) {
+    ButtonDebouncer debouncer;
+    uint32_t pressUs = 0xFFFFFFFFu - 500000;
+    uint32_t t = bouncyEdge(debouncer, true, pressUs);
+    pollUntil(debouncer, t, pressUs + 1200000, true);
+
+    TEST_ASSERT_EQUAL_INT(2, actionLog.count);
+    TEST_ASSERT_EQUAL_INT(BUTTON_ACTION_PRESS, actionLog.actions[0]);
+    TEST_ASSERT_EQUAL_INT(BUTTON_ACTION_LONG, actionLog.actions[1]);
+    TEST_ASSERT_EQUAL_UINT32(pressUs + BUTTON_LONG_PRESS_US, actionLog.timesUs[1]);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_bounce_yields_single_press);
+    RUN_TEST(test_release_during_lockout_is_aligned);
+    RUN_TEST(test_short_press);
+    RUN_TEST(test_long_press);
+    RUN_TEST(test_long_press_without_poll);
+    RUN_TEST(test_double_press);
+    RUN_TEST(test_timestamp_wraparound);
+    return UNITY_END();
+}
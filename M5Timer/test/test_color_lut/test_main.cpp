@@ -0,0 +1,98 @@
+#include <unity.h>
+#include <string.h>
+#include "core/ColorLut.h"
+
+// 可重复的伪随机数
+static uint32_t randomSeed;
+
+static uint32_t nextRandom() {
+    randomSeed = randomSeed * 1103515245u + 12345u;
+    return randomSeed >> 8;
+}
+
+// 每个亮度对应的查找表 (由新构造的查找表得到)
+static uint8_t reference[256][256];
+
+// 按WS2812Output的方式把一帧逐通道查表编码
+static void encodeFrame(const uint32_t* colors, int count, const uint8_t* lut, uint8_t* out) {
+    for (int i = 0; i < count; i++) {
+        out[i * 3 + 0] = lut[(colors[i] >> 8) & 0xFF];   // G
+        out[i * 3 + 1] = lut[(colors[i] >> 16) & 0xFF];  // R
+        out[i * 3 + 2] = lut[colors[i] & 0xFF];          // B
+    }
+}
+
+void setUp(void) {
+    randomSeed = 99;
+    for (int b = 0; b < 256; b++) {
+        ColorLut lut(LED_GAMMA, (uint8_t)b);
+        memcpy(reference[b], lut.table(), 256);
+    }
+}
+
+void tearDown(void) {}
+
+// 调暗再恢复: 查找表与编码输出和调暗前逐字节一致
+void test_brightness_down_up_round_trip_is_bit_exact(void) {
+    uint32_t colors[64];
+    for (int i = 0; i < 64; i++) colors[i] = nextRandom() & 0xFFFFFF;
+
+    for (int from = 0; from < 256; from++) {
+        ColorLut lut(LED_GAMMA, (uint8_t)from);
+        uint8_t before[64 * 3];
+        encodeFrame(colors, 64, lut.table(), before);
+
+        for (int to = 0; to < 256; to += 5) {
+            lut.setBrightness((uint8_t)to);
+            lut.setBrightness((uint8_t)from);
+
+            uint8_t after[64 * 3];
+            encodeFrame(colors, 64, lut.table(), after);
+            TEST_ASSERT_EQUAL_MEMORY(before, after, sizeof(before));
+            TEST_ASSERT_EQUAL_UINT8(from, lut.brightness());
+        }
+    }
+}
+
+// 任意顺序多次切换后，查找表只取决于当前亮度
+void test_table_depends_only_on_current_brightness(void) {
+    ColorLut lut;
+    for (int step = 0; step < 10000; step++) {
+        uint8_t brightness = nextRandom() & 0xFF;
+        lut.setBrightness(brightness);
+        TEST_ASSERT_EQUAL_MEMORY(reference[brightness], lut.table(), 256);
+    }
+}
+
+// 满亮度为纯伽马表，0亮度全黑，每张表单调不减
+void test_table_endpoints_and_monotonic(void) {
+    for (int i = 0; i < 256; i++) {
+        TEST_ASSERT_EQUAL_UINT8(0, reference[0][i]);
+    }
+    TEST_ASSERT_EQUAL_UINT8(0, reference[255][0]);
+    TEST_ASSERT_EQUAL_UINT8(255, reference[255][255]);
+
+    for (int b = 0; b < 256; b++) {
+        for (int i = 1; i < 256; i++) {
+            TEST_ASSERT_TRUE(reference[b][i] >= reference[b][i - 1]);
+        }
+    }
+}
+
+// 切换亮度时旧表保持不变 (输出任务可能仍在读取)
+void test_previous_table_untouched_by_switch(void) {
+    ColorLut lut(LED_GAMMA, 200);
+    const uint8_t* old = lut.table();
+    lut.setBrightness(40);
+    TEST_ASSERT_TRUE(old != lut.table());
+    TEST_ASSERT_EQUAL_MEMORY(reference[200], old, 256);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_brightness_down_up_round_trip_is_bit_exact);
+    RUN_TEST(test_table_depends_only_on_current_brightness);
+    RUN_TEST(test_table_endpoints_and_monotonic);
+    RUN_TEST(test_previous_table_untouched_by_switch);
+    return UNITY_END();
+}
@@ -0,0 +1,213 @@
+#include <unity.h>
+#include <string.h>
+#include "core/CueScheduler.h"
+
+// 选曲命令的发送延迟 (与JQ8900Player::trackLatencyUs()同一量级)
+#define TEST_LATENCY_US 1150000
+
+// 每个提示必须落在目标时刻1ms以内
+#define CUE_TOLERANCE_US 1000
+
+// 虚拟时钟: 按布置的唤醒时刻推进时间，唤醒时加入可重复的调度抖动
+class VirtualClock : public CueClock {
+public:
+    VirtualClock() : callback(NULL), arg(NULL), now(0), wakeAt(-1), jitterSeed(1) {}
+
+    bool attach(CueClockCallback cb, void* a) override {
+        callback = cb;
+        arg = a;
+        return true;
+    }
+    int64_t nowUs() override { return now; }
+    void startOnce(uint64_t delayUs) override { wakeAt = now + (int64_t)delayUs + jitter(); }
+    void stop() override { wakeAt = -1; }
+    void lock() override {}
+    void unlock() override {}
+
+    // 推进到targetUs，途中到期的唤醒依次触发，每次触发后调用onWake
+    template <typename F>
+    void advanceTo(int64_t targetUs, F onWake) {
+        while (wakeAt >= 0 && wakeAt <= targetUs) {
+            now = wakeAt;
+            wakeAt = -1;
+            callback(arg);
+            onWake(now);
+        }
+        now = targetUs;
+    }
+
+    CueClockCallback callback;
+    void* arg;
+    int64_t now;
+    int64_t wakeAt;
+
+private:
+    // 0-300us的定时器回调延迟
+    int64_t jitter() {
+        jitterSeed = jitterSeed * 1103515245u + 12345u;
+        return (jitterSeed >> 16) % 300;
+    }
+    uint32_t jitterSeed;
+};
+
+// 与内置60秒配置相同的提示表
+static const Cue TABLE[] = {
+    {0,     0, CUE_LED_DIM,     2000},
+    {24000, 3, CUE_LED_DIM,     2000},
+    {34000, 3, CUE_LED_DIM,     2000},
+    {59000, 4, CUE_LED_RESTORE, 0}
+};
+static const size_t TABLE_COUNT = sizeof(TABLE) / sizeof(TABLE[0]);
+
+// 记录每次音频提示与LED动作的时刻
+struct FireLog {
+    int64_t timesUs[16];
+    uint16_t values[16];
+    size_t count;
+};
+
+static VirtualClock* virtualClock;
+static FireLog audioLog;
+static FireLog ledLog;
+
+static void record(FireLog& log, int64_t timeUs, uint16_t value) {
+    if (log.count < 16) {
+        log.timesUs[log.count] = timeUs;
+        log.values[log.count] = value;
+        log.count++;
+    }
+}
+
+static void onAudio(uint16_t track) {
+    record(audioLog, virtualClock->nowUs(), track);
+}
+
+// 模式任务在唤醒后取出挂起的LED动作
+static void takeLed(CueScheduler& scheduler, int64_t nowUs) {
+    CueLedAction action;
+    uint16_t durationMs;
+    if (scheduler.takeLedAction(&action, &durationMs)) {
+        record(ledLog, nowUs, (uint16_t)action);
+    }
+}
+
+static void expectFiredAt(const FireLog& log, size_t index, int64_t expectedUs) {
+    TEST_ASSERT_TRUE(index < log.count);
+    TEST_ASSERT_INT64_WITHIN(CUE_TOLERANCE_US, expectedUs, log.timesUs[index]);
+    TEST_ASSERT_GREATER_OR_EQUAL(expectedUs, log.timesUs[index]);  // 不提前触发
+}
+
+void setUp(void) {
+    virtualClock = new VirtualClock();
+    memset(&audioLog, 0, sizeof(audioLog));
+    memset(&ledLog, 0, sizeof(ledLog));
+}
+
+void tearDown(void) {
+    delete virtualClock;
+}
+
+static void test_each_cue_fires_within_1ms(void) {
+    CueScheduler scheduler(*virtualClock);
+    scheduler.setTable(TABLE, TABLE_COUNT);
+    scheduler.setAudioLatencyUs(TEST_LATENCY_US);
+    scheduler.setAudioHandler(onAudio);
+
+    // 计时在5秒时开始，提示音需要提前发送
+    const int64_t anchorUs = 5000000;
+    virtualClock->now = anchorUs;
+    scheduler.arm(anchorUs);
+    takeLed(scheduler, virtualClock->now);
+    virtualClock->advanceTo(anchorUs + 61000000, [&](int64_t nowUs) { takeLed(scheduler, nowUs); });
+
+    // 第一个提示没有音频，其余三个按延迟提前发出
+    TEST_ASSERT_EQUAL_UINT32(3, audioLog.count);
+    for (size_t i = 1; i < TABLE_COUNT; i++) {
+        TEST_ASSERT_EQUAL_UINT16(TABLE[i].track, audioLog.values[i - 1]);
+        expectFiredAt(audioLog, i - 1, anchorUs + (int64_t)TABLE[i].offsetMs * 1000 - TEST_LATENCY_US);
+    }
+
+    // LED动作在目标时刻挂起
+    TEST_ASSERT_EQUAL_UINT32(TABLE_COUNT, ledLog.count);
+    for (size_t i = 0; i < TABLE_COUNT; i++) {
+        TEST_ASSERT_EQUAL_UINT16(TABLE[i].ledAction, ledLog.values[i]);
+        expectFiredAt(ledLog, i, anchorUs + (int64_t)TABLE[i].offsetMs * 1000);
+    }
+    TEST_ASSERT_EQUAL_INT64(-1, virtualClock->wakeAt);
+}
+
+static void test_resume_shifts_remaining_cues_without_repeating(void) {
+    CueScheduler scheduler(*virtualClock);
+    scheduler.setTable(TABLE, TABLE_COUNT);
+    scheduler.setAudioLatencyUs(TEST_LATENCY_US);
+    scheduler.setAudioHandler(onAudio);
+    auto onWake = [&](int64_t nowUs) { takeLed(scheduler, nowUs); };
+
+    scheduler.arm(0);
+    takeLed(scheduler, virtualClock->now);
+
+    // 计时到30秒时暂停10秒
+    virtualClock->advanceTo(30000000, onWake);
+    scheduler.disarm();
+    TEST_ASSERT_EQUAL_UINT32(1, audioLog.count);
+    TEST_ASSERT_EQUAL_UINT32(2, ledLog.count);
+    virtualClock->advanceTo(40000000, onWake);
+    TEST_ASSERT_EQUAL_UINT32(1, audioLog.count);
+
+    // 以扣除暂停后的新基准继续
+    const int64_t anchorUs = 10000000;
+    scheduler.resume(anchorUs);
+    virtualClock->advanceTo(80000000, onWake);
+
+    TEST_ASSERT_EQUAL_UINT32(3, audioLog.count);
+    expectFiredAt(audioLog, 1, anchorUs + 34000000 - TEST_LATENCY_US);
+    expectFiredAt(audioLog, 2, anchorUs + 59000000 - TEST_LATENCY_US);
+    TEST_ASSERT_EQUAL_UINT32(4, ledLog.count);
+    expectFiredAt(ledLog, 2, anchorUs + 34000000);
+    expectFiredAt(ledLog, 3, anchorUs + 59000000);
+}
+
+static void test_overdue_cues_fire_immediately_on_arm(void) {
+    CueScheduler scheduler(*virtualClock);
+    scheduler.setTable(TABLE, TABLE_COUNT);
+    scheduler.setAudioLatencyUs(TEST_LATENCY_US);
+    scheduler.setAudioHandler(onAudio);
+
+    // 基准在25秒前: 前两个提示已到期，布置时立即触发
+    virtualClock->now = 25000000;
+    scheduler.arm(0);
+    TEST_ASSERT_EQUAL_UINT32(1, audioLog.count);
+    TEST_ASSERT_EQUAL_INT64(25000000, audioLog.timesUs[0]);
+
+    // 后到的LED动作覆盖先到的，只挂起一个
+    takeLed(scheduler, virtualClock->now);
+    TEST_ASSERT_EQUAL_UINT32(1, ledLog.count);
+    CueLedAction action;
+    uint16_t durationMs;
+    TEST_ASSERT_FALSE(scheduler.takeLedAction(&action, &durationMs));
+
+    // 下一次唤醒对准第三个提示的音频发送时刻
+    TEST_ASSERT_INT64_WITHIN(CUE_TOLERANCE_US, 34000000 - TEST_LATENCY_US, virtualClock->wakeAt);
+}
+
+static void test_disarm_cancels_pending_wake(void) {
+    CueScheduler scheduler(*virtualClock);
+    scheduler.setTable(TABLE, TABLE_COUNT);
+    scheduler.setAudioHandler(onAudio);
+    scheduler.arm(0);
+    scheduler.disarm();
+    TEST_ASSERT_FALSE(scheduler.isArmed());
+    TEST_ASSERT_EQUAL_INT64(-1, virtualClock->wakeAt);
+
+    virtualClock->advanceTo(70000000, [](int64_t) {});
+    TEST_ASSERT_EQUAL_UINT32(0, audioLog.count);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_each_cue_fires_within_1ms);
+    RUN_TEST(test_resume_shifts_remaining_cues_without_repeating);
+    RUN_TEST(test_overdue_cues_fire_immediately_on_arm);
+    RUN_TEST(test_disarm_cancels_pending_wake);
+    return UNITY_END();
+}
@@ -0,0 +1,254 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <deque>
+#include <vector>
+#include "core/ByteRing.h"
+#include "core/FrameParser.h"
+
+// 随机数据的字节数与基准测试的重复次数
+#define FUZZ_BYTES        200000
+#define BENCH_ROUNDS      2000
+
+// 足够让解析器从任意状态回到行首的换行数量 (大于最长的帧)
+#define RESYNC_NEWLINES   (FRAME_LENGTH + PACKET_MAX_LENGTH)
+
+// 可重复的伪随机数
+static uint32_t randomSeed;
+
+static uint32_t nextRandom() {
+    randomSeed = randomSeed * 1103515245u + 12345u;
+    return randomSeed >> 8;
+}
+
+// 编码一个压缩帧
+static void appendPacket(std::vector<uint8_t>& out, uint8_t type, uint8_t sequence,
+                         const uint8_t* payload, uint8_t length) {
+    uint8_t checksum = type ^ sequence ^ length;
+    out.push_back(PACKET_HEADER);
+    out.push_back(type);
+    out.push_back(sequence);
+    out.push_back(length);
+    for (int i = 0; i < length; i++) {
+        out.push_back(payload[i]);
+        checksum ^= payload[i];
+    }
+    out.push_back(checksum);
+}
+
+// 编码一个0xAA二进制帧，校验和为帧头之后65字节的异或
+static void appendBinary(std::vector<uint8_t>& out, const uint8_t* pixels) {
+    uint8_t checksum = 0;
+    out.push_back(FRAME_HEADER);
+    for (int i = 0; i < FRAME_PIXELS; i++) {
+        out.push_back(pixels[i]);
+        checksum ^= pixels[i];
+    }
+    out.push_back(0);
+    out.push_back(checksum);
+}
+
+// 编码一行SCREEN文本帧
+static void appendText(std::vector<uint8_t>& out, const uint8_t* pixels) {
+    char line[8 + FRAME_PIXELS * 3 + 2];
+    int n = sprintf(line, "SCREEN:");
+    for (int i = 0; i < FRAME_PIXELS; i++) {
+        n += sprintf(line + n, i == 0 ? "%d" : ",%d", pixels[i]);
+    }
+    line[n++] = '\n';
+    out.insert(out.end(), line, line + n);
+}
+
+// 编码一个完整的压缩帧 (每字节两个像素)
+static void appendPacked(std::vector<uint8_t>& out, uint8_t sequence, const uint8_t* pixels) {
+    uint8_t payload[FRAME_PIXELS / 2];
+    for (int i = 0; i < FRAME_PIXELS / 2; i++) {
+        payload[i] = (pixels[i * 2] << 4) | pixels[i * 2 + 1];
+    }
+    appendPacket(out, PACKET_PACKED, sequence, payload, sizeof(payload));
+}
+
+static void randomPixels(uint8_t* pixels) {
+    for (int i = 0; i < FRAME_PIXELS; i++) {
+        pixels[i] = nextRandom() & 0x0F;
+    }
+}
+
+// 通过环形缓冲区按随机分块送入解析器，返回收到的像素帧数
+static uint32_t feed(ByteRing& ring, FrameParser& parser, const std::vector<uint8_t>& data,
+                     FrameParseResult* last = NULL) {
+    uint8_t chunk[256];
+    uint32_t frames = 0;
+    size_t offset = 0;
+    while (offset < data.size()) {
+        size_t length = 1 + nextRandom() % 200;
+        if (length > data.size() - offset) length = data.size() - offset;
+        offset += ring.write(&data[offset], length);
+
+        size_t count;
+        while ((count = ring.read(chunk, 1 + nextRandom() % sizeof(chunk))) > 0) {
+            for (size_t i = 0; i < count; i++) {
+                FrameParseResult result = parser.push(chunk[i]);
+                if (result == FRAME_PARSE_PIXELS) frames++;
+                if (result != FRAME_PARSE_NONE && last != NULL) *last = result;
+            }
+        }
+    }
+    return frames;
+}
+
+void setUp(void) {
+    randomSeed = 12345;
+}
+
+void tearDown(void) {}
+
+// 环形缓冲区: 随机长度的读写与参考队列一致，满时丢弃的字节数准确
+void test_ring_matches_reference_queue(void) {
+    ByteRing ring;
+    std::deque<uint8_t> reference;
+    uint32_t dropped = 0;
+    uint8_t buffer[BYTE_RING_SIZE + 512];
+
+    for (int round = 0; round < 20000; round++) {
+        size_t length = nextRandom() % sizeof(buffer);
+        for (size_t i = 0; i < length; i++) buffer[i] = nextRandom();
+
+        size_t space = BYTE_RING_SIZE - reference.size();
+        size_t written = ring.write(buffer, length);
+        TEST_ASSERT_EQUAL_UINT32(length < space ? length : space, written);
+        reference.insert(reference.end(), buffer, buffer + written);
+        dropped += length - written;
+        TEST_ASSERT_EQUAL_UINT32(reference.size(), ring.available());
+
+        size_t count = ring.read(buffer, nextRandom() % sizeof(buffer));
+        for (size_t i = 0; i < count; i++) {
+            TEST_ASSERT_EQUAL_UINT8(reference.front(), buffer[i]);
+            reference.pop_front();
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(dropped, ring.dropped());
+
+    ring.clear();
+    TEST_ASSERT_EQUAL_UINT32(0, ring.available());
+}
+
+// 随机字节: 解析器不越界，像素始终在0-15，换行后能正确解析下一帧
+void test_fuzz_random_bytes_then_recover(void) {
+    ByteRing ring;
+    FrameParser parser;
+    uint8_t expected[FRAME_PIXELS];
+
+    for (int round = 0; round < 20; round++) {
+        std::vector<uint8_t> data;
+        for (int i = 0; i < FUZZ_BYTES / 20; i++) {
+            // 提高帧头与文本前缀字符的出现概率，覆盖更多解析状态
+            uint32_t r = nextRandom();
+            switch (r % 8) {
+                case 0: data.push_back(FRAME_HEADER); break;
+                case 1: data.push_back(PACKET_HEADER); break;
+                case 2: data.push_back("SCREN:T,\n0123456789"[r % 19]); break;
+                default: data.push_back(r >> 8); break;
+            }
+        }
+        feed(ring, parser, data);
+        for (int i = 0; i < FRAME_PIXELS; i++) {
+            TEST_ASSERT_TRUE(parser.pixels()[i] < 16);
+        }
+
+        // 换行使解析器回到行首 (未完成的文本帧或二进制帧可能在此结束)，
+        // 随后的完整帧必须被正确解析
+        data.assign(RESYNC_NEWLINES, '\n');
+        feed(ring, parser, data);
+
+        data.clear();
+        randomPixels(expected);
+        switch (round % 3) {
+            case 0: appendBinary(data, expected); break;
+            case 1: appendText(data, expected); break;
+            default: appendPacked(data, round, expected); break;
+        }
+        FrameParseResult last = FRAME_PARSE_NONE;
+        TEST_ASSERT_EQUAL_UINT32(1, feed(ring, parser, data, &last));
+        TEST_ASSERT_EQUAL_INT(FRAME_PARSE_PIXELS, last);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, parser.pixels(), FRAME_PIXELS);
+    }
+}
+
+// 压缩帧中任意一个负载或校验字节出错都不会被当作像素帧，画面保持不变
+void test_fuzz_corrupted_packets_are_rejected(void) {
+    ByteRing ring;
+    FrameParser parser;
+    uint8_t pixels[FRAME_PIXELS];
+    randomPixels(pixels);
+
+    std::vector<uint8_t> good;
+    appendPacked(good, 1, pixels);
+    TEST_ASSERT_EQUAL_UINT32(1, feed(ring, parser, good));
+
+    uint8_t shown[FRAME_PIXELS];
+    memcpy(shown, parser.pixels(), sizeof(shown));
+    uint32_t errors = parser.checksumErrors();
+
+    for (int round = 0; round < 2000; round++) {
+        uint8_t next[FRAME_PIXELS];
+        randomPixels(next);
+        std::vector<uint8_t> data;
+        appendPacked(data, 2, next);
+
+        // 只破坏长度之后的字节，帧边界不变
+        size_t position = 4 + nextRandom() % (data.size() - 4);
+        data[position] ^= 1 + nextRandom() % 255;
+
+        TEST_ASSERT_EQUAL_UINT32(0, feed(ring, parser, data));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(shown, parser.pixels(), FRAME_PIXELS);
+        TEST_ASSERT_FALSE(parser.hasSequence());
+    }
+    TEST_ASSERT_EQUAL_UINT32(errors + 2000, parser.checksumErrors());
+}
+
+// 吞吐量基准: 四种帧格式混合，经环形缓冲区送入解析器
+void test_benchmark_frames_per_second(void) {
+    std::vector<uint8_t> stream;
+    uint8_t pixels[FRAME_PIXELS];
+    uint32_t framesPerRound = 0;
+    for (int i = 0; i < 8; i++) {
+        randomPixels(pixels);
+        appendBinary(stream, pixels);
+        appendText(stream, pixels);
+        appendPacked(stream, i * 2, pixels);
+
+        // 只改变两个像素的差分帧
+        uint8_t delta[] = {(uint8_t)(i * 2), 2, (uint8_t)i, (uint8_t)(63 - i), 0x5A};
+        appendPacket(stream, PACKET_DELTA, i * 2 + 1, delta, sizeof(delta));
+        framesPerRound += 4;
+    }
+
+    ByteRing ring;
+    FrameParser parser;
+    uint32_t frames = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        frames += feed(ring, parser, stream);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    TEST_ASSERT_EQUAL_UINT32(framesPerRound * BENCH_ROUNDS, frames);
+    TEST_ASSERT_EQUAL_UINT32(0, parser.checksumErrors());
+
+    char message[128];
+    snprintf(message, sizeof(message), "%u 帧 (%.1f MB) 用时 %.3f 秒: %.0f 帧/秒, %.1f MB/秒",
+             (unsigned)frames, stream.size() * BENCH_ROUNDS / 1e6, seconds,
+             frames / seconds, stream.size() * BENCH_ROUNDS / 1e6 / seconds);
+    TEST_MESSAGE(message);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_ring_matches_reference_queue);
+    RUN_TEST(test_fuzz_random_bytes_then_recover);
+    RUN_TEST(test_fuzz_corrupted_packets_are_rejected);
+    RUN_TEST(test_benchmark_frames_per_second);
+    return UNITY_END();
+}
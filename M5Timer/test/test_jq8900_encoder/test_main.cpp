@@ -0,0 +1,141 @@
+#include <unity.h>
+#include "core/JQ8900Encoder.h"
+
+// 一个字节的电平段: 开始信号、引导码、8位 (每位高低各一段)、结束信号
+#define PHASES_PER_BYTE (2 + 8 * 2 + 1)
+
+static JQ8900Encoder encoder;
+
+void setUp(void) {
+    encoder.reset();
+}
+
+void tearDown(void) {
+}
+
+// 从分段中解码一个字节，同时检查每一位的高低电平时长
+static uint8_t decodeSegment(size_t segment) {
+    const JQ8900Phase* phases = encoder.phases() + encoder.segmentStart(segment);
+    TEST_ASSERT_EQUAL_UINT8(1, phases[0].level);
+    TEST_ASSERT_EQUAL_UINT16(JQ8900_START_US, phases[0].durationUs);
+    TEST_ASSERT_EQUAL_UINT8(0, phases[1].level);
+    TEST_ASSERT_EQUAL_UINT16(JQ8900_LEAD_US, phases[1].durationUs);
+
+    uint8_t data = 0;
+    for (int bit = 0; bit < 8; bit++) {
+        const JQ8900Phase& high = phases[2 + bit * 2];
+        const JQ8900Phase& low = phases[3 + bit * 2];
+        TEST_ASSERT_EQUAL_UINT8(1, high.level);
+        TEST_ASSERT_EQUAL_UINT8(0, low.level);
+
+        // 数据1 高:低 = 3:1，数据0 高:低 = 1:3，每位总长固定
+        TEST_ASSERT_EQUAL_UINT32(JQ8900_BIT_SHORT_US + JQ8900_BIT_LONG_US, high.durationUs + low.durationUs);
+        if (high.durationUs > low.durationUs) {
+            TEST_ASSERT_EQUAL_UINT16(3 * low.durationUs, high.durationUs);
+            data |= 1 << bit;  // 低位在前
+        } else {
+            TEST_ASSERT_EQUAL_UINT16(3 * high.durationUs, low.durationUs);
+        }
+    }
+    return data;
+}
+
+static void test_bit_timings_are_3_to_1_and_1_to_3(void) {
+    encoder.appendByte(0x01);
+    TEST_ASSERT_EQUAL_UINT32(1, encoder.segmentCount());
+    TEST_ASSERT_EQUAL_UINT32(PHASES_PER_BYTE, encoder.count());
+
+    // 第0位为1，其余为0
+    const JQ8900Phase* phases = encoder.phases();
+    TEST_ASSERT_EQUAL_UINT16(JQ8900_BIT_LONG_US, phases[2].durationUs);
+    TEST_ASSERT_EQUAL_UINT16(JQ8900_BIT_SHORT_US, phases[3].durationUs);
+    TEST_ASSERT_EQUAL_UINT16(JQ8900_BIT_SHORT_US, phases[4].durationUs);
+    TEST_ASSERT_EQUAL_UINT16(JQ8900_BIT_LONG_US, phases[5].durationUs);
+
+    // 结束信号与最小字节间隔合并为一段高电平
+    TEST_ASSERT_EQUAL_UINT8(1, phases[PHASES_PER_BYTE - 1].level);
+    TEST_ASSERT_EQUAL_UINT16(JQ8900_END_US + JQ8900_BYTE_GAP_US, phases[PHASES_PER_BYTE - 1].durationUs);
+}
+
+static void test_every_byte_value_round_trips(void) {
+    for (int value = 0; value < 256; value++) {
+        encoder.reset();
+        encoder.appendByte((uint8_t)value);
+        TEST_ASSERT_EQUAL_UINT8(value, decodeSegment(0));
+    }
+}
+
+static void test_byte_duration_matches_encoded_phases(void) {
+    encoder.appendByte(0xA5, 0);
+    uint32_t total = 0;
+    for (size_t i = 0; i < encoder.count(); i++) {
+        total += encoder.phases()[i].durationUs;
+    }
+    TEST_ASSERT_EQUAL_UINT32(JQ8900Encoder::byteDurationUs(0), total);
+    TEST_ASSERT_EQUAL_UINT32(total, encoder.totalDurationUs());
+}
+
+static void test_long_gap_gets_its_own_segment(void) {
+    // 选曲播放序列: 停止 (长间隔) + 清空 + 4位曲目号 + 选曲播放 (命令间隔)
+    const uint8_t bytes[] = {0x13, 0x0A, 0, 0, 1, 2, 0x0B};
+    encoder.appendByte(bytes[0], 80000);
+    for (int i = 1; i < 6; i++) {
+        encoder.appendByte(bytes[i]);
+    }
+    encoder.appendByte(bytes[6], JQ8900_CMD_GAP_US);
+    TEST_ASSERT_FALSE(encoder.overflowed());
+
+    // 每个字节一段，两个超过最小间隔的间隔各一段
+    TEST_ASSERT_EQUAL_UINT32(9, encoder.segmentCount());
+    TEST_ASSERT_EQUAL_UINT32(7, encoder.lastByteSegment());
+    TEST_ASSERT_EQUAL_UINT8(0x13, decodeSegment(0));
+    TEST_ASSERT_EQUAL_UINT8(0x0A, decodeSegment(2));
+    TEST_ASSERT_EQUAL_UINT8(0x0B, decodeSegment(7));
+
+    // 间隔段只有高电平，超长部分按RMT时长上限拆分
+    uint32_t idle = 0;
+    const JQ8900Phase* phases = encoder.phases() + encoder.segmentStart(1);
+    for (size_t i = 0; i < encoder.segmentLength(1); i++) {
+        TEST_ASSERT_EQUAL_UINT8(1, phases[i].level);
+        TEST_ASSERT_LESS_OR_EQUAL(JQ8900_MAX_PHASE_US, phases[i].durationUs);
+        idle += phases[i].durationUs;
+    }
+    TEST_ASSERT_EQUAL_UINT32(80000 - JQ8900_BYTE_GAP_US, idle);
+}
+
+// 选曲播放字节所在分段发完的时刻减去段内间隔，与不含最后命令间隔的序列时长一致
+// (JQ8900Player::trackLatencyUs()按同样的方式计算)
+static void test_last_byte_end_excludes_trailing_gap(void) {
+    encoder.appendByte(0x13, 80000);
+    for (int i = 0; i < 5; i++) {
+        encoder.appendByte(0x0A);
+    }
+    encoder.appendByte(0x0B, JQ8900_CMD_GAP_US);
+
+    uint32_t throughLastByte = 0;
+    for (size_t segment = 0; segment <= encoder.lastByteSegment(); segment++) {
+        const JQ8900Phase* phases = encoder.phases() + encoder.segmentStart(segment);
+        for (size_t i = 0; i < encoder.segmentLength(segment); i++) {
+            throughLastByte += phases[i].durationUs;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(JQ8900_BYTE_GAP_US, encoder.lastByteGapUs());
+    TEST_ASSERT_EQUAL_UINT32(JQ8900Encoder::byteDurationUs(80000) + 5 * JQ8900Encoder::byteDurationUs() +
+                             JQ8900Encoder::byteDurationUs(0),
+                             throughLastByte - encoder.lastByteGapUs());
+
+    // 间隔小于最小字节间隔时全部留在本段
+    encoder.reset();
+    encoder.appendByte(0x11, 3000);
+    TEST_ASSERT_EQUAL_UINT32(3000, encoder.lastByteGapUs());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_bit_timings_are_3_to_1_and_1_to_3);
+    RUN_TEST(test_every_byte_value_round_trips);
+    RUN_TEST(test_byte_duration_matches_encoded_phases);
+    RUN_TEST(test_long_gap_gets_its_own_segment);
+    RUN_TEST(test_last_byte_end_excludes_trailing_gap);
+    return UNITY_END();
+}
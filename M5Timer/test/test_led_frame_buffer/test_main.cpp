@@ -0,0 +1,225 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "core/LEDFrameBuffer.h"
+#include "core/Glyphs.h"
+
+// 基准测试: 60秒倒计时重复的次数
+#define BENCH_ROUNDS      50000
+
+// 修改前 (单缓冲) 的LEDMatrix刷新路径: setPixel与缓存比较并置位pixelChanged[64]，
+// update()扫描64个标记，对变化的像素调用Adafruit_NeoPixel::setPixelColor (按亮度缩放后写入GRB字节)
+class BaselineMatrix {
+public:
+    BaselineMatrix() {
+        memset(pixelCache, 0, sizeof(pixelCache));
+        memset(pixelChanged, 0, sizeof(pixelChanged));
+        memset(pixels, 0, sizeof(pixels));
+        brightness = 51 + 1;  // Adafruit_NeoPixel::setBrightness保存的是亮度+1
+    }
+
+    void clear() {
+        for (int i = 0; i < LED_FRAME_PIXELS; i++) {
+            if (pixelCache[i] != 0) {
+                pixelCache[i] = 0;
+                pixelChanged[i] = true;
+            }
+        }
+    }
+
+    void setPixel(int index, uint32_t color) {
+        if (pixelCache[index] != color) {
+            pixelCache[index] = color;
+            pixelChanged[index] = true;
+        }
+    }
+
+    // 返回是否需要发送 (strip.show())
+    bool update() {
+        bool hasChanges = false;
+        for (int i = 0; i < LED_FRAME_PIXELS; i++) {
+            if (pixelChanged[i]) {
+                hasChanges = true;
+                setPixelColor(i, pixelCache[i]);
+                pixelChanged[i] = false;
+            }
+        }
+        return hasChanges;
+    }
+
+    uint32_t pixelCache[LED_FRAME_PIXELS];
+    bool pixelChanged[LED_FRAME_PIXELS];
+    uint8_t pixels[LED_FRAME_PIXELS * 3];
+
+private:
+    // 与Adafruit_NeoPixel::setPixelColor(uint16_t, uint32_t)相同 (NEO_GRB)
+    void setPixelColor(int n, uint32_t c) {
+        uint8_t* p = &pixels[n * 3];
+        uint8_t r = (uint8_t)(c >> 16);
+        uint8_t g = (uint8_t)(c >> 8);
+        uint8_t b = (uint8_t)c;
+        if (brightness) {
+            r = (r * brightness) >> 8;
+            g = (g * brightness) >> 8;
+            b = (b * brightness) >> 8;
+        }
+        p[1] = r;
+        p[0] = g;
+        p[2] = b;
+    }
+
+    uint8_t brightness;
+};
+
+// 与LEDMatrix::present() + update()相同的调用顺序，返回是否需要发送
+static bool presentFrame(LEDFrameBuffer& frames) {
+    frames.commit();
+    uint32_t frame[LED_FRAME_PIXELS];
+    frames.copyFront(frame);
+    return frames.applyShown(frame);
+}
+
+// 两位数的点阵: 十位在左4列，个位在右4列，返回点亮像素的位图并写出颜色
+static uint64_t renderSeconds(int value, uint32_t tens, uint32_t ones, uint32_t* colors) {
+    uint64_t lit = 0;
+    for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 8; x++) {
+            const Glyph& glyph = x < 4 ? FONT_4X8[value / 10] : FONT_4X8[value % 10];
+            int column = x < 4 ? x : x - 4;
+            int i = y * 8 + x;
+            if (glyph.rows[y] & (0x80 >> column)) {
+                lit |= 1ULL << i;
+                colors[i] = x < 4 ? tens : ones;
+            } else {
+                colors[i] = 0;
+            }
+        }
+    }
+    return lit;
+}
+
+// 预先生成61个画面，基准测试只计入绘制、提交与刷新
+struct Countdown {
+    uint32_t colors[61][LED_FRAME_PIXELS];
+    uint64_t lit[61];
+    uint64_t written[61];   // 与LEDCompositor相同: 清空数字图层后重绘，写入新旧数字点亮像素的并集
+
+    Countdown() {
+        uint64_t previous = 0;
+        for (int value = 60; value >= 0; value--) {
+            lit[value] = renderSeconds(value, 0xFF0000, 0x00FF00, colors[value]);
+            written[value] = lit[value] | previous;
+            previous = lit[value];
+        }
+    }
+
+    // 写入某一秒的画面; redraw为true时像修改前的showTwoNumbers一样先clear()再只画点亮的像素
+    template <typename Buffer>
+    void draw(Buffer& buffer, int value, bool redraw) const {
+        uint64_t bits = written[value];
+        if (redraw) {
+            buffer.clear();
+            bits = lit[value];
+        }
+        while (bits) {
+            int i = __builtin_ctzll(bits);
+            bits &= bits - 1;
+            buffer.setPixel(i, colors[value][i]);
+        }
+    }
+};
+
+static Countdown countdown;
+
+// 运行60 -> 0倒计时BENCH_ROUNDS次，返回每帧 (绘制 + 提交 + 刷新) 的耗时 (纳秒) 与发送次数
+static double benchFrames(bool redraw, uint32_t* writes) {
+    LEDFrameBuffer frames;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        for (int value = 60; value >= 0; value--) {
+            countdown.draw(frames, value, redraw);
+            *writes += presentFrame(frames);
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds * 1e9 / ((double)BENCH_ROUNDS * 61);
+}
+
+static double benchBaseline(bool redraw, uint32_t* writes) {
+    BaselineMatrix matrix;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        for (int value = 60; value >= 0; value--) {
+            countdown.draw(matrix, value, redraw);
+            *writes += matrix.update();
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds * 1e9 / ((double)BENCH_ROUNDS * 61);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+// 两条路径对同一组绘制产生相同的显示内容与发送次数，画面不变时不发送
+void test_double_buffer_matches_baseline_path(void) {
+    LEDFrameBuffer frames;
+    BaselineMatrix baseline;
+    int frameWrites = 0;
+    int baselineWrites = 0;
+
+    for (int pass = 0; pass < 2; pass++) {
+        for (int value = 60; value >= 0; value--) {
+            countdown.draw(frames, value, pass == 1);
+            countdown.draw(baseline, value, pass == 1);
+            frameWrites += presentFrame(frames);
+            baselineWrites += baseline.update();
+            TEST_ASSERT_EQUAL_MEMORY(countdown.colors[value], frames.shown(), sizeof(countdown.colors[value]));
+            TEST_ASSERT_EQUAL_MEMORY(baseline.pixelCache, frames.shown(), sizeof(baseline.pixelCache));
+
+            // 同一秒内重复提交相同的画面不发送
+            countdown.draw(frames, value, false);
+            TEST_ASSERT_FALSE(presentFrame(frames));
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(122, baselineWrites);
+    TEST_ASSERT_EQUAL_INT(baselineWrites, frameWrites);
+
+    // clear()后重绘相同的内容不算变化 (修改前的路径会标记变化并重新发送)
+    frames.clear();
+    countdown.draw(frames, 0, false);
+    TEST_ASSERT_FALSE(presentFrame(frames));
+    baseline.clear();
+    countdown.draw(baseline, 0, false);
+    TEST_ASSERT_TRUE(baseline.update());
+}
+
+// 60 -> 0 倒计时: 比较修改前的单缓冲路径与当前双缓冲路径每帧 (绘制 + 提交 + 刷新) 的耗时
+// 按LEDCompositor的实际写法只写新旧数字的像素; 另外给出修改前showTwoNumbers的clear() + 重绘写法
+// 双缓冲多出整帧复制，这里只要求两条路径发送次数相同，耗时仅供参考
+void test_benchmark_countdown(void) {
+    uint32_t frameWrites = 0;
+    uint32_t baselineWrites = 0;
+
+    double baselineNs = benchBaseline(false, &baselineWrites);
+    double frameNs = benchFrames(false, &frameWrites);
+    double redrawBaselineNs = benchBaseline(true, &baselineWrites);
+    double redrawFrameNs = benchFrames(true, &frameWrites);
+
+    char message[256];
+    snprintf(message, sizeof(message),
+             "图层合成写入: 修改前 %.1f ns, 双缓冲 %.1f ns; clear()后重绘: 修改前 %.1f ns, 双缓冲 %.1f ns",
+             baselineNs, frameNs, redrawBaselineNs, redrawFrameNs);
+    TEST_MESSAGE(message);
+
+    TEST_ASSERT_EQUAL_UINT32(baselineWrites, frameWrites);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_double_buffer_matches_baseline_path);
+    RUN_TEST(test_benchmark_countdown);
+    return UNITY_END();
+}
@@ -0,0 +1,198 @@
+#include <unity.h>
+#include "core/MatchClock.h"
+
+// 任意的起始时刻 (esp_timer已运行较久，超出32位微秒范围)
+#define T0_US 5000000000LL
+
+// 可重复的伪随机数
+static uint32_t randomSeed;
+
+static uint32_t nextRandom() {
+    randomSeed = randomSeed * 1103515245u + 12345u;
+    return randomSeed >> 8;
+}
+
+void setUp(void) {
+    randomSeed = 7;
+}
+
+void tearDown(void) {}
+
+// 未开始时显示完整时长
+void test_idle_shows_full_duration(void) {
+    MatchClock clock(60000);
+    ClockSnapshot snap = clock.snapshot(T0_US);
+    TEST_ASSERT_EQUAL_INT32(60, snap.seconds);
+    TEST_ASSERT_EQUAL_INT32(0, snap.hundredths);
+    TEST_ASSERT_EQUAL_INT32(60, snap.ceilSeconds);
+    TEST_ASSERT_FALSE(snap.running);
+    TEST_ASSERT_FALSE(snap.finished);
+}
+
+// 每个整秒边界: 边界前1us、边界时刻、边界后1us的取整
+void test_rounding_at_every_second_boundary(void) {
+    MatchClock clock(60000);
+    clock.start(T0_US);
+
+    for (int k = 0; k <= 60; k++) {
+        int64_t boundaryUs = T0_US + (int64_t)k * 1000000;
+        int remaining = 60 - k;
+
+        if (k > 0) {
+            // 边界前1us: 还剩 remaining秒 + 1us，向上取整多一秒
+            ClockSnapshot before = clock.snapshot(boundaryUs - 1);
+            TEST_ASSERT_EQUAL_INT32(remaining, before.seconds);
+            TEST_ASSERT_EQUAL_INT32(0, before.hundredths);
+            TEST_ASSERT_EQUAL_INT32(remaining + 1, before.ceilSeconds);
+            TEST_ASSERT_FALSE(before.finished);
+        }
+
+        ClockSnapshot at = clock.snapshot(boundaryUs);
+        TEST_ASSERT_EQUAL_INT32(remaining, at.seconds);
+        TEST_ASSERT_EQUAL_INT32(0, at.hundredths);
+        TEST_ASSERT_EQUAL_INT32(remaining, at.ceilSeconds);
+        TEST_ASSERT_EQUAL_INT64((int64_t)remaining * 1000000, at.remainingUs);
+        TEST_ASSERT_EQUAL_INT(remaining == 0, at.finished);
+
+        if (k < 60) {
+            // 边界后1us: 向下取整少一秒，百分之一秒为99，向上取整不变
+            ClockSnapshot after = clock.snapshot(boundaryUs + 1);
+            TEST_ASSERT_EQUAL_INT32(remaining - 1, after.seconds);
+            TEST_ASSERT_EQUAL_INT32(99, after.hundredths);
+            TEST_ASSERT_EQUAL_INT32(remaining, after.ceilSeconds);
+        }
+
+        // 百分之一秒边界: 剩余 remaining秒 - 10ms 时为 (remaining-1).99
+        if (k < 60) {
+            ClockSnapshot hundredth = clock.snapshot(boundaryUs + 10000);
+            TEST_ASSERT_EQUAL_INT32(remaining - 1, hundredth.seconds);
+            TEST_ASSERT_EQUAL_INT32(99, hundredth.hundredths);
+            ClockSnapshot nextHundredth = clock.snapshot(boundaryUs + 10001);
+            TEST_ASSERT_EQUAL_INT32(98, nextHundredth.hundredths);
+        }
+    }
+
+    // 结束后保持为0，不出现负数
+    ClockSnapshot late = clock.snapshot(T0_US + 75000000);
+    TEST_ASSERT_EQUAL_INT64(0, late.remainingUs);
+    TEST_ASSERT_EQUAL_INT32(0, late.seconds);
+    TEST_ASSERT_EQUAL_INT32(0, late.hundredths);
+    TEST_ASSERT_EQUAL_INT32(0, late.ceilSeconds);
+    TEST_ASSERT_TRUE(late.finished);
+}
+
+// 显示的秒数单调不增，向上取整的秒数在每个边界恰好减一
+void test_ceil_seconds_step_once_per_second(void) {
+    MatchClock clock(60000);
+    clock.start(T0_US);
+
+    int last = 60;
+    int changes = 0;
+    for (int64_t t = T0_US; t <= T0_US + 60000000; t += 997) {
+        int ceilSeconds = clock.snapshot(t).ceilSeconds;
+        TEST_ASSERT_TRUE(ceilSeconds <= last && ceilSeconds >= last - 1);
+        if (ceilSeconds != last) changes++;
+        last = ceilSeconds;
+    }
+    TEST_ASSERT_EQUAL_INT(59, changes);  // 步长不整除60秒，最后一个采样点早于结束时刻，停在1
+    TEST_ASSERT_EQUAL_INT32(0, clock.snapshot(T0_US + 60000000).ceilSeconds);
+}
+
+// 暂停期间已计时时间不变，继续后扣除暂停时长
+void test_pause_resume_accounting(void) {
+    MatchClock clock(60000);
+    clock.start(T0_US);
+
+    clock.pause(T0_US + 10250000);
+    ClockSnapshot paused = clock.snapshot(T0_US + 40000000);
+    TEST_ASSERT_TRUE(paused.paused);
+    TEST_ASSERT_EQUAL_INT64(10250000, paused.elapsedUs);
+    TEST_ASSERT_EQUAL_INT32(49, paused.seconds);
+    TEST_ASSERT_EQUAL_INT32(75, paused.hundredths);
+    TEST_ASSERT_EQUAL_INT32(50, paused.ceilSeconds);
+
+    // 重复暂停不改变暂停时刻
+    clock.pause(T0_US + 20000000);
+    TEST_ASSERT_EQUAL_INT64(10250000, clock.snapshot(T0_US + 45000000).elapsedUs);
+
+    clock.resume(T0_US + 45000000);
+    TEST_ASSERT_EQUAL_INT64(T0_US + 34750000, clock.anchorUs());
+    TEST_ASSERT_EQUAL_INT64(10250000, clock.snapshot(T0_US + 45000000).elapsedUs);
+    TEST_ASSERT_EQUAL_INT64(11250000, clock.snapshot(T0_US + 46000000).elapsedUs);
+
+    // 重复继续不改变起点
+    clock.resume(T0_US + 47000000);
+    TEST_ASSERT_EQUAL_INT64(T0_US + 34750000, clock.anchorUs());
+
+    // 剩余时间在暂停时长之后结束
+    TEST_ASSERT_FALSE(clock.snapshot(T0_US + 94749999).finished);
+    TEST_ASSERT_TRUE(clock.snapshot(T0_US + 94750000).finished);
+}
+
+// 随机多次暂停/继续: 已计时时间等于运行区间之和，与暂停次数无关
+void test_many_pauses_sum_running_time(void) {
+    MatchClock clock(60000);
+    int64_t now = T0_US;
+    clock.start(now);
+    int64_t running = 0;
+
+    for (int i = 0; i < 200; i++) {
+        int64_t run = nextRandom() % 200000;
+        int64_t idle = nextRandom() % 3000000;
+        now += run;
+        running += run;
+        clock.pause(now);
+        now += idle;
+        TEST_ASSERT_EQUAL_INT64(running, clock.snapshot(now).elapsedUs);
+        clock.resume(now);
+        TEST_ASSERT_EQUAL_INT64(running, clock.snapshot(now).elapsedUs);
+    }
+    ClockSnapshot snap = clock.snapshot(now);
+    TEST_ASSERT_EQUAL_INT64(60000000 - running, snap.remainingUs);
+    TEST_ASSERT_EQUAL_INT32((int32_t)((60000000 - running + 999999) / 1000000), snap.ceilSeconds);
+}
+
+// 在整秒边界上暂停: 暂停期间显示的秒数与边界时刻一致
+void test_pause_exactly_on_boundary(void) {
+    MatchClock clock(60000);
+    clock.start(T0_US);
+    clock.pause(T0_US + 30000000);
+
+    ClockSnapshot snap = clock.snapshot(T0_US + 99000000);
+    TEST_ASSERT_EQUAL_INT32(30, snap.seconds);
+    TEST_ASSERT_EQUAL_INT32(0, snap.hundredths);
+    TEST_ASSERT_EQUAL_INT32(30, snap.ceilSeconds);
+
+    clock.resume(T0_US + 100000000);
+    TEST_ASSERT_EQUAL_INT32(30, clock.snapshot(T0_US + 100000000).ceilSeconds);
+    TEST_ASSERT_EQUAL_INT32(29, clock.snapshot(T0_US + 100000001).seconds);
+    TEST_ASSERT_EQUAL_INT32(30, clock.snapshot(T0_US + 100000001).ceilSeconds);
+}
+
+// 采样时刻早于起点 (事件时间戳略早于计时开始) 时按0处理; 重置后回到未开始状态
+void test_snapshot_before_start_and_reset(void) {
+    MatchClock clock(60000);
+    clock.start(T0_US);
+    ClockSnapshot early = clock.snapshot(T0_US - 5000);
+    TEST_ASSERT_EQUAL_INT64(0, early.elapsedUs);
+    TEST_ASSERT_EQUAL_INT32(60, early.ceilSeconds);
+
+    clock.pause(T0_US + 1000000);
+    clock.reset();
+    ClockSnapshot idle = clock.snapshot(T0_US + 5000000);
+    TEST_ASSERT_FALSE(idle.running);
+    TEST_ASSERT_FALSE(idle.paused);
+    TEST_ASSERT_EQUAL_INT32(60, idle.seconds);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_idle_shows_full_duration);
+    RUN_TEST(test_rounding_at_every_second_boundary);
+    RUN_TEST(test_ceil_seconds_step_once_per_second);
+    RUN_TEST(test_pause_resume_accounting);
+    RUN_TEST(test_many_pauses_sum_running_time);
+    RUN_TEST(test_pause_exactly_on_boundary);
+    RUN_TEST(test_snapshot_before_start_and_reset);
+    return UNITY_END();
+}
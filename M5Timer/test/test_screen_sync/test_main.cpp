@@ -0,0 +1,395 @@
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <deque>
+#include <string>
+#include <vector>
+#include "core/ScreenReceiver.h"
+
+// 与Screen/sketch.js一致的主机参数 (sketch.js中的常量与同步算法修改时需同步更新本测试)
+#define PRESENT_LEAD_MS        30
+#define CLOCK_SYNC_INTERVAL    10000
+#define CLOCK_SYNC_RETRY       1000
+#define CLOCK_SYNC_MAX_RTT_MS  100
+#define CLOCK_SYNC_SAMPLES     8
+
+// 仿真参数
+#define SCREEN_COUNT      4
+#define STEP_US           100       // 仿真步长
+#define FRAME_INTERVAL_MS 50        // 主机发送帧的间隔
+#define RUN_MS            30000     // 仿真时长
+#define SETTLE_MS         2000      // 首次同步完成前的帧不计入
+#define SKEW_TOLERANCE_US 3000      // 各屏幕显示同一帧的最大时间差 (两端毫秒时钟的量化与晶振误差)
+
+// 可重复的伪随机数
+static uint32_t randomSeed;
+
+static uint32_t nextRandom() {
+    randomSeed = randomSeed * 1103515245u + 12345u;
+    return randomSeed >> 8;
+}
+
+// 单向串口链路: 按发送顺序到达，每条消息有基础延迟与随机抖动
+class SerialLink {
+public:
+    void configure(int64_t baseUs, int64_t jitterUs) {
+        this->baseUs = baseUs;
+        this->jitterUs = jitterUs;
+        lastArrivalUs = 0;
+        messages.clear();
+    }
+
+    void send(int64_t nowUs, const uint8_t* data, size_t length) {
+        int64_t arrivalUs = nowUs + baseUs + (int64_t)(nextRandom() % (uint32_t)jitterUs);
+        if (arrivalUs < lastArrivalUs) arrivalUs = lastArrivalUs;
+        lastArrivalUs = arrivalUs;
+        messages.push_back(Message{arrivalUs, std::vector<uint8_t>(data, data + length)});
+    }
+
+    // 取出已到达的一条消息
+    bool receive(int64_t nowUs, std::vector<uint8_t>* data) {
+        if (messages.empty() || messages.front().arrivalUs > nowUs) return false;
+        *data = messages.front().data;
+        messages.pop_front();
+        return true;
+    }
+
+private:
+    struct Message {
+        int64_t arrivalUs;
+        std::vector<uint8_t> data;
+    };
+    std::deque<Message> messages;
+    int64_t baseUs;
+    int64_t jitterUs;
+    int64_t lastArrivalUs;
+};
+
+// 屏幕: 本机millis()有任意的启动偏移与晶振误差，协议分发使用与ScreenMode相同的ScreenReceiver
+struct Screen {
+    int64_t bootOffsetMs;
+    int32_t driftPpm;
+    ScreenReceiver receiver;
+    SerialLink toHost;
+    int index;
+    int64_t replyUs;    // 正在处理的数据的到达时刻，应答在此时发出
+
+    uint32_t millis(int64_t nowUs) const {
+        int64_t localUs = nowUs + nowUs * driftPpm / 1000000;
+        return (uint32_t)(localUs / 1000 + bootOffsetMs);
+    }
+
+    void present(int64_t nowUs);
+
+    // 应答写回主机链路
+    static void writeReply(const char* line, void* context) {
+        Screen* screen = (Screen*)context;
+        screen->toHost.send(screen->replyUs, (const uint8_t*)line, strlen(line));
+    }
+
+    void receive(int64_t nowUs, const std::vector<uint8_t>& data) {
+        replyUs = nowUs;
+        receiver.push(&data[0], data.size(), millis(nowUs));
+        if (receiver.finish() & SCREEN_RX_DISPLAY) present(nowUs);
+    }
+
+    void update(int64_t nowUs) {
+        if (receiver.presentDue(millis(nowUs))) present(nowUs);
+    }
+};
+
+// 主机: 与sketch.js的syncClock / handleSyncReply / presentFrames相同的算法
+struct HostScreenState {
+    bool synced;
+    uint32_t clockOffsetMs;     // 主机时钟 - 屏幕时钟
+    uint32_t sampleOffset[CLOCK_SYNC_SAMPLES];
+    uint32_t sampleRtt[CLOCK_SYNC_SAMPLES];
+    int sampleCount;
+    int64_t lastSyncMs;
+    SerialLink toScreen;
+    std::vector<uint8_t> lineBuffer;
+};
+
+static Screen screens[SCREEN_COUNT];
+static HostScreenState hostStates[SCREEN_COUNT];
+static int64_t hostBootOffsetMs;
+
+// false时按修改前的单向同步计算时钟差 (忽略链路延迟)，用于对比
+static bool roundTripSync;
+
+// 每一帧在各屏幕上的显示时刻 (仿真时间，未显示为-1)，帧序号每256帧复用一次
+static std::vector<std::vector<int64_t> > presentedUs;
+static int frameOfSequence[256];
+
+void Screen::present(int64_t nowUs) {
+    presentedUs[frameOfSequence[receiver.shownSequence()]][index] = nowUs;
+}
+
+static uint32_t hostTimeMs(int64_t nowUs) {
+    return (uint32_t)(nowUs / 1000 + hostBootOffsetMs);
+}
+
+static void buildPacket(std::vector<uint8_t>& out, uint8_t type, uint8_t sequence,
+                        const uint8_t* payload, uint8_t length) {
+    uint8_t checksum = type ^ sequence ^ length;
+    out.push_back(PACKET_HEADER);
+    out.push_back(type);
+    out.push_back(sequence);
+    out.push_back(length);
+    for (int i = 0; i < length; i++) {
+        out.push_back(payload[i]);
+        checksum ^= payload[i];
+    }
+    out.push_back(checksum);
+}
+
+static void putUint32(uint8_t* out, uint32_t value) {
+    out[0] = value & 0xFF;
+    out[1] = (value >> 8) & 0xFF;
+    out[2] = (value >> 16) & 0xFF;
+    out[3] = (value >> 24) & 0xFF;
+}
+
+static void handleSyncReply(HostScreenState& state, const char* text, int64_t nowUs) {
+    unsigned long sentMs, screenMs;
+    if (sscanf(text, "SYNC:%lu,%lu", &sentMs, &screenMs) != 2) return;
+    uint32_t rtt = hostTimeMs(nowUs) - (uint32_t)sentMs;
+    if (rtt > CLOCK_SYNC_MAX_RTT_MS) return;
+
+    if (state.sampleCount == CLOCK_SYNC_SAMPLES) {
+        memmove(state.sampleOffset, state.sampleOffset + 1, sizeof(state.sampleOffset[0]) * (CLOCK_SYNC_SAMPLES - 1));
+        memmove(state.sampleRtt, state.sampleRtt + 1, sizeof(state.sampleRtt[0]) * (CLOCK_SYNC_SAMPLES - 1));
+        state.sampleCount--;
+    }
+    uint32_t halfRtt = roundTripSync ? rtt / 2 : 0;
+    state.sampleOffset[state.sampleCount] = (uint32_t)sentMs + halfRtt - (uint32_t)screenMs;
+    state.sampleRtt[state.sampleCount] = rtt;
+    state.sampleCount++;
+
+    int best = 0;
+    for (int i = 1; i < state.sampleCount; i++) {
+        if (state.sampleRtt[i] < state.sampleRtt[best]) best = i;
+    }
+    state.clockOffsetMs = state.sampleOffset[best];
+    state.synced = true;
+}
+
+static void hostReceive(int i, int64_t nowUs) {
+    HostScreenState& state = hostStates[i];
+    std::vector<uint8_t> data;
+    while (screens[i].toHost.receive(nowUs, &data)) {
+        for (size_t k = 0; k < data.size(); k++) {
+            if (data[k] != '\n') {
+                state.lineBuffer.push_back(data[k]);
+                continue;
+            }
+            state.lineBuffer.push_back(0);
+            handleSyncReply(state, (const char*)&state.lineBuffer[0], nowUs);
+            state.lineBuffer.clear();
+        }
+    }
+}
+
+// 主机发送一帧: 按需同步时钟，每块屏幕发送延迟帧，然后发送显示命令
+static void hostSendFrame(uint8_t sequence, int64_t nowUs) {
+    uint8_t pixels[FRAME_PIXELS / 2];
+    memset(pixels, sequence, sizeof(pixels));
+
+    bool scheduled = true;
+    for (int i = 0; i < SCREEN_COUNT; i++) {
+        HostScreenState& state = hostStates[i];
+        std::vector<uint8_t> out;
+        int64_t interval = state.synced ? CLOCK_SYNC_INTERVAL : CLOCK_SYNC_RETRY;
+        if (nowUs / 1000 - state.lastSyncMs >= interval) {
+            state.lastSyncMs = nowUs / 1000;
+            uint8_t payload[4];
+            putUint32(payload, hostTimeMs(nowUs));
+            buildPacket(out, PACKET_SYNC, 0, payload, 4);
+        }
+        buildPacket(out, PACKET_PACKED | PACKET_DEFERRED, sequence, pixels, sizeof(pixels));
+        state.toScreen.send(nowUs, &out[0], out.size());
+        scheduled = scheduled && state.synced;
+    }
+
+    uint32_t presentAtMs = hostTimeMs(nowUs) + PRESENT_LEAD_MS;
+    for (int i = 0; i < SCREEN_COUNT; i++) {
+        uint8_t payload[5] = {sequence};
+        if (scheduled) putUint32(payload + 1, presentAtMs - hostStates[i].clockOffsetMs);
+        std::vector<uint8_t> out;
+        buildPacket(out, PACKET_PRESENT, 0, payload, scheduled ? 5 : 1);
+        hostStates[i].toScreen.send(nowUs, &out[0], out.size());
+    }
+}
+
+// 运行仿真，返回已同步后各帧在各屏幕间的最大显示时间差 (微秒)
+static int64_t runLoopback(int64_t linkBaseUs[SCREEN_COUNT], int64_t jitterUs, int* framesChecked) {
+    hostBootOffsetMs = 123456789;
+    for (int i = 0; i < SCREEN_COUNT; i++) {
+        screens[i].bootOffsetMs = nextRandom() % 4000000;
+        screens[i].driftPpm = (int32_t)(nextRandom() % 41) - 20;
+        screens[i].receiver = ScreenReceiver();
+        screens[i].receiver.setReplyHandler(Screen::writeReply, &screens[i]);
+        screens[i].toHost.configure(linkBaseUs[i], jitterUs);
+        screens[i].index = i;
+
+        hostStates[i].synced = false;
+        hostStates[i].sampleCount = 0;
+        hostStates[i].lastSyncMs = -CLOCK_SYNC_INTERVAL;
+        hostStates[i].toScreen.configure(linkBaseUs[i], jitterUs);
+        hostStates[i].lineBuffer.clear();
+    }
+
+    presentedUs.clear();
+    uint8_t sequence = 0;
+    for (int64_t nowUs = 0; nowUs < (int64_t)RUN_MS * 1000; nowUs += STEP_US) {
+        if (nowUs % (FRAME_INTERVAL_MS * 1000) == 0) {
+            sequence++;
+            frameOfSequence[sequence] = presentedUs.size();
+            presentedUs.push_back(std::vector<int64_t>(SCREEN_COUNT, -1));
+            hostSendFrame(sequence, nowUs);
+        }
+
+        std::vector<uint8_t> data;
+        for (int i = 0; i < SCREEN_COUNT; i++) {
+            while (hostStates[i].toScreen.receive(nowUs, &data)) {
+                screens[i].receive(nowUs, data);
+            }
+            screens[i].update(nowUs);
+            hostReceive(i, nowUs);
+        }
+    }
+
+    // 同步完成后的每一帧都必须在每块屏幕上显示，统计最大时间差 (最后几帧可能尚未显示)
+    int64_t maxSkewUs = 0;
+    *framesChecked = 0;
+    int firstFrame = SETTLE_MS / FRAME_INTERVAL_MS;
+    int lastFrame = (int)presentedUs.size() - 2;
+    for (int frame = firstFrame; frame < lastFrame; frame++) {
+        int64_t first = presentedUs[frame][0];
+        int64_t last = first;
+        for (int i = 0; i < SCREEN_COUNT; i++) {
+            int64_t at = presentedUs[frame][i];
+            TEST_ASSERT_TRUE_MESSAGE(at >= 0, "屏幕没有显示该帧");
+            if (at < first) first = at;
+            if (at > last) last = at;
+        }
+        if (last - first > maxSkewUs) maxSkewUs = last - first;
+        (*framesChecked)++;
+    }
+    return maxSkewUs;
+}
+
+void setUp(void) {
+    randomSeed = 2024;
+    roundTripSync = true;
+}
+
+void tearDown(void) {}
+
+// 各屏幕链路延迟不同 (不同的USB转串口与集线器)，同一帧仍在同一时刻显示
+void test_screens_present_same_frame_together(void) {
+    int64_t linkBaseUs[SCREEN_COUNT] = {1000, 4000, 9000, 15000};
+    int frames = 0;
+    int64_t skewUs = runLoopback(linkBaseUs, 2000, &frames);
+
+    char message[64];
+    snprintf(message, sizeof(message), "%d 帧, 最大显示时间差 %lld us", frames, (long long)skewUs);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_GREATER_THAN(400, frames);
+    TEST_ASSERT_LESS_OR_EQUAL(SKEW_TOLERANCE_US, skewUs);
+}
+
+// 对比: 单向同步把各屏幕的链路延迟算进时钟差，同一帧的显示时间相差约为链路延迟之差
+void test_one_way_sync_skews_by_link_delay(void) {
+    int64_t linkBaseUs[SCREEN_COUNT] = {1000, 4000, 9000, 15000};
+    int frames = 0;
+    roundTripSync = false;
+    int64_t skewUs = runLoopback(linkBaseUs, 2000, &frames);
+
+    char message[64];
+    snprintf(message, sizeof(message), "单向同步: 最大显示时间差 %lld us", (long long)skewUs);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_GREATER_THAN(10000, skewUs);
+}
+
+// 显示时刻在同步前不可用时立即显示，同步后按时刻显示
+void test_present_without_time_is_immediate(void) {
+    DeferredFrame frame;
+    uint8_t pixels[FRAME_PIXELS] = {0};
+
+    frame.store(pixels, 7);
+    TEST_ASSERT_FALSE(frame.onPresent(6, false, 0, 1000));
+    TEST_ASSERT_TRUE(frame.hasFrame());
+    TEST_ASSERT_TRUE(frame.onPresent(7, false, 0, 1000));
+    TEST_ASSERT_NOT_NULL(frame.take());
+    TEST_ASSERT_NULL(frame.take());
+
+    // 显示时刻在1秒以内时等待，已过或太远时立即显示
+    frame.store(pixels, 8);
+    TEST_ASSERT_FALSE(frame.onPresent(8, true, 1030, 1000));
+    TEST_ASSERT_EQUAL_UINT32(30, frame.deadlineMs(1000));
+    TEST_ASSERT_FALSE(frame.isDue(1029));
+    TEST_ASSERT_TRUE(frame.isDue(1030));
+
+    frame.store(pixels, 9);
+    TEST_ASSERT_FALSE(frame.isScheduled());
+    TEST_ASSERT_TRUE(frame.onPresent(9, true, 990, 1000));
+    frame.store(pixels, 10);
+    TEST_ASSERT_TRUE(frame.onPresent(10, true, 1000 + DEFERRED_MAX_LEAD_MS, 1000));
+
+    // 本机时钟回绕
+    frame.store(pixels, 11);
+    TEST_ASSERT_FALSE(frame.onPresent(11, true, 20, 0xFFFFFFF0u));
+    TEST_ASSERT_EQUAL_UINT32(36, frame.deadlineMs(0xFFFFFFF0u));
+}
+
+// 收集应答文本
+static void collectReply(const char* line, void* context) {
+    ((std::string*)context)->append(line);
+}
+
+// 立即显示的帧确认序号，TEST命令与多帧只在一批结束时汇报一次
+void test_receiver_acks_batch_and_reports_events(void) {
+    ScreenReceiver receiver;
+    std::string replies;
+    receiver.setReplyHandler(collectReply, &replies);
+
+    uint8_t pixels[FRAME_PIXELS / 2];
+    memset(pixels, 0x12, sizeof(pixels));
+    std::vector<uint8_t> data;
+    buildPacket(data, PACKET_PACKED, 5, pixels, sizeof(pixels));
+    buildPacket(data, PACKET_PACKED, 6, pixels, sizeof(pixels));
+    const char* test = "TEST\n";
+    data.insert(data.end(), test, test + strlen(test));
+
+    receiver.push(&data[0], data.size(), 1000);
+    TEST_ASSERT_EQUAL_STRING("", replies.c_str());
+    TEST_ASSERT_EQUAL_UINT8(SCREEN_RX_DISPLAY | SCREEN_RX_TEST, receiver.finish());
+    TEST_ASSERT_EQUAL_STRING("ACK:6\n", replies.c_str());
+    TEST_ASSERT_EQUAL_UINT8(6, receiver.shownSequence());
+    TEST_ASSERT_EQUAL_UINT8(1, receiver.pixels()[0]);
+    TEST_ASSERT_EQUAL_UINT8(2, receiver.pixels()[1]);
+
+    // 没有新数据时不再应答
+    TEST_ASSERT_EQUAL_UINT8(0, receiver.finish());
+    TEST_ASSERT_EQUAL_STRING("ACK:6\n", replies.c_str());
+
+    // 时钟同步立即回显收到时的本机时刻
+    replies.clear();
+    uint8_t syncPayload[4];
+    putUint32(syncPayload, 4321);
+    data.clear();
+    buildPacket(data, PACKET_SYNC, 0, syncPayload, 4);
+    receiver.push(&data[0], data.size(), 777);
+    TEST_ASSERT_EQUAL_STRING("SYNC:4321,777\n", replies.c_str());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_screens_present_same_frame_together);
+    RUN_TEST(test_one_way_sync_skews_by_link_delay);
+    RUN_TEST(test_present_without_time_is_immediate);
+    RUN_TEST(test_receiver_acks_batch_and_reports_events);
+    return UNITY_END();
+}
@@ -0,0 +1,192 @@
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include <chrono>
+#include "core/Spectrum.h"
+
+// 测试正弦波的幅度与基准测试的变换次数
+#define SINE_AMPLITUDE    20000.0
+#define BENCH_TRANSFORMS  20000
+
+// 与定点FFT比较时忽略的小功率频点 (量化误差占主导)
+#define DFT_MIN_POWER     1e4
+
+// 可重复的伪随机数
+static uint32_t randomSeed;
+
+static uint32_t nextRandom() {
+    randomSeed = randomSeed * 1103515245u + 12345u;
+    return randomSeed >> 8;
+}
+
+// 每帧cycles个周期的正弦波 (cycles为整数时正好落在频点上)
+static void sine(int16_t* samples, double cycles, double amplitude) {
+    for (int n = 0; n < FFT_SIZE; n++) {
+        samples[n] = (int16_t)lround(amplitude * sin(2.0 * M_PI * cycles * n / FFT_SIZE));
+    }
+}
+
+static int loudestBin(const uint32_t* bins) {
+    int best = 0;
+    for (int k = 1; k < FFT_HALF; k++) {
+        if (bins[k] > bins[best]) best = k;
+    }
+    return best;
+}
+
+// bandLevels()最大的频段，并列时返回-1
+static int loudestBand(const SpectrumAnalyzer& analyzer) {
+    const int32_t* levels = analyzer.bandLevels();
+    int best = 0;
+    bool tie = false;
+    for (int band = 1; band < SPECTRUM_BANDS; band++) {
+        if (levels[band] > levels[best]) {
+            best = band;
+            tie = false;
+        } else if (levels[band] == levels[best]) {
+            tie = true;
+        }
+    }
+    return tie ? -1 : best;
+}
+
+static int bandOfBin(const SpectrumAnalyzer& analyzer, int bin) {
+    const uint8_t* edges = analyzer.bandEdges();
+    for (int band = 0; band < SPECTRUM_BANDS; band++) {
+        if (bin >= edges[band] && bin < edges[band + 1]) return band;
+    }
+    return -1;
+}
+
+void setUp(void) {
+    randomSeed = 12345;
+}
+
+void tearDown(void) {}
+
+// 频段边界: 从频点1开始严格递增，覆盖到FFT_HALF
+void test_band_edges_cover_spectrum(void) {
+    SpectrumAnalyzer analyzer;
+    const uint8_t* edges = analyzer.bandEdges();
+    TEST_ASSERT_EQUAL_UINT8(1, edges[0]);
+    TEST_ASSERT_EQUAL_UINT8(FFT_HALF, edges[SPECTRUM_BANDS]);
+    for (int band = 0; band < SPECTRUM_BANDS; band++) {
+        TEST_ASSERT_TRUE(edges[band] < edges[band + 1]);
+    }
+}
+
+// 正弦扫频: 频点1-127的正弦波，功率最大的频点就是输入频点
+void test_sine_sweep_peak_bin(void) {
+    FixedFFT fft;
+    int16_t samples[FFT_SIZE];
+    uint32_t bins[FFT_HALF];
+    for (int bin = 1; bin < FFT_HALF; bin++) {
+        sine(samples, bin, SINE_AMPLITUDE);
+        fft.power(samples, bins);
+        TEST_ASSERT_EQUAL_INT(bin, loudestBin(bins));
+    }
+}
+
+// 正弦扫频: 最响的频段是边界包含该频点的频段，显示行高也是该频段最高
+// 落在两个频点之间的频率归入相邻两个频点之一所在的频段
+void test_sine_sweep_band_placement(void) {
+    SpectrumAnalyzer analyzer;
+    int16_t samples[FFT_SIZE];
+    for (int halfBin = 2; halfBin < FFT_HALF * 2 - 1; halfBin++) {
+        sine(samples, halfBin / 2.0, SINE_AMPLITUDE / 4);
+        analyzer.reset();
+        analyzer.process(samples, 0);
+        analyzer.advance();
+
+        int band = loudestBand(analyzer);
+        if (halfBin % 2 == 0) {
+            TEST_ASSERT_EQUAL_INT(bandOfBin(analyzer, halfBin / 2), band);
+        } else {
+            int lower = bandOfBin(analyzer, halfBin / 2);
+            int upper = bandOfBin(analyzer, halfBin / 2 + 1);
+            TEST_ASSERT_TRUE(band == lower || band == upper);
+        }
+        for (int other = 0; other < SPECTRUM_BANDS; other++) {
+            TEST_ASSERT_TRUE(analyzer.level(other) <= analyzer.level(band));
+        }
+    }
+}
+
+// 随机信号: 定点FFT的功率与双精度DFT (同一Hann窗，同样除以FFT_SIZE) 的相对误差
+void test_matches_double_dft(void) {
+    FixedFFT fft;
+    int16_t samples[FFT_SIZE];
+    uint32_t bins[FFT_HALF];
+    double worst = 0;
+    for (int round = 0; round < 4; round++) {
+        for (int n = 0; n < FFT_SIZE; n++) {
+            samples[n] = (int16_t)(nextRandom() % 20000) - 10000;
+        }
+        fft.power(samples, bins);
+
+        for (int k = 1; k < FFT_HALF; k++) {
+            double re = 0;
+            double im = 0;
+            for (int n = 0; n < FFT_SIZE; n++) {
+                double w = 0.5 - 0.5 * cos(2.0 * M_PI * n / (FFT_SIZE - 1));
+                double angle = 2.0 * M_PI * k * n / FFT_SIZE;
+                re += samples[n] * w * cos(angle);
+                im -= samples[n] * w * sin(angle);
+            }
+            double reference = (re * re + im * im) / ((double)FFT_SIZE * FFT_SIZE);
+            if (reference < DFT_MIN_POWER) continue;
+            double error = fabs(bins[k] - reference) / reference;
+            if (error > worst) worst = error;
+        }
+    }
+
+    char message[128];
+    snprintf(message, sizeof(message), "与双精度DFT的最大相对误差 %.3f", worst);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(worst < 0.1);
+}
+
+// 每次变换的耗时: 只做FFT，以及FFT + 分段 (SpectrumAnalyzer::process)
+void test_benchmark_us_per_transform(void) {
+    FixedFFT fft;
+    SpectrumAnalyzer analyzer;
+    int16_t samples[FFT_SIZE];
+    uint32_t bins[FFT_HALF];
+    sine(samples, 10, SINE_AMPLITUDE);
+
+    // 每次改变一个采样，避免编译器把重复的变换优化掉
+    uint32_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_TRANSFORMS; i++) {
+        samples[i & (FFT_SIZE - 1)] ^= 1;
+        fft.power(samples, bins);
+        checksum += bins[10];
+    }
+    double fftUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count()
+                   / BENCH_TRANSFORMS;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_TRANSFORMS; i++) {
+        samples[i & (FFT_SIZE - 1)] ^= 1;
+        analyzer.process(samples, 0);
+        checksum += analyzer.bandLevels()[3];
+    }
+    double processUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count()
+                       / BENCH_TRANSFORMS;
+
+    char message[160];
+    snprintf(message, sizeof(message), "%d 点FFT: %.2f 微秒/次; FFT + 分段: %.2f 微秒/次 (校验 %u)",
+             FFT_SIZE, fftUs, processUs, (unsigned)checksum);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(checksum != 0);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_band_edges_cover_spectrum);
+    RUN_TEST(test_sine_sweep_peak_bin);
+    RUN_TEST(test_sine_sweep_band_placement);
+    RUN_TEST(test_matches_double_dft);
+    RUN_TEST(test_benchmark_us_per_transform);
+    return UNITY_END();
+}
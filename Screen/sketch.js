@@ -97,6 +97,41 @@ let writers = new Array(12).fill(null);  // 存储所有写入器
 let readers = new Array(12).fill(null);  // 存储所有读取器
 let connectedScreens = new Array(12).fill(false);  // 存储屏幕连接状态
 
+// 压缩帧协议: 帧头0xAB + 类型 + 序号 + 负载长度 + 负载 + 校验和(类型到负载的异或)
+const PACKET_HEADER = 0xAB;
+const PACKET_PACKED = 0x01;  // 完整帧，每字节两个像素
+const PACKET_RLE = 0x02;     // 游程编码完整帧
+const PACKET_DELTA = 0x03;   // 只包含变化像素的差分帧
+const PACKET_PRESENT = 0x04; // 显示已缓存的帧 (可带显示时刻)
+const PACKET_SYNC = 0x05;    // 时钟同步
+const PACKET_DEFERRED = 0x80;  // 帧类型标志: 只缓存，等待显示命令
+// 以下同步参数与syncClock / handleSyncReply / presentFrames的算法在
+// M5Timer/test/test_screen_sync/test_main.cpp中有一份C++副本 (主机仿真)，修改时需同步更新
+const PRESENT_LEAD_MS = 30;    // 定时显示时预留的传输时间
+const CLOCK_SYNC_INTERVAL = 10000;  // 时钟同步间隔（毫秒）
+const CLOCK_SYNC_RETRY = 1000;      // 尚未得到有效同步结果时的重试间隔（毫秒）
+const CLOCK_SYNC_MAX_RTT_MS = 100;  // 往返时间超过此值的同步结果不可信，丢弃
+const CLOCK_SYNC_SAMPLES = 8;       // 保留最近几次同步结果，取往返时间最短的一次
+const KEYFRAME_INTERVAL = 60;  // 每隔多少帧强制发送一次完整帧
+const ACK_WINDOW = 16;         // 超过多少帧未确认时改发完整帧
+
+// 每个屏幕的压缩帧状态
+let frameStates = new Array(12).fill(null).map(() => createFrameState());
+
+function createFrameState() {
+    return {
+        sequence: 0,          // 最近发送的帧序号
+        ackedSequence: -1,    // 屏幕最近确认的帧序号
+        lastPixels: null,     // 最近发送的画面 (差分基准)
+        needKeyframe: true,   // 是否需要发送完整帧
+        framesSinceKey: 0,    // 距上一个完整帧的帧数
+        clockOffsetMs: null,  // 主机时钟 - 屏幕时钟 (毫秒)，尚未同步时为null
+        syncSamples: [],      // 最近的同步结果 {offset, rtt}
+        lastSyncTime: -Infinity,  // 上次发送时钟同步的时间
+        lineBuffer: ''        // 未处理完的串口接收行
+    };
+}
+
 // 连接串口
 async function connectSerial(screenIndex) {
     try {
@@ -115,6 +150,7 @@ async function connectSerial(screenIndex) {
         writers[screenIndex] = writer;
         readers[screenIndex] = reader;
         connectedScreens[screenIndex] = true;
+        frameStates[screenIndex] = createFrameState();
         
         // 更新界面状态
         updateScreenStatus(screenIndex, true);
@@ -333,21 +369,210 @@ async function readLoop(screenIndex) {
                 readers[screenIndex].releaseLock();
                 break;
             }
-            // 将接收到的数据转换为字符串并添加前缀
-            const receivedData = new TextDecoder().decode(value);
-            const prefixedData = `SCREEN:${receivedData}`;
-            console.log(`屏幕${screenIndex + 1}收到数据:`, prefixedData);
+            // 按行处理屏幕返回的确认与关键帧请求
+            const state = frameStates[screenIndex];
+            state.lineBuffer += new TextDecoder().decode(value);
+            const lines = state.lineBuffer.split('\n');
+            state.lineBuffer = lines.pop();
+            for (const line of lines) {
+                handleScreenLine(line.trim(), screenIndex);
+            }
         }
     } catch (err) {
         console.error(`屏幕${screenIndex + 1}读取数据错误:`, err);
     }
 }
 
+// 处理屏幕返回的一行数据
+function handleScreenLine(line, screenIndex) {
+    const state = frameStates[screenIndex];
+    if (line.startsWith('ACK:')) {
+        state.ackedSequence = parseInt(line.substring(4), 10);
+    } else if (line.startsWith('SYNC:')) {
+        handleSyncReply(line.substring(5), state);
+    } else if (line === 'KEY') {
+        // 屏幕丢失了差分帧的基准，下一帧发送完整帧
+        state.needKeyframe = true;
+        console.log(`屏幕${screenIndex + 1}请求关键帧`);
+    } else if (line.length > 0) {
+        console.log(`屏幕${screenIndex + 1}收到数据:`, line);
+    }
+}
+
+// 处理时钟同步回复 "主机发送时刻,屏幕收到时刻" (与test_screen_sync中的handleSyncReply保持一致)
+// 按NTP的方式假设往返两个方向延迟相同: 屏幕收到时刻对应主机的 发送时刻 + 往返时间/2
+function handleSyncReply(text, state) {
+    const parts = text.split(',');
+    if (parts.length !== 2) return;
+    const sentMs = parseInt(parts[0], 10) >>> 0;
+    const screenMs = parseInt(parts[1], 10) >>> 0;
+    const rtt = (hostTimeMs() - sentMs) >>> 0;
+    if (rtt > CLOCK_SYNC_MAX_RTT_MS) return;
+    
+    const offset = (sentMs + Math.floor(rtt / 2) - screenMs) >>> 0;
+    state.syncSamples.push({ offset, rtt });
+    if (state.syncSamples.length > CLOCK_SYNC_SAMPLES) state.syncSamples.shift();
+    
+    // 往返时间最短的结果受排队延迟影响最小
+    const best = state.syncSamples.reduce((a, b) => (b.rtt < a.rtt ? b : a));
+    state.clockOffsetMs = best.offset;
+}
+
+// 打包压缩帧
+function buildPacket(type, sequence, payload) {
+    const packet = new Uint8Array(payload.length + 5);
+    packet[0] = PACKET_HEADER;
+    packet[1] = type;
+    packet[2] = sequence;
+    packet[3] = payload.length;
+    packet.set(payload, 4);
+    let checksum = 0;
+    for (let i = 1; i < payload.length + 4; i++) {
+        checksum ^= packet[i];
+    }
+    packet[payload.length + 4] = checksum;
+    return packet;
+}
+
+// 完整帧: 每字节两个像素，高4位在前
+function encodePacked(pixels) {
+    const payload = [];
+    for (let i = 0; i < pixels.length; i += 2) {
+        payload.push((pixels[i] << 4) | pixels[i + 1]);
+    }
+    return payload;
+}
+
+// 游程编码: 每字节 (游程长度-1)<<4 | 颜色，游程最长16
+function encodeRle(pixels) {
+    const payload = [];
+    let i = 0;
+    while (i < pixels.length) {
+        let run = 1;
+        while (i + run < pixels.length && run < 16 && pixels[i + run] === pixels[i]) run++;
+        payload.push(((run - 1) << 4) | pixels[i]);
+        i += run;
+    }
+    return payload;
+}
+
+// 差分帧: 基准序号 + 数量 + 像素序号 + 颜色 (每字节两个，高4位在前)
+function encodeDelta(pixels, basePixels, baseSequence) {
+    const indices = [];
+    for (let i = 0; i < pixels.length; i++) {
+        if (pixels[i] !== basePixels[i]) indices.push(i);
+    }
+    const payload = [baseSequence, indices.length, ...indices];
+    for (let i = 0; i < indices.length; i += 2) {
+        const high = pixels[indices[i]];
+        const low = i + 1 < indices.length ? pixels[indices[i + 1]] : 0;
+        payload.push((high << 4) | low);
+    }
+    return { payload, changed: indices.length };
+}
+
+// 主机时钟 (毫秒，32位回绕)
+function hostTimeMs() {
+    return Math.floor(performance.now()) >>> 0;
+}
+
+// 32位小端整数
+function uint32Bytes(value) {
+    return [value & 0xFF, (value >>> 8) & 0xFF, (value >>> 16) & 0xFF, (value >>> 24) & 0xFF];
+}
+
+// 定期与屏幕同步时钟
+async function syncClock(screenIndex) {
+    const state = frameStates[screenIndex];
+    const now = performance.now();
+    const interval = state.clockOffsetMs === null ? CLOCK_SYNC_RETRY : CLOCK_SYNC_INTERVAL;
+    if (now - state.lastSyncTime < interval) return;
+    state.lastSyncTime = now;
+    
+    try {
+        await writers[screenIndex].write(buildPacket(PACKET_SYNC, 0, uint32Bytes(hostTimeMs())));
+    } catch (err) {
+        console.error(`屏幕${screenIndex + 1}时钟同步错误:`, err);
+    }
+}
+
+// 显示所有屏幕上已缓存的帧
+// 所有屏幕都完成时钟同步时按同一主机时刻定时显示 (换算为各屏幕的本机时钟)，
+// 否则在所有帧发送完后广播显示命令
+async function presentFrames(screenIndices) {
+    const scheduled = screenIndices.every(i => frameStates[i].clockOffsetMs !== null);
+    const presentAtMs = hostTimeMs() + PRESENT_LEAD_MS;
+    
+    await Promise.all(screenIndices.map(async i => {
+        if (!writers[i]) return;
+        try {
+            const state = frameStates[i];
+            const payloadTime = scheduled ? uint32Bytes((presentAtMs - state.clockOffsetMs) >>> 0) : [];
+            const payload = [state.sequence, ...payloadTime];
+            await writers[i].write(buildPacket(PACKET_PRESENT, 0, payload));
+        } catch (err) {
+            console.error(`屏幕${i + 1}显示命令错误:`, err);
+        }
+    }));
+}
+
+// 以最短的压缩帧发送一帧画面，deferred为true时屏幕只缓存，等待显示命令
+// 返回是否发送了新的帧
+async function sendFrame(pixels, screenIndex, deferred = false) {
+    if (!writers[screenIndex]) return false;
+    
+    const state = frameStates[screenIndex];
+    const unacked = (state.sequence - state.ackedSequence + 256) % 256;
+    const keyframe = state.needKeyframe || state.lastPixels === null ||
+                     state.framesSinceKey >= KEYFRAME_INTERVAL ||
+                     state.ackedSequence < 0 || unacked > ACK_WINDOW;
+    
+    let type = PACKET_PACKED;
+    let payload = encodePacked(pixels);
+    const rle = encodeRle(pixels);
+    if (rle.length < payload.length) {
+        type = PACKET_RLE;
+        payload = rle;
+    }
+    
+    if (!keyframe) {
+        const delta = encodeDelta(pixels, state.lastPixels, state.sequence);
+        // 画面没有变化时不发送
+        if (delta.changed === 0) return false;
+        if (delta.payload.length < payload.length) {
+            type = PACKET_DELTA;
+            payload = delta.payload;
+        }
+    }
+    
+    state.sequence = (state.sequence + 1) % 256;
+    state.lastPixels = pixels.slice();
+    if (type === PACKET_DELTA) {
+        state.framesSinceKey++;
+    } else {
+        state.needKeyframe = false;
+        state.framesSinceKey = 0;
+    }
+    
+    if (deferred) type |= PACKET_DEFERRED;
+    
+    try {
+        await writers[screenIndex].write(buildPacket(type, state.sequence, payload));
+        return true;
+    } catch (err) {
+        console.error(`屏幕${screenIndex + 1}发送数据错误:`, err);
+        return false;
+    }
+}
+
 // 发送数据到串口
 async function sendData(data, screenIndex) {
     if (!writers[screenIndex]) return;
     
     try {
+        // 文本帧没有序号，之后的压缩帧需要从完整帧重新开始
+        frameStates[screenIndex].needKeyframe = true;
+        
         // 添加屏幕前缀
         const prefixedData = `SCREEN:${data}`;
         
@@ -1521,8 +1746,9 @@ function colorToNumber(r, g, b) {
 }
 
 // 修改sendLEDData函数
-function sendLEDData() {
-    // 为每个已连接的屏幕发送对应的LED数据
+async function sendLEDData() {
+    // 为每个已连接的屏幕发送对应的LED数据 (只缓存)，全部发送后统一显示，避免各屏幕切换时间不一致
+    const sends = [];
     for (let i = 0; i < 12; i++) {
         if (!connectedScreens[i] || !writers[i]) continue;
         
@@ -1541,8 +1767,12 @@ function sendLEDData() {
                 data.push(colorNum);
             }
         }
-        let dataString = data.join(',') + '\n';
-        sendData(dataString, i);
+        sends.push(syncClock(i).then(() => sendFrame(data, i, true)).then(sent => sent ? i : -1));
+    }
+    
+    const presented = (await Promise.all(sends)).filter(i => i >= 0);
+    if (presented.length > 0) {
+        await presentFrames(presented);
     }
 }
 